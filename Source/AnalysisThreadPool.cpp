@@ -0,0 +1,215 @@
+/*
+    AnalysisThreadPool.cpp
+
+    Implementation of the shared analysis workers.
+
+    Author: Divij Singh
+*/
+
+#include "AnalysisThreadPool.h"
+
+namespace
+{
+    /** How often the message thread checks for requests to hand to idle workers. */
+    constexpr int dispatchIntervalMs = 10;
+}
+
+//==============================================================================
+/** One pool thread; serves its own slots first, then steals. */
+class AnalysisThreadPool::Worker : public juce::Thread
+{
+public:
+    Worker (AnalysisThreadPool& owner, int workerIndex)
+        : juce::Thread ("GainMeter Analysis " + juce::String (workerIndex + 1)),
+          pool (owner), index (workerIndex)
+    {
+    }
+
+    void run() override
+    {
+        const auto numWorkers = pool.workers.size();
+        int stealStart = 0;
+
+        while (! threadShouldExit())
+        {
+            // Requests counted after this point are not guaranteed to be seen by the pass
+            const auto requestsBeforePass = pool.numRequests.load();
+            const auto limit = pool.slotLimit.load();
+            auto didWork = false;
+
+            // Own slots: one slice for each pending client
+            for (int slot = index; slot < limit; slot += numWorkers)
+                didWork = pool.runSlot (slot) || didWork;
+
+            // Steal from the other workers, starting somewhere new each time
+            if (! didWork && numWorkers > 1)
+            {
+                for (int step = 0; step < limit; ++step)
+                {
+                    const auto slot = (stealStart + step) % limit;
+                    if (slot % numWorkers != index)
+                        didWork = pool.runSlot (slot) || didWork;
+                }
+
+                stealStart = limit > 0 ? (stealStart + 1) % limit : 0;
+            }
+
+            if (didWork)
+                continue;
+
+            // Announce the sleep before the last check: a request racing with
+            // it is either seen here or the dispatch timer sees this worker
+            // asleep afterwards and wakes it
+            sleeping.store (true);
+
+            if (pool.numRequests.load() == requestsBeforePass)
+                wait (-1);
+
+            sleeping.store (false);
+        }
+    }
+
+    /** True while blocked (or about to block) waiting for a request. */
+    bool isSleeping() const noexcept { return sleeping.load(); }
+
+private:
+    AnalysisThreadPool& pool;
+    const int index;
+    std::atomic<bool> sleeping { false };
+};
+
+//==============================================================================
+// Lifecycle
+
+AnalysisThreadPool::AnalysisThreadPool()
+{
+    // Leave a core for the host's audio threads
+    const auto numWorkers = juce::jmax (1, juce::SystemStats::getNumCpus() - 1);
+
+    for (int index = 0; index < numWorkers; ++index)
+        workers.add (new Worker (*this, index));
+
+    for (auto* worker : workers)
+        worker->startThread();
+}
+
+AnalysisThreadPool::~AnalysisThreadPool()
+{
+    // Clients remove themselves before the last reference goes
+    jassert (numClients.load() == 0);
+
+    for (auto* worker : workers)
+        worker->signalThreadShouldExit();
+
+    for (auto* worker : workers)
+    {
+        worker->notify();
+        worker->stopThread (1000);
+    }
+}
+
+//==============================================================================
+// Clients
+
+bool AnalysisThreadPool::addClient (Client& client)
+{
+    for (int index = 0; index < maxClients; ++index)
+    {
+        Client* expected = nullptr;
+        if (! slots[(size_t) index].client.compare_exchange_strong (expected, &client))
+            continue;
+
+        auto limit = slotLimit.load();
+        while (limit < index + 1 && ! slotLimit.compare_exchange_weak (limit, index + 1)) {}
+
+        client.pool.store (this);
+
+        if (numClients++ == 0)
+            startTimer (dispatchIntervalMs);
+
+        // Work requested before registration would otherwise wait for the next request
+        for (auto* worker : workers)
+            worker->notify();
+
+        return true;
+    }
+
+    jassertfalse; // More live consumers than slots
+    return false;
+}
+
+void AnalysisThreadPool::removeClient (Client& client)
+{
+    for (auto& slot : slots)
+    {
+        Client* expected = &client;
+        if (! slot.client.compare_exchange_strong (expected, nullptr))
+            continue;
+
+        client.pool.store (nullptr);
+
+        // A worker that claimed the slot before the swap may still be inside a slice
+        while (slot.busy.load())
+            juce::Thread::yield();
+
+        if (--numClients == 0)
+            stopTimer();
+        return;
+    }
+}
+
+//==============================================================================
+// Worker Side
+
+bool AnalysisThreadPool::runSlot (int slotIndex)
+{
+    auto& slot = slots[(size_t) slotIndex];
+
+    if (slot.client.load() == nullptr)
+        return false;
+
+    // Only one worker at a time may run a client
+    bool expected = false;
+    if (! slot.busy.compare_exchange_strong (expected, true))
+        return false;
+
+    // Re-read after claiming: removeClient() either sees busy or has already cleared the slot
+    auto* client = slot.client.load();
+    auto didWork = false;
+
+    if (client != nullptr && client->pending.exchange (false, std::memory_order_acquire))
+    {
+        if (client->runAnalysisSlice())
+            client->requestAnalysis();
+
+        didWork = true;
+    }
+
+    slot.busy.store (false);
+    return didWork;
+}
+
+//==============================================================================
+// Dispatch (message thread)
+
+void AnalysisThreadPool::timerCallback()
+{
+    const auto requests = numRequests.load();
+
+    if (requests == dispatchedRequests)
+        return;
+
+    dispatchedRequests = requests;
+
+    // One idle worker is enough: it steals from every slot, and clients that
+    // still have work request again, which wakes another one next tick.
+    // Workers that are awake compare the counter before they sleep.
+    for (auto* worker : workers)
+    {
+        if (worker->isSleeping())
+        {
+            worker->notify();
+            return;
+        }
+    }
+}
@@ -0,0 +1,121 @@
+/*
+    AnalysisThreadPool.h
+
+    Process-wide worker threads for background analysis.
+
+    Every instance's analysers share one pool, sized to the machine rather
+    than to the session, so a session with hundreds of instances still has
+    a handful of analysis threads. Analysers register only while something
+    consumes their output (an open editor view), so the work - and the
+    workers' scanning - grows with active consumers, not with instances.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_events/juce_events.h>
+#include <array>
+#include <atomic>
+
+//==============================================================================
+/**
+ * Fixed slot table of analysis clients served by a small set of workers.
+ *
+ * Each slot belongs to one worker (slot index modulo worker count). A
+ * worker gives every pending client in its own slots one bounded slice of
+ * work per pass, then steals pending clients from the other workers' slots
+ * before it sleeps. One slice per client per pass keeps instances fair:
+ * a busy analyser cannot starve the others. Idle workers block without a
+ * timeout. Requests never signal a thread themselves: they only bump a
+ * counter, and a message-thread timer wakes an idle worker when it moves.
+ *
+ * Held through juce::SharedResourcePointer.
+ *
+ * Thread roles:
+ * - addClient(), removeClient(): message thread
+ * - Client::requestAnalysis(): any thread including the audio thread, wait-free
+ *   (two atomic operations, never a lock or a thread signal)
+ * - Waking idle workers: message thread only (the dispatch timer, addClient())
+ * - Client::runAnalysisSlice(): one worker at a time
+ */
+class AnalysisThreadPool : private juce::Timer
+{
+public:
+    /** Most clients that can be registered at once. */
+    static constexpr int maxClients = 512;
+
+    //==============================================================================
+    /** Something with background analysis to do, e.g. a SpectrumAnalyser. */
+    class Client
+    {
+    public:
+        virtual ~Client() = default;
+
+        /**
+         * Does one bounded piece of work (worker thread, never concurrently).
+         * @return true if more work is already waiting
+         */
+        virtual bool runAnalysisSlice() = 0;
+
+        /**
+         * Flags the client as having work (any thread; safe on the audio
+         * thread). The first request since the client's last slice also
+         * counts it for the pool's dispatch timer, which wakes a worker.
+         */
+        void requestAnalysis() noexcept
+        {
+            if (! pending.exchange (true))
+                if (auto* owner = pool.load())
+                    ++owner->numRequests;
+        }
+
+    private:
+        friend class AnalysisThreadPool;
+        std::atomic<bool> pending { false };
+        std::atomic<AnalysisThreadPool*> pool { nullptr };  // Set while registered
+    };
+
+    //==============================================================================
+    AnalysisThreadPool();
+    ~AnalysisThreadPool() override;
+
+    /**
+     * Starts serving a client.
+     * @return false if every slot is in use
+     */
+    bool addClient (Client& client);
+
+    /** Stops serving a client; returns once none of its slices is running. */
+    void removeClient (Client& client);
+
+    /** Number of worker threads. */
+    int getNumWorkers() const noexcept { return workers.size(); }
+
+private:
+    class Worker;
+
+    /** One registered client, alone on its cache line. */
+    struct alignas (64) Slot
+    {
+        std::atomic<Client*> client { nullptr };
+        std::atomic<bool> busy { false };
+    };
+
+    /** Runs one slice of the client in a slot if it has work. @return true if it did */
+    bool runSlot (int slotIndex);
+
+    /** Wakes idle workers when new requests arrived since the last tick (message thread). */
+    void timerCallback() override;
+
+    std::array<Slot, maxClients> slots;
+    std::atomic<int> numClients { 0 };
+    std::atomic<int> slotLimit { 0 };   // One past the highest slot ever used; bounds the scans
+    std::atomic<juce::uint32> numRequests { 0 };    // Bumped by every new request
+    juce::uint32 dispatchedRequests = 0;            // Count the timer last acted on (message thread)
+
+    juce::OwnedArray<Worker> workers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnalysisThreadPool)
+};
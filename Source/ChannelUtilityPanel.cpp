@@ -0,0 +1,103 @@
+/*
+    ChannelUtilityPanel.cpp
+
+    Implementation of the channel utility controls.
+
+    Author: Divij Singh
+*/
+
+#include "ChannelUtilityPanel.h"
+#include "PluginProcessor.h"
+
+//==============================================================================
+// Lifecycle
+
+ChannelUtilityPanel::ChannelUtilityPanel (GainMeterAudioProcessor& p)
+    : processor (p)
+{
+    auto setUpSlider = [this] (juce::Slider& slider, juce::Label& label, const juce::String& name,
+                               juce::AudioParameterFloat& parameter, const juce::String& suffix)
+    {
+        const auto& range = parameter.range;
+        slider.setRange (range.start, range.end, range.interval);
+        slider.setValue (parameter.get(), juce::dontSendNotification);
+        slider.setDoubleClickReturnValue (true, 0.0);
+        slider.setTextValueSuffix (suffix);
+        slider.onValueChange = [&slider, &parameter] { parameter = (float) slider.getValue(); };
+        addAndMakeVisible (slider);
+
+        label.setText (name, juce::dontSendNotification);
+        label.setJustificationType (juce::Justification::centred);
+        addAndMakeVisible (label);
+    };
+
+    trimLeftSlider.setSliderStyle (juce::Slider::RotaryHorizontalVerticalDrag);
+    trimLeftSlider.setTextBoxStyle (juce::Slider::TextBoxBelow, false, 70, 18);
+    trimRightSlider.setSliderStyle (juce::Slider::RotaryHorizontalVerticalDrag);
+    trimRightSlider.setTextBoxStyle (juce::Slider::TextBoxBelow, false, 70, 18);
+    balanceSlider.setSliderStyle (juce::Slider::LinearHorizontal);
+    balanceSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 60, 18);
+
+    setUpSlider (trimLeftSlider, trimLeftLabel, "Trim L", *processor.trimLeftParameter, " dB");
+    setUpSlider (trimRightSlider, trimRightLabel, "Trim R", *processor.trimRightParameter, " dB");
+    setUpSlider (balanceSlider, balanceLabel, "Balance", *processor.balanceParameter, " %");
+
+    auto setUpToggle = [this] (juce::ToggleButton& button, juce::AudioParameterBool& parameter)
+    {
+        button.setToggleState (parameter.get(), juce::dontSendNotification);
+        button.onClick = [&button, &parameter] { parameter = button.getToggleState(); };
+        addAndMakeVisible (button);
+    };
+
+    setUpToggle (invertLeftButton, *processor.invertLeftParameter);
+    setUpToggle (invertRightButton, *processor.invertRightParameter);
+    setUpToggle (swapButton, *processor.swapChannelsParameter);
+
+    panLawBox.addItemList (processor.panLawParameter->choices, 1);
+    panLawBox.setSelectedItemIndex (processor.panLawParameter->getIndex(), juce::dontSendNotification);
+    panLawBox.onChange = [this] { *processor.panLawParameter = panLawBox.getSelectedItemIndex(); };
+    addAndMakeVisible (panLawBox);
+}
+
+//==============================================================================
+// Layout and Painting
+
+void ChannelUtilityPanel::resized()
+{
+    auto area = getLocalBounds().reduced (8);
+
+    // Left and right channel columns: trim knob with its polarity switch below
+    auto channels = area.removeFromTop (juce::jmin (area.getHeight() - 60, 180));
+    auto leftColumn = channels.removeFromLeft (channels.getWidth() / 3);
+    auto rightColumn = channels.removeFromLeft (channels.getWidth() / 2);
+    auto swapColumn = channels;
+
+    auto layOutChannel = [] (juce::Rectangle<int> column, juce::Label& label, juce::Slider& trim, juce::Button& invert)
+    {
+        label.setBounds (column.removeFromTop (18));
+        invert.setBounds (column.removeFromBottom (24).withSizeKeepingCentre (90, 24));
+        trim.setBounds (column.reduced (4));
+    };
+
+    layOutChannel (leftColumn, trimLeftLabel, trimLeftSlider, invertLeftButton);
+    layOutChannel (rightColumn, trimRightLabel, trimRightSlider, invertRightButton);
+    swapButton.setBounds (swapColumn.withSizeKeepingCentre (100, 24));
+
+    // Balance and pan law along the bottom
+    area.removeFromTop (12);
+    auto balanceRow = area.removeFromTop (24);
+    balanceLabel.setBounds (balanceRow.removeFromLeft (60));
+    panLawBox.setBounds (balanceRow.removeFromRight (80));
+    balanceSlider.setBounds (balanceRow.reduced (4, 0));
+}
+
+void ChannelUtilityPanel::paint (juce::Graphics& g)
+{
+    g.fillAll (juce::Colours::black);
+
+    // Signal order, since it decides what the swap and balance act on
+    g.setColour (juce::Colours::grey);
+    g.setFont (11.0f);
+    g.drawText ("Trim/polarity -> swap -> balance -> gain", getLocalBounds().reduced (8).removeFromBottom (16),
+                juce::Justification::centredRight, false);
+}
@@ -0,0 +1,42 @@
+/*
+    ChannelUtilityPanel.h
+
+    Controls for the input channel matrix: trim, polarity, swap and balance.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+class GainMeterAudioProcessor;
+
+//==============================================================================
+/**
+ * Per-channel trim and polarity, L/R swap, balance and pan law.
+ *
+ * All settings are processor parameters; the audio thread folds them into
+ * one smoothed 2x2 matrix applied ahead of the gain stage.
+ */
+class ChannelUtilityPanel : public juce::Component
+{
+public:
+    /** @param processor Owning processor (channel matrix parameters) */
+    explicit ChannelUtilityPanel (GainMeterAudioProcessor& processor);
+
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    GainMeterAudioProcessor& processor;
+
+    juce::Slider trimLeftSlider, trimRightSlider, balanceSlider;
+    juce::Label trimLeftLabel, trimRightLabel, balanceLabel;
+    juce::ToggleButton invertLeftButton { "Invert L" };
+    juce::ToggleButton invertRightButton { "Invert R" };
+    juce::ToggleButton swapButton { "Swap L/R" };
+    juce::ComboBox panLawBox;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChannelUtilityPanel)
+};
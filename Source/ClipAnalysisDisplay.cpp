@@ -0,0 +1,127 @@
+/*
+    ClipAnalysisDisplay.cpp
+
+    Implementation of the ARA clip analysis list.
+
+    Author: Divij Singh
+*/
+
+#include "ClipAnalysisDisplay.h"
+
+#if JucePlugin_Enable_ARA
+
+namespace
+{
+    constexpr int rowHeight = 36;
+    constexpr int textWidth = 220;
+}
+
+//==============================================================================
+// Lifecycle
+
+ClipAnalysisDisplay::ClipAnalysisDisplay (GainMeterDocumentController& controller)
+    : documentController (controller)
+{
+    startTimerHz (5);
+}
+
+ClipAnalysisDisplay::~ClipAnalysisDisplay()
+{
+    stopTimer();
+}
+
+void ClipAnalysisDisplay::timerCallback()
+{
+    summaries = documentController.getSourceSummaries();
+    repaint();
+}
+
+//==============================================================================
+// Rendering
+
+void ClipAnalysisDisplay::drawOverview (juce::Graphics& g, const SourceAnalysis& analysis, juce::Rectangle<int> area)
+{
+    const auto numEntries = (int) analysis.overview.size();
+    if (numEntries == 0 || area.getWidth() <= 0)
+        return;
+
+    const auto centreY = (float) area.getCentreY();
+    const auto halfHeight = area.getHeight() * 0.5f;
+    const auto entriesPerPixel = (double) numEntries / area.getWidth();
+
+    for (int pixel = 0; pixel < area.getWidth(); ++pixel)
+    {
+        const auto first = (int) (pixel * entriesPerPixel);
+        const auto last = juce::jmax (first + 1, (int) ((pixel + 1) * entriesPerPixel));
+
+        float peak = 0.0f, rms = 0.0f;
+        for (int i = first; i < juce::jmin (last, numEntries); ++i)
+        {
+            peak = juce::jmax (peak, analysis.overview[(size_t) i].peak);
+            rms = juce::jmax (rms, analysis.overview[(size_t) i].rms);
+        }
+
+        const auto x = area.getX() + pixel;
+        peak = juce::jmin (peak, 1.0f);
+        rms = juce::jmin (rms, 1.0f);
+
+        g.setColour (juce::Colours::green.withAlpha (0.7f));
+        g.drawVerticalLine (x, centreY - peak * halfHeight, centreY + peak * halfHeight);
+        g.setColour (juce::Colours::lightgreen);
+        g.drawVerticalLine (x, centreY - rms * halfHeight, centreY + rms * halfHeight);
+    }
+}
+
+void ClipAnalysisDisplay::paint (juce::Graphics& g)
+{
+    g.fillAll (juce::Colours::black);
+    g.setColour (juce::Colours::darkgrey);
+    g.drawRect (getLocalBounds(), 2);
+
+    auto area = getLocalBounds().reduced (6);
+
+    if (summaries.empty())
+    {
+        g.setColour (juce::Colours::grey);
+        g.setFont (14.0f);
+        g.drawText ("No ARA audio sources", area, juce::Justification::centred, false);
+        return;
+    }
+
+    for (const auto& summary : summaries)
+    {
+        if (area.getHeight() < rowHeight)
+            break;
+
+        auto row = area.removeFromTop (rowHeight).reduced (0, 2);
+        auto text = row.removeFromLeft (textWidth);
+
+        g.setColour (juce::Colours::white);
+        g.setFont (13.0f);
+        g.drawText (summary.name.isNotEmpty() ? summary.name : juce::String ("(unnamed)"),
+                    text.removeFromTop (text.getHeight() / 2), juce::Justification::centredLeft, true);
+
+        g.setColour (juce::Colours::grey);
+        g.setFont (12.0f);
+
+        if (summary.progress >= 0.0f)
+        {
+            g.drawText ("Analysing " + juce::String (juce::roundToInt (summary.progress * 100.0f)) + " %",
+                        text, juce::Justification::centredLeft, false);
+        }
+        else if (summary.analysis != nullptr)
+        {
+            g.drawText (juce::String (summary.analysis->integratedLufs, 1) + " LUFS   "
+                          + juce::String (summary.analysis->truePeakDb, 1) + " dBTP",
+                        text, juce::Justification::centredLeft, false);
+
+            drawOverview (g, *summary.analysis, row);
+        }
+        else
+        {
+            g.drawText ("Waiting for sample access", text, juce::Justification::centredLeft, false);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,45 @@
+/*
+    ClipAnalysisDisplay.h
+
+    List of ARA audio sources with their whole-clip analysis.
+
+    Only compiled when the plugin is built with ARA support.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "GainMeterDocumentController.h"
+
+#if JucePlugin_Enable_ARA
+
+//==============================================================================
+/**
+ * One row per audio source: name, integrated loudness, true peak and a
+ * peak/RMS overview of the whole clip (or analysis progress).
+ */
+class ClipAnalysisDisplay : public juce::Component, private juce::Timer
+{
+public:
+    /** @param documentController Controller of the ARA document this editor is bound to */
+    explicit ClipAnalysisDisplay (GainMeterDocumentController& documentController);
+    ~ClipAnalysisDisplay() override;
+
+    void paint (juce::Graphics& g) override;
+
+private:
+    /** Refreshes the source list a few times per second. */
+    void timerCallback() override;
+
+    /** Draws a clip overview squeezed into a rectangle. */
+    static void drawOverview (juce::Graphics& g, const SourceAnalysis& analysis, juce::Rectangle<int> area);
+
+    GainMeterDocumentController& documentController;
+    std::vector<GainMeterDocumentController::SourceSummary> summaries;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ClipAnalysisDisplay)
+};
+
+#endif
@@ -0,0 +1,301 @@
+/*
+    ClipGainDisplay.cpp
+
+    Implementation of the clip gain envelope editor.
+
+    Author: Divij Singh
+*/
+
+#include "ClipGainDisplay.h"
+
+#if JucePlugin_Enable_ARA
+
+namespace
+{
+    /** Vertical range of the editor (the envelope itself may reach -60 dB). */
+    constexpr float displayMinDb = -30.0f;
+    constexpr float displayMaxDb = GainEnvelope::maxGainDb;
+
+    constexpr float handleRadius = 5.0f;
+
+    juce::String getClipName (GainMeterAudioModification& modification)
+    {
+        if (auto* name = modification.getName(); name != nullptr && *name != 0)
+            return juce::String::fromUTF8 (name);
+
+        if (auto* name = modification.getAudioSource()->getName(); name != nullptr && *name != 0)
+            return juce::String::fromUTF8 (name);
+
+        return "(unnamed clip)";
+    }
+}
+
+//==============================================================================
+// Lifecycle
+
+ClipGainDisplay::ClipGainDisplay (GainMeterDocumentController& controller)
+    : documentController (controller)
+{
+    clipSelector.setTextWhenNothingSelected ("No clip selected");
+    clipSelector.onChange = [this] { repaint(); };
+    addAndMakeVisible (clipSelector);
+
+    timerCallback();
+    startTimerHz (5);
+}
+
+ClipGainDisplay::~ClipGainDisplay()
+{
+    stopTimer();
+}
+
+void ClipGainDisplay::timerCallback()
+{
+    const auto& current = documentController.getAudioModifications();
+
+    if (current != listedModifications)
+    {
+        auto* selected = getSelectedModification();
+
+        listedModifications = current;
+        clipSelector.clear (juce::dontSendNotification);
+
+        for (int i = 0; i < listedModifications.size(); ++i)
+            clipSelector.addItem (getClipName (*listedModifications[i]), i + 1);
+
+        const auto index = listedModifications.indexOf (selected);
+        clipSelector.setSelectedId (index >= 0 ? index + 1 : (listedModifications.isEmpty() ? 0 : 1),
+                                    juce::dontSendNotification);
+    }
+
+    repaint();
+}
+
+GainMeterAudioModification* ClipGainDisplay::getSelectedModification() const
+{
+    const auto index = clipSelector.getSelectedId() - 1;
+
+    // The list may be stale for up to one timer tick; only trust live objects
+    auto* modification = listedModifications[index];
+    return documentController.getAudioModifications().contains (modification) ? modification : nullptr;
+}
+
+double ClipGainDisplay::getClipSeconds (const GainMeterAudioModification& modification)
+{
+    const auto* source = modification.getAudioSource();
+    return source->getSampleRate() > 0.0 ? (double) source->getSampleCount() / source->getSampleRate() : 0.0;
+}
+
+//==============================================================================
+// Layout and Mapping
+
+void ClipGainDisplay::resized()
+{
+    clipSelector.setBounds (getLocalBounds().reduced (6).removeFromTop (24).removeFromLeft (260));
+}
+
+juce::Rectangle<int> ClipGainDisplay::getEnvelopeArea() const
+{
+    return getLocalBounds().reduced (6).withTrimmedTop (30);
+}
+
+float ClipGainDisplay::secondsToX (double seconds, double clipSeconds) const
+{
+    const auto area = getEnvelopeArea().toFloat();
+    return area.getX() + (float) (seconds / juce::jmax (1.0e-6, clipSeconds)) * area.getWidth();
+}
+
+double ClipGainDisplay::xToSeconds (float x, double clipSeconds) const
+{
+    const auto area = getEnvelopeArea().toFloat();
+    return juce::jlimit (0.0, clipSeconds, (double) ((x - area.getX()) / juce::jmax (1.0f, area.getWidth())) * clipSeconds);
+}
+
+float ClipGainDisplay::dbToY (float db) const
+{
+    const auto area = getEnvelopeArea().toFloat();
+    return juce::jmap (juce::jlimit (displayMinDb, displayMaxDb, db), displayMinDb, displayMaxDb,
+                       area.getBottom(), area.getY());
+}
+
+float ClipGainDisplay::yToDb (float y) const
+{
+    const auto area = getEnvelopeArea().toFloat();
+    return juce::jlimit (displayMinDb, displayMaxDb,
+                         juce::jmap (y, area.getBottom(), area.getY(), displayMinDb, displayMaxDb));
+}
+
+int ClipGainDisplay::findBreakpointAt (juce::Point<float> position) const
+{
+    auto* modification = getSelectedModification();
+    if (modification == nullptr)
+        return -1;
+
+    const auto clipSeconds = getClipSeconds (*modification);
+    const auto& breakpoints = modification->getBreakpoints();
+
+    for (int i = 0; i < (int) breakpoints.size(); ++i)
+    {
+        const juce::Point<float> handle { secondsToX (breakpoints[(size_t) i].seconds, clipSeconds),
+                                          dbToY (breakpoints[(size_t) i].gainDb) };
+
+        if (handle.getDistanceFrom (position) <= handleRadius * 2.0f)
+            return i;
+    }
+
+    return -1;
+}
+
+//==============================================================================
+// Editing
+
+void ClipGainDisplay::mouseDown (const juce::MouseEvent& event)
+{
+    auto* modification = getSelectedModification();
+    if (modification == nullptr || ! getEnvelopeArea().contains (event.getPosition()))
+        return;
+
+    editedDuringGesture = false;
+    draggedBreakpoint = findBreakpointAt (event.position);
+
+    if (draggedBreakpoint >= 0)
+        return;
+
+    // Add a breakpoint on the current curve so clicking alone changes nothing audible
+    const auto clipSeconds = getClipSeconds (*modification);
+    const auto seconds = xToSeconds (event.position.x, clipSeconds);
+
+    auto breakpoints = modification->getBreakpoints();
+    breakpoints.push_back ({ seconds, GainEnvelope::evaluateDb (breakpoints, seconds) });
+    modification->setBreakpoints (std::move (breakpoints), false);
+
+    draggedBreakpoint = findBreakpointAt ({ secondsToX (seconds, clipSeconds),
+                                            dbToY (GainEnvelope::evaluateDb (modification->getBreakpoints(), seconds)) });
+    editedDuringGesture = true;
+    repaint();
+}
+
+void ClipGainDisplay::mouseDrag (const juce::MouseEvent& event)
+{
+    auto* modification = getSelectedModification();
+    if (modification == nullptr || draggedBreakpoint < 0)
+        return;
+
+    auto breakpoints = modification->getBreakpoints();
+    if (draggedBreakpoint >= (int) breakpoints.size())
+        return;
+
+    const auto seconds = xToSeconds (event.position.x, getClipSeconds (*modification));
+    breakpoints[(size_t) draggedBreakpoint] = { seconds, yToDb (event.position.y) };
+
+    modification->setBreakpoints (breakpoints, false);
+
+    // Sorting may have moved the dragged point; follow it
+    const auto& sorted = modification->getBreakpoints();
+    for (int i = 0; i < (int) sorted.size(); ++i)
+        if (sorted[(size_t) i].seconds == seconds)
+            draggedBreakpoint = i;
+
+    editedDuringGesture = true;
+    repaint();
+}
+
+void ClipGainDisplay::mouseUp (const juce::MouseEvent&)
+{
+    if (auto* modification = getSelectedModification(); modification != nullptr && editedDuringGesture)
+        modification->setBreakpoints (modification->getBreakpoints(), true);
+
+    draggedBreakpoint = -1;
+    editedDuringGesture = false;
+}
+
+void ClipGainDisplay::mouseDoubleClick (const juce::MouseEvent& event)
+{
+    auto* modification = getSelectedModification();
+    if (modification == nullptr)
+        return;
+
+    const auto index = findBreakpointAt (event.position);
+    if (index < 0)
+        return;
+
+    auto breakpoints = modification->getBreakpoints();
+    breakpoints.erase (breakpoints.begin() + index);
+    modification->setBreakpoints (std::move (breakpoints), true);
+
+    draggedBreakpoint = -1;
+    editedDuringGesture = false;
+    repaint();
+}
+
+//==============================================================================
+// Rendering
+
+void ClipGainDisplay::paint (juce::Graphics& g)
+{
+    g.fillAll (juce::Colours::black);
+    g.setColour (juce::Colours::darkgrey);
+    g.drawRect (getLocalBounds(), 2);
+
+    const auto area = getEnvelopeArea();
+    auto* modification = getSelectedModification();
+
+    if (modification == nullptr)
+    {
+        g.setColour (juce::Colours::grey);
+        g.setFont (14.0f);
+        g.drawText ("No ARA clips", area, juce::Justification::centred, false);
+        return;
+    }
+
+    const auto clipSeconds = getClipSeconds (*modification);
+
+    // Clip overview from the cached source analysis
+    if (auto analysis = modification->getAudioSource<GainMeterAudioSource>()->getAnalysis())
+    {
+        const auto numEntries = (int) analysis->overview.size();
+        const auto centreY = (float) area.getCentreY();
+        const auto halfHeight = area.getHeight() * 0.5f;
+
+        g.setColour (juce::Colour (0xff1f3f1f));
+        for (int pixel = 0; pixel < area.getWidth() && numEntries > 0; ++pixel)
+        {
+            const auto index = juce::jmin (numEntries - 1, pixel * numEntries / area.getWidth());
+            const auto peak = juce::jmin (1.0f, analysis->overview[(size_t) index].peak);
+            g.drawVerticalLine (area.getX() + pixel, centreY - peak * halfHeight, centreY + peak * halfHeight);
+        }
+    }
+
+    // 0 dB reference
+    g.setColour (juce::Colour (0xff404040));
+    g.drawHorizontalLine (juce::roundToInt (dbToY (0.0f)), (float) area.getX(), (float) area.getRight());
+
+    // Envelope curve (evaluated per pixel, as rendered) and handles
+    const auto& breakpoints = modification->getBreakpoints();
+    juce::Path curve;
+
+    for (int pixel = 0; pixel <= area.getWidth(); ++pixel)
+    {
+        const auto x = (float) (area.getX() + pixel);
+        const auto y = dbToY (GainEnvelope::evaluateDb (breakpoints, xToSeconds (x, clipSeconds)));
+
+        if (pixel == 0)
+            curve.startNewSubPath (x, y);
+        else
+            curve.lineTo (x, y);
+    }
+
+    g.setColour (juce::Colours::orange);
+    g.strokePath (curve, juce::PathStrokeType (1.5f));
+
+    for (const auto& point : breakpoints)
+        g.fillEllipse (juce::Rectangle<float> (handleRadius * 2.0f, handleRadius * 2.0f)
+                           .withCentre ({ secondsToX (point.seconds, clipSeconds), dbToY (point.gainDb) }));
+
+    g.setColour (juce::Colours::grey);
+    g.setFont (12.0f);
+    g.drawText ("Click: add   Drag: move   Double-click: remove", area.removeFromBottom (16),
+                juce::Justification::centredRight, false);
+}
+
+#endif
@@ -0,0 +1,73 @@
+/*
+    ClipGainDisplay.h
+
+    Breakpoint editor for ARA clip gain envelopes.
+
+    Only compiled when the plugin is built with ARA support.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "GainMeterDocumentController.h"
+
+#if JucePlugin_Enable_ARA
+
+//==============================================================================
+/**
+ * Edits the gain envelope of one audio modification over its clip overview.
+ *
+ * Interaction:
+ * - Choose the clip in the drop-down
+ * - Click to add a breakpoint, drag to move it, double-click to remove it
+ * - The host is notified once per gesture, on mouse up
+ */
+class ClipGainDisplay : public juce::Component, private juce::Timer
+{
+public:
+    /** @param documentController Controller of the ARA document this editor is bound to */
+    explicit ClipGainDisplay (GainMeterDocumentController& documentController);
+    ~ClipGainDisplay() override;
+
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+
+    void mouseDown (const juce::MouseEvent& event) override;
+    void mouseDrag (const juce::MouseEvent& event) override;
+    void mouseUp (const juce::MouseEvent& event) override;
+    void mouseDoubleClick (const juce::MouseEvent& event) override;
+
+private:
+    /** Rebuilds the clip list when modifications come and go. */
+    void timerCallback() override;
+
+    /** Selected modification if it still exists, else nullptr. */
+    GainMeterAudioModification* getSelectedModification() const;
+
+    /** Clip length in seconds (from its audio source). */
+    static double getClipSeconds (const GainMeterAudioModification& modification);
+
+    // Coordinate mapping inside the envelope area
+    juce::Rectangle<int> getEnvelopeArea() const;
+    float secondsToX (double seconds, double clipSeconds) const;
+    double xToSeconds (float x, double clipSeconds) const;
+    float dbToY (float db) const;
+    float yToDb (float y) const;
+
+    /** Index of the breakpoint under a position, or -1. */
+    int findBreakpointAt (juce::Point<float> position) const;
+
+    GainMeterDocumentController& documentController;
+
+    juce::ComboBox clipSelector;
+    juce::Array<GainMeterAudioModification*> listedModifications;
+
+    int draggedBreakpoint = -1;
+    bool editedDuringGesture = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ClipGainDisplay)
+};
+
+#endif
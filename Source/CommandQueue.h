@@ -0,0 +1,97 @@
+/*
+    CommandQueue.h
+
+    Lock-free, fixed-capacity command queue for delivering typed commands
+    to the audio thread.
+
+    Commands are plain value types copied into preallocated storage, so
+    pushing and draining never allocates, locks or blocks. Each queue has
+    exactly one producer thread and one consumer thread (the audio thread).
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+
+//==============================================================================
+/**
+ * A single command addressed to the audio thread.
+ *
+ * Kept trivially copyable so it can live in a preallocated ring buffer.
+ */
+struct ProcessorCommand
+{
+    enum class Type : juce::uint8
+    {
+        setGain,            // Jump the gain smoother to a new target (value = gain in dB)
+        resetPeakHold,              // Forget the held maximum sample and true peak
+        clearClipCounter,           // Zero the clipped-sample counter
+        resetIntegratedLoudness,    // Restart the loudness measurement
+        setLimiterLookahead         // Switch the limiter after a latency change (value = lookahead samples, -1 = off)
+    };
+
+    Type type = Type::setGain;
+    float value = 0.0f;
+};
+
+//==============================================================================
+/**
+ * Single-producer / single-consumer queue backed by juce::AbstractFifo.
+ *
+ * The producer calls push() from its own thread; the audio thread calls
+ * drain() once at the start of each block. Neither side ever waits on
+ * the other - a full queue simply rejects the push.
+ *
+ * @tparam CommandType Trivially copyable command type
+ * @tparam capacity    Number of slots (one slot is reserved by AbstractFifo)
+ */
+template <typename CommandType, int capacity>
+class CommandQueue
+{
+public:
+    /**
+     * Adds a command to the queue (producer thread only).
+     * @return false if the queue is full and the command was dropped
+     */
+    bool push (const CommandType& command) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+        if (size1 + size2 == 0)
+            return false;
+
+        storage[(size_t) (size1 > 0 ? start1 : start2)] = command;
+        fifo.finishedWrite (1);
+        return true;
+    }
+
+    /**
+     * Passes every pending command to the handler in FIFO order
+     * (consumer thread only).
+     * @param handler Callable taking a const CommandType&
+     */
+    template <typename Handler>
+    void drain (Handler&& handler) noexcept
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (fifo.getNumReady(), start1, size1, start2, size2);
+
+        for (int i = 0; i < size1; ++i)
+            handler (storage[(size_t) (start1 + i)]);
+
+        for (int i = 0; i < size2; ++i)
+            handler (storage[(size_t) (start2 + i)]);
+
+        fifo.finishedRead (size1 + size2);
+    }
+
+private:
+    juce::AbstractFifo fifo { capacity };
+    std::array<CommandType, (size_t) capacity> storage {};
+
+    JUCE_DECLARE_NON_COPYABLE (CommandQueue)
+};
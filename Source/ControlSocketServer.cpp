@@ -0,0 +1,218 @@
+/*
+    ControlSocketServer.cpp
+
+    Implementation of the local control socket.
+
+    Uses plain POSIX sockets since JUCE's StreamingSocket only covers TCP.
+    Nothing here runs on the audio thread.
+
+    Author: Divij Singh
+*/
+
+#include "ControlSocketServer.h"
+#include "PluginProcessor.h"
+
+#if ! JUCE_WINDOWS
+ #include <sys/socket.h>
+ #include <sys/un.h>
+ #include <poll.h>
+ #include <unistd.h>
+#endif
+
+namespace
+{
+   #if ! JUCE_WINDOWS
+    void closeSocket (int& fd)
+    {
+        if (fd >= 0)
+            ::close (fd);
+
+        fd = -1;
+    }
+
+    bool sendLine (int fd, const juce::String& line)
+    {
+        const auto text = (line + "\n").toStdString();
+
+       #ifdef MSG_NOSIGNAL
+        const int flags = MSG_NOSIGNAL; // Client hang-ups must not raise SIGPIPE in the host
+       #else
+        const int flags = 0;
+       #endif
+
+        return ::send (fd, text.data(), text.size(), flags) == (ssize_t) text.size();
+    }
+   #endif
+}
+
+//==============================================================================
+ControlSocketServer::ControlSocketServer (GainMeterAudioProcessor& p, const juce::File& file)
+    : juce::Thread ("GainMeter Control Socket"), processor (p), socketFile (file)
+{
+}
+
+ControlSocketServer::~ControlSocketServer()
+{
+    stop();
+}
+
+bool ControlSocketServer::start()
+{
+   #if JUCE_WINDOWS
+    return false;
+   #else
+    if (listenFd >= 0)
+        return true;
+
+    const auto path = socketFile.getFullPathName().toStdString();
+
+    sockaddr_un address {};
+    if (path.size() >= sizeof (address.sun_path))
+        return false; // Path too long for a Unix-domain socket
+
+    // Remove a stale socket left behind by a crashed session
+    socketFile.deleteFile();
+
+    listenFd = ::socket (AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0)
+        return false;
+
+   #ifdef SO_NOSIGPIPE
+    const int noSigPipe = 1;
+    ::setsockopt (listenFd, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof (noSigPipe));
+   #endif
+
+    address.sun_family = AF_UNIX;
+    std::memcpy (address.sun_path, path.c_str(), path.size() + 1);
+
+    if (::bind (listenFd, reinterpret_cast<sockaddr*> (&address), sizeof (address)) != 0
+         || ::listen (listenFd, 4) != 0)
+    {
+        closeSocket (listenFd);
+        return false;
+    }
+
+    startThread();
+    return true;
+   #endif
+}
+
+void ControlSocketServer::stop()
+{
+   #if ! JUCE_WINDOWS
+    stopThread (4 * pollTimeoutMs);
+
+    if (listenFd >= 0)
+    {
+        closeSocket (listenFd);
+        socketFile.deleteFile();
+    }
+   #endif
+}
+
+//==============================================================================
+// Server Thread
+
+void ControlSocketServer::run()
+{
+   #if ! JUCE_WINDOWS
+    while (! threadShouldExit())
+    {
+        pollfd listenPoll { listenFd, POLLIN, 0 };
+
+        if (::poll (&listenPoll, 1, pollTimeoutMs) <= 0)
+            continue;
+
+        auto clientFd = ::accept (listenFd, nullptr, nullptr);
+        if (clientFd < 0)
+            continue;
+
+       #ifdef SO_NOSIGPIPE
+        const int noSigPipe = 1;
+        ::setsockopt (clientFd, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof (noSigPipe));
+       #endif
+
+        serveClient (clientFd);
+        closeSocket (clientFd);
+    }
+   #endif
+}
+
+void ControlSocketServer::serveClient (int clientFd)
+{
+   #if ! JUCE_WINDOWS
+    juce::String pending;
+    char readBuffer[512];
+
+    while (! threadShouldExit())
+    {
+        pollfd clientPoll { clientFd, POLLIN, 0 };
+
+        if (::poll (&clientPoll, 1, pollTimeoutMs) <= 0)
+            continue;
+
+        const auto bytesRead = ::read (clientFd, readBuffer, sizeof (readBuffer));
+        if (bytesRead <= 0)
+            return; // Client disconnected
+
+        pending += juce::String::fromUTF8 (readBuffer, (int) bytesRead);
+
+        // Guard against clients that never send a newline
+        if (pending.length() > 4096)
+            return;
+
+        for (auto newline = pending.indexOfChar ('\n'); newline >= 0; newline = pending.indexOfChar ('\n'))
+        {
+            const auto line = pending.substring (0, newline).trim();
+            pending = pending.substring (newline + 1);
+
+            if (line.isNotEmpty() && ! sendLine (clientFd, handleCommand (line)))
+                return;
+        }
+    }
+   #else
+    juce::ignoreUnused (clientFd);
+   #endif
+}
+
+//==============================================================================
+// Command Handling
+
+juce::String ControlSocketServer::handleCommand (const juce::String& line)
+{
+    auto tokens = juce::StringArray::fromTokens (line, false);
+    tokens.removeEmptyStrings();
+
+    const auto verb = tokens[0].toUpperCase();
+
+    if (verb == "PING" && tokens.size() == 1)
+        return "OK GainMeter " + juce::String (processor.getInstanceId());
+
+    if (verb == "GET" && tokens.size() == 1)
+    {
+        const auto snapshot = processor.getMeterSnapshot();
+        return "OK gain=" + juce::String (snapshot.gainDb, 2)
+             + " peak=" + juce::String (snapshot.peakDb, 2)
+             + " lufs_m=" + juce::String (snapshot.momentaryLufs, 2)
+             + " lufs_s=" + juce::String (snapshot.shortTermLufs, 2)
+             + " lufs_i=" + juce::String (snapshot.integratedLufs, 2)
+             + " tp=" + juce::String (snapshot.truePeakDb, 2)
+             + " kernels=" + juce::String (MeterKernels::getActive().name).removeCharacters ("-").toLowerCase();
+    }
+
+    if (verb == "SET" && tokens.size() == 3 && tokens[1].equalsIgnoreCase ("GAIN"))
+    {
+        const auto& valueText = tokens[2];
+
+        if (! valueText.containsOnly ("0123456789.-+eE") || ! valueText.containsAnyOf ("0123456789"))
+            return "ERR invalid number";
+
+        const auto applied = processor.postRemoteGainChange (valueText.getFloatValue());
+        if (! applied.has_value())
+            return "ERR command queue full";
+
+        return "OK " + juce::String (*applied, 2);
+    }
+
+    return "ERR unknown command";
+}
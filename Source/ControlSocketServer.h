@@ -0,0 +1,77 @@
+/*
+    ControlSocketServer.h
+
+    Optional local control endpoint for scripted test rigs.
+
+    Listens on a Unix-domain socket and answers simple line-based commands
+    (read meter snapshots, set gain) for one processor instance. Runs on its
+    own background thread; gain changes reach the audio thread through the
+    processor's lock-free command queue.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+class GainMeterAudioProcessor;
+
+//==============================================================================
+/**
+ * Unix-domain socket server controlling a single GainMeter instance.
+ *
+ * Protocol (one ASCII command per line, one reply line per command):
+ * - PING            -> OK GainMeter <instance id>
+ * - GET             -> OK gain=<dB> peak=<dB> lufs_m=<LUFS> lufs_s=<LUFS> lufs_i=<LUFS>
+ *                         tp=<dBTP> kernels=<variant>
+ * - SET GAIN <dB>   -> OK <applied dB> | ERR <reason>
+ *
+ * Only one client is served at a time. Not available on Windows.
+ */
+class ControlSocketServer : private juce::Thread
+{
+public:
+    /**
+     * @param processor  Instance controlled through this socket
+     * @param socketFile Filesystem path the socket is bound to
+     */
+    ControlSocketServer (GainMeterAudioProcessor& processor, const juce::File& socketFile);
+
+    /** Stops the server thread and removes the socket file. */
+    ~ControlSocketServer() override;
+
+    /**
+     * Binds the socket and starts the server thread.
+     * @return false if the socket could not be created on this platform/path
+     */
+    bool start();
+
+    /** Stops serving and unlinks the socket file. Safe to call repeatedly. */
+    void stop();
+
+    /** Path of the bound socket file. */
+    const juce::File& getSocketFile() const noexcept { return socketFile; }
+
+    /**
+     * Parses and executes one command line.
+     * @return Reply line without trailing newline
+     */
+    juce::String handleCommand (const juce::String& line);
+
+private:
+    /** Accept loop - polls so that stop() is honoured promptly. */
+    void run() override;
+
+    /** Reads command lines from one connected client until it disconnects. */
+    void serveClient (int clientFd);
+
+    GainMeterAudioProcessor& processor;
+    juce::File socketFile;
+    int listenFd = -1;
+
+    /** Poll timeout bounding how long stop() waits for the thread. */
+    static constexpr int pollTimeoutMs = 100;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ControlSocketServer)
+};
@@ -0,0 +1,28 @@
+/*
+    DspArena.cpp
+
+    Implementation of the per-instance DSP arena.
+
+    Author: Divij Singh
+*/
+
+#include "DspArena.h"
+#include <cstring>
+
+//==============================================================================
+void DspArena::prepare (size_t numBytes)
+{
+    if (numBytes > capacity)
+    {
+        // Over-allocate by one cache line and round the start up to it
+        storage.allocate (numBytes + alignment, false);
+        const auto address = reinterpret_cast<juce::pointer_sized_uint> (storage.get());
+        base = storage.get() + ((alignment - address % alignment) % alignment);
+        capacity = numBytes;
+    }
+
+    if (capacity > 0)
+        std::memset (base, 0, capacity);
+
+    used = 0;
+}
@@ -0,0 +1,83 @@
+/*
+    DspArena.h
+
+    One contiguous, cache-line aligned block holding an instance's
+    rate- and block-size-dependent DSP buffers.
+
+    The processor adds up what every component needs for the worst-case
+    sample rate, channel count and block size, allocates the arena the
+    first time prepareToPlay() runs and hands out pieces in processing
+    order, so the buffers the audio thread walks each block sit next to
+    each other. Later rate and buffer-size changes reuse the same block.
+    Nothing is allocated while processing.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <type_traits>
+
+//==============================================================================
+/**
+ * Bump allocator over a single aligned block.
+ *
+ * Thread roles: prepare() and allocate() off the audio thread (from
+ * prepareToPlay); the audio thread only uses the memory. The block is kept
+ * across releaseResources() and freed with the processor.
+ */
+class DspArena
+{
+public:
+    /** Every allocation starts on its own cache line. */
+    static constexpr size_t alignment = 64;
+
+    /** Arena bytes taken by count objects of type T, padding included. */
+    template <typename T>
+    static constexpr size_t getBytesFor (size_t count) noexcept
+    {
+        return (count * sizeof (T) + alignment - 1) & ~(alignment - 1);
+    }
+
+    /**
+     * Makes room for numBytes of zeroed storage, discarding earlier allocations.
+     * The block is only reallocated when it has to grow, so preparing again
+     * for the same or a smaller size never touches the heap.
+     */
+    void prepare (size_t numBytes);
+
+    /**
+     * Takes zeroed storage for count objects of T from the arena.
+     * @return nullptr (and an assertion) if the arena was sized too small
+     */
+    template <typename T>
+    T* allocate (size_t count) noexcept
+    {
+        static_assert (std::is_trivially_destructible<T>::value, "The arena never runs destructors");
+        static_assert (alignof (T) <= alignment, "Over-aligned type");
+
+        const auto bytes = getBytesFor<T> (count);
+        if (used + bytes > capacity)
+        {
+            jassertfalse;
+            return nullptr;
+        }
+
+        auto* result = reinterpret_cast<T*> (base + used);
+        used += bytes;
+        return result;
+    }
+
+    /** Bytes reserved for DSP state (the per-instance memory figure; may exceed the last request). */
+    size_t getCapacity() const noexcept { return capacity; }
+
+    /** Bytes handed out since the last prepare(). */
+    size_t getUsedBytes() const noexcept { return used; }
+
+private:
+    juce::HeapBlock<char> storage;
+    char* base = nullptr;
+    size_t capacity = 0;
+    size_t used = 0;
+};
@@ -0,0 +1,147 @@
+/*
+    GainEnvelope.cpp
+
+    Implementation of envelope compilation and rendering.
+
+    Author: Divij Singh
+*/
+
+#include "GainEnvelope.h"
+#include <algorithm>
+#include <limits>
+
+//==============================================================================
+// Message Thread
+
+float GainEnvelope::evaluateDb (const std::vector<Breakpoint>& breakpoints, double seconds)
+{
+    if (breakpoints.empty())
+        return 0.0f;
+
+    if (seconds <= breakpoints.front().seconds)
+        return breakpoints.front().gainDb;
+
+    if (seconds >= breakpoints.back().seconds)
+        return breakpoints.back().gainDb;
+
+    auto next = std::upper_bound (breakpoints.begin(), breakpoints.end(), seconds,
+                                  [] (double time, const Breakpoint& point) { return time < point.seconds; });
+    const auto& after = *next;
+    const auto& before = *std::prev (next);
+
+    const auto span = after.seconds - before.seconds;
+    const auto proportion = span > 0.0 ? (float) ((seconds - before.seconds) / span) : 1.0f;
+
+    return before.gainDb + (after.gainDb - before.gainDb) * proportion;
+}
+
+GainEnvelope::SegmentTable GainEnvelope::compile (const std::vector<Breakpoint>& breakpoints, double sampleRate)
+{
+    SegmentTable table;
+
+    if (breakpoints.empty() || sampleRate <= 0.0)
+        return table;
+
+    constexpr auto farFuture = std::numeric_limits<juce::int64>::max();
+    auto toSample = [sampleRate] (double seconds) { return (juce::int64) std::llround (seconds * sampleRate); };
+
+    // Hold the first gain from the clip start
+    const auto firstSample = juce::jmax ((juce::int64) 0, toSample (breakpoints.front().seconds));
+    const auto firstGain = juce::Decibels::decibelsToGain (breakpoints.front().gainDb, minGainDb - 1.0f);
+
+    if (firstSample > 0)
+        table.push_back ({ 0, firstSample, firstGain, 0.0f });
+
+    for (size_t i = 0; i + 1 < breakpoints.size(); ++i)
+    {
+        const auto& from = breakpoints[i];
+        const auto& to = breakpoints[i + 1];
+
+        const auto start = juce::jmax ((juce::int64) 0, toSample (from.seconds));
+        const auto end = toSample (to.seconds);
+        if (end <= start)
+            continue; // Vertical step: the next segment starts at the new gain
+
+        // Constant spans are a single segment; ramps are split so linear-gain
+        // pieces track the dB curve closely
+        if (from.gainDb == to.gainDb)
+        {
+            table.push_back ({ start, end, juce::Decibels::decibelsToGain (from.gainDb, minGainDb - 1.0f), 0.0f });
+            continue;
+        }
+
+        for (auto pieceStart = start; pieceStart < end; pieceStart += maxRampPieceSamples)
+        {
+            const auto pieceEnd = juce::jmin (end, pieceStart + maxRampPieceSamples);
+            const auto startDb = from.gainDb + (to.gainDb - from.gainDb) * (float) (pieceStart - start) / (float) (end - start);
+            const auto endDb   = from.gainDb + (to.gainDb - from.gainDb) * (float) (pieceEnd - start) / (float) (end - start);
+
+            const auto startGain = juce::Decibels::decibelsToGain (startDb, minGainDb - 1.0f);
+            const auto endGain = juce::Decibels::decibelsToGain (endDb, minGainDb - 1.0f);
+
+            table.push_back ({ pieceStart, pieceEnd, startGain, (endGain - startGain) / (float) (pieceEnd - pieceStart) });
+        }
+    }
+
+    // Hold the last gain for the rest of the clip
+    const auto lastStart = juce::jmax ((juce::int64) 0, toSample (breakpoints.back().seconds));
+    table.push_back ({ lastStart, farFuture,
+                       juce::Decibels::decibelsToGain (breakpoints.back().gainDb, minGainDb - 1.0f), 0.0f });
+
+    return table;
+}
+
+//==============================================================================
+// Audio Thread
+
+void GainEnvelope::apply (const SegmentTable& table, juce::AudioBuffer<float>& buffer, int startInBuffer,
+                          int numSamples, juce::int64 clipPosition, float* rampScratch) noexcept
+{
+    if (table.empty() || numSamples <= 0)
+        return;
+
+    // One search per block: the last segment starting at or before the block
+    auto segment = std::upper_bound (table.begin(), table.end(), clipPosition,
+                                     [] (juce::int64 position, const Segment& s) { return position < s.start; });
+
+    if (segment != table.begin())
+        --segment;
+
+    const auto numChannels = buffer.getNumChannels();
+    int done = 0;
+
+    while (done < numSamples && segment != table.end())
+    {
+        const auto position = clipPosition + done;
+        const auto offsetInSegment = juce::jmax ((juce::int64) 0, position - segment->start);
+        const auto length = (int) juce::jmin ((juce::int64) (numSamples - done), segment->end - position);
+
+        if (length <= 0)
+        {
+            ++segment;
+            continue;
+        }
+
+        const auto startGain = segment->startGain + segment->gainIncrement * (float) offsetInSegment;
+
+        if (segment->gainIncrement == 0.0f)
+        {
+            for (int channel = 0; channel < numChannels; ++channel)
+                juce::FloatVectorOperations::multiply (buffer.getWritePointer (channel, startInBuffer + done),
+                                                       startGain, length);
+        }
+        else
+        {
+            // Closed-form ramp (no running sum) so the loop vectorises
+            for (int i = 0; i < length; ++i)
+                rampScratch[i] = startGain + segment->gainIncrement * (float) i;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                juce::FloatVectorOperations::multiply (buffer.getWritePointer (channel, startInBuffer + done),
+                                                       rampScratch, length);
+        }
+
+        done += length;
+        ++segment;
+    }
+}
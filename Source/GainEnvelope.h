@@ -0,0 +1,71 @@
+/*
+    GainEnvelope.h
+
+    Breakpoint gain envelopes compiled into segment tables.
+
+    Breakpoints are edited on the message thread and interpolated in dB.
+    Compiling turns them into a sorted table of short linear-gain segments
+    so rendering a block needs one binary search to find the first segment
+    and then only ramp multiplies - no per-sample breakpoint lookup.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <vector>
+
+//==============================================================================
+/**
+ * Clip gain envelope helpers (stateless; the owner keeps breakpoints and tables).
+ */
+struct GainEnvelope
+{
+    /** User-edited point: gain in dB at a position in clip time. */
+    struct Breakpoint
+    {
+        double seconds = 0.0;
+        float gainDb = 0.0f;
+    };
+
+    /** Linear gain ramp over [start, end) in clip samples. */
+    struct Segment
+    {
+        juce::int64 start = 0;
+        juce::int64 end = 0;
+        float startGain = 1.0f;
+        float gainIncrement = 0.0f;     // Per sample
+    };
+
+    using SegmentTable = std::vector<Segment>;
+
+    /** dB ramps are approximated by linear-gain pieces at most this long. */
+    static constexpr int maxRampPieceSamples = 1024;
+
+    static constexpr float minGainDb = -60.0f;
+    static constexpr float maxGainDb = 12.0f;
+
+    /**
+     * Builds the segment table for sorted breakpoints (message thread).
+     * Gain holds before the first and after the last breakpoint; an empty
+     * envelope compiles to an empty table (unity gain).
+     */
+    static SegmentTable compile (const std::vector<Breakpoint>& breakpoints, double sampleRate);
+
+    /** Gain in dB at a position, for drawing (message thread). */
+    static float evaluateDb (const std::vector<Breakpoint>& breakpoints, double seconds);
+
+    /**
+     * Multiplies a span of every channel by the envelope (audio thread).
+     *
+     * @param table         Compiled segments
+     * @param buffer        Audio to scale
+     * @param startInBuffer First sample to scale
+     * @param numSamples    Number of samples to scale
+     * @param clipPosition  Clip-time sample at startInBuffer
+     * @param rampScratch   At least numSamples floats
+     */
+    static void apply (const SegmentTable& table, juce::AudioBuffer<float>& buffer, int startInBuffer,
+                       int numSamples, juce::int64 clipPosition, float* rampScratch) noexcept;
+};
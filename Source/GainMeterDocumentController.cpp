@@ -0,0 +1,549 @@
+/*
+    GainMeterDocumentController.cpp
+
+    Implementation of the ARA document controller and clip analysis.
+
+    Author: Divij Singh
+*/
+
+#include "GainMeterDocumentController.h"
+
+#if JucePlugin_Enable_ARA
+
+#include "GainMeterPlaybackRenderer.h"
+#include "LoudnessMeter.h"
+#include "TruePeakDetector.h"
+
+namespace
+{
+    /** Samples read from the host per analysis step. */
+    constexpr int analysisBlockSize = 8192;
+
+    /** Archive layout version (2 added clip gain envelopes). */
+    constexpr int archiveVersion = 2;
+
+    //==============================================================================
+    /**
+     * Reads a whole audio source and measures it with the same loudness and
+     * true-peak code the real-time path uses.
+     */
+    class SourceAnalysisJob : public juce::ThreadPoolJob
+    {
+    public:
+        /** Creates the reader on the message thread, where ARA model listeners are registered. */
+        explicit SourceAnalysisJob (GainMeterAudioSource& s)
+            : juce::ThreadPoolJob ("GainMeter Clip Analysis"),
+              source (s),
+              reader (std::make_unique<juce::ARAAudioSourceReader> (&s))
+        {
+        }
+
+        JobStatus runJob() override
+        {
+            const auto numSamples = source.getSampleCount();
+            const auto sampleRate = source.getSampleRate();
+            const auto numChannels = juce::jlimit (1, LoudnessMeter::maxChannels, (int) reader->numChannels);
+
+            auto result = std::make_shared<SourceAnalysis>();
+            result->sampleRate = sampleRate;
+            result->numSamples = numSamples;
+            result->overview.reserve ((size_t) (numSamples / SourceAnalysis::samplesPerOverviewEntry + 1));
+
+            LoudnessMeter loudness;
+            loudness.prepare (sampleRate);
+            TruePeakDetector truePeak;
+            truePeak.reset();
+
+            juce::AudioBuffer<float> block (numChannels, analysisBlockSize);
+            float samplePeak = 0.0f, truePeakMax = 0.0f;
+
+            SourceAnalysis::OverviewEntry entry;
+            double entrySquares = 0.0;
+            int entrySamples = 0;
+
+            source.setProgress (0.0f);
+            source.notifyAnalysisProgressStarted();
+
+            for (juce::int64 position = 0; position < numSamples; position += analysisBlockSize)
+            {
+                if (shouldExit())
+                    return abandon();
+
+                const auto blockSize = (int) juce::jmin ((juce::int64) analysisBlockSize, numSamples - position);
+
+                // Fails once the host revokes sample access; a new job starts when it returns
+                if (! reader->read (&block, 0, blockSize, position, true, true))
+                    return abandon();
+
+                loudness.process (block, numChannels, blockSize);
+                loudness.processPending();
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    const auto* data = block.getReadPointer (channel);
+                    truePeakMax = juce::jmax (truePeakMax, truePeak.processBlock (channel, data, blockSize));
+                }
+
+                // Overview entries span a fixed number of frames across all channels
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    for (int channel = 0; channel < numChannels; ++channel)
+                    {
+                        const auto sample = block.getSample (channel, i);
+                        entry.peak = juce::jmax (entry.peak, std::abs (sample));
+                        entrySquares += (double) sample * sample;
+                    }
+
+                    if (++entrySamples == SourceAnalysis::samplesPerOverviewEntry)
+                    {
+                        entry.rms = (float) std::sqrt (entrySquares / (entrySamples * numChannels));
+                        samplePeak = juce::jmax (samplePeak, entry.peak);
+                        result->overview.push_back (entry);
+
+                        entry = {};
+                        entrySquares = 0.0;
+                        entrySamples = 0;
+                    }
+                }
+
+                const auto fraction = (float) (position + blockSize) / (float) numSamples;
+                source.setProgress (fraction);
+                source.notifyAnalysisProgressUpdated (fraction);
+            }
+
+            if (entrySamples > 0)
+            {
+                entry.rms = (float) std::sqrt (entrySquares / (entrySamples * numChannels));
+                samplePeak = juce::jmax (samplePeak, entry.peak);
+                result->overview.push_back (entry);
+            }
+
+            result->integratedLufs = loudness.getIntegratedLoudness();
+            result->truePeakDb = juce::Decibels::gainToDecibels (truePeakMax, -100.0f);
+            result->samplePeakDb = juce::Decibels::gainToDecibels (samplePeak, -100.0f);
+
+            source.setAnalysis (std::move (result));
+            source.setProgress (-1.0f);
+            source.notifyAnalysisProgressCompleted();
+            return jobHasFinished;
+        }
+
+    private:
+        JobStatus abandon()
+        {
+            source.setProgress (-1.0f);
+            source.notifyAnalysisProgressCompleted();
+            return jobHasFinished;
+        }
+
+        GainMeterAudioSource& source;
+        std::unique_ptr<juce::ARAAudioSourceReader> reader;
+    };
+}
+
+//==============================================================================
+// Audio Source
+
+std::shared_ptr<const SourceAnalysis> GainMeterAudioSource::getAnalysis() const
+{
+    const juce::SpinLock::ScopedLockType lock (analysisLock);
+    return analysis;
+}
+
+void GainMeterAudioSource::setAnalysis (std::shared_ptr<const SourceAnalysis> newAnalysis)
+{
+    const juce::SpinLock::ScopedLockType lock (analysisLock);
+    analysis = std::move (newAnalysis);
+}
+
+bool GainMeterAudioSource::hasValidAnalysis() const
+{
+    auto current = getAnalysis();
+
+    return current != nullptr
+        && current->numSamples == getSampleCount()
+        && current->sampleRate == getSampleRate();
+}
+
+//==============================================================================
+// Audio Modification
+
+GainMeterAudioModification::GainMeterAudioModification (juce::ARAAudioSource* audioSource,
+                                                        ARA::ARAAudioModificationHostRef hostRef,
+                                                        const juce::ARAAudioModification* optionalModificationToClone)
+    : juce::ARAAudioModification (audioSource, hostRef, optionalModificationToClone)
+{
+    // Host-side clip duplication copies the envelope too
+    if (auto* original = dynamic_cast<const GainMeterAudioModification*> (optionalModificationToClone))
+        setBreakpoints (original->getBreakpoints(), false);
+}
+
+GainMeterAudioModification::~GainMeterAudioModification()
+{
+    // Renderers no longer reference this modification when it is destroyed
+    jassert (rendererSlots.empty());
+}
+
+void GainMeterAudioModification::setBreakpoints (std::vector<GainEnvelope::Breakpoint> newBreakpoints, bool notifyHost)
+{
+    std::sort (newBreakpoints.begin(), newBreakpoints.end(),
+               [] (const auto& a, const auto& b) { return a.seconds < b.seconds; });
+
+    breakpoints = std::move (newBreakpoints);
+    compiledTable = GainEnvelope::compile (breakpoints, getAudioSource()->getSampleRate());
+
+    {
+        const juce::ScopedLock lock (slotLock);
+
+        for (auto& [renderer, slot] : rendererSlots)
+            slot->publish (std::make_unique<GainEnvelope::SegmentTable> (compiledTable));
+    }
+
+    if (notifyHost)
+        notifyContentChanged (juce::ARAContentUpdateScopes::samplesAreAffected(), true);
+}
+
+SegmentTableSlot& GainMeterAudioModification::attachRenderer (const void* renderer)
+{
+    const juce::ScopedLock lock (slotLock);
+
+    auto& slot = rendererSlots[renderer];
+
+    if (slot == nullptr)
+    {
+        slot = std::make_unique<SegmentTableSlot>();
+        slot->publish (std::make_unique<GainEnvelope::SegmentTable> (compiledTable));
+    }
+
+    return *slot;
+}
+
+void GainMeterAudioModification::detachRenderer (const void* renderer)
+{
+    const juce::ScopedLock lock (slotLock);
+    rendererSlots.erase (renderer);
+}
+
+//==============================================================================
+// Segment Table Slot
+
+SegmentTableSlot::~SegmentTableSlot()
+{
+    // Only destroyed after its renderer has stopped rendering
+    freeRetiredTables();
+    delete pendingTable.exchange (nullptr);
+    delete activeTable;
+}
+
+void SegmentTableSlot::publish (std::unique_ptr<GainEnvelope::SegmentTable> table)
+{
+    freeRetiredTables();
+
+    // A table the renderer never picked up can be freed right away
+    delete pendingTable.exchange (table.release());
+}
+
+const GainEnvelope::SegmentTable* SegmentTableSlot::acquire() noexcept
+{
+    if (pendingTable.load (std::memory_order_relaxed) != nullptr)
+    {
+        int start1, size1, start2, size2;
+        retiredFifo.prepareToWrite (1, start1, size1, start2, size2);
+
+        // Only swap when the old table can be handed back for deletion
+        if (size1 + size2 > 0)
+        {
+            if (auto* table = pendingTable.exchange (nullptr))
+            {
+                retiredTables[(size_t) (size1 > 0 ? start1 : start2)] = activeTable;
+                retiredFifo.finishedWrite (1);
+                activeTable = table;
+            }
+        }
+    }
+
+    return activeTable != nullptr && ! activeTable->empty() ? activeTable : nullptr;
+}
+
+void SegmentTableSlot::freeRetiredTables()
+{
+    int start1, size1, start2, size2;
+    retiredFifo.prepareToRead (retiredFifo.getNumReady(), start1, size1, start2, size2);
+
+    for (int i = 0; i < size1; ++i)
+        delete retiredTables[(size_t) (start1 + i)];
+
+    for (int i = 0; i < size2; ++i)
+        delete retiredTables[(size_t) (start2 + i)];
+
+    retiredFifo.finishedRead (size1 + size2);
+}
+
+//==============================================================================
+// Lifecycle
+
+GainMeterDocumentController::GainMeterDocumentController (const ARA::PlugIn::PlugInEntry* entry,
+                                                          const ARA::ARADocumentControllerHostInstance* instance)
+    : juce::ARADocumentControllerSpecialisation (entry, instance)
+{
+    readAheadThread.startThread();
+}
+
+GainMeterDocumentController::~GainMeterDocumentController()
+{
+    for (auto* source : audioSources)
+    {
+        cancelAnalysis (*source);
+        source->removeListener (this);
+    }
+
+    for (auto* modification : audioModifications)
+        modification->removeListener (this);
+
+    analysisPool.removeAllJobs (true, 5000);
+    readAheadThread.stopThread (1000);
+}
+
+//==============================================================================
+// Model Object Creation
+
+juce::ARAAudioSource* GainMeterDocumentController::doCreateAudioSource (juce::ARADocument* document,
+                                                                        ARA::ARAAudioSourceHostRef hostRef) noexcept
+{
+    auto* source = new GainMeterAudioSource (document, hostRef);
+    source->addListener (this);
+    audioSources.add (source);
+    return source;
+}
+
+juce::ARAAudioModification* GainMeterDocumentController::doCreateAudioModification (juce::ARAAudioSource* audioSource,
+                                                                                    ARA::ARAAudioModificationHostRef hostRef,
+                                                                                    const juce::ARAAudioModification* optionalModificationToClone) noexcept
+{
+    auto* modification = new GainMeterAudioModification (audioSource, hostRef, optionalModificationToClone);
+    modification->addListener (this);
+    audioModifications.add (modification);
+    return modification;
+}
+
+void GainMeterDocumentController::willDestroyAudioModification (juce::ARAAudioModification* audioModification)
+{
+    auto* modification = static_cast<GainMeterAudioModification*> (audioModification);
+
+    modification->removeListener (this);
+    audioModifications.removeFirstMatchingValue (modification);
+}
+
+juce::ARAPlaybackRenderer* GainMeterDocumentController::doCreatePlaybackRenderer() noexcept
+{
+    return new GainMeterPlaybackRenderer (getDocumentController(), readAheadThread);
+}
+
+//==============================================================================
+// Analysis Scheduling
+
+void GainMeterDocumentController::startAnalysis (GainMeterAudioSource& source)
+{
+    cancelAnalysis (source);
+
+    if (source.hasValidAnalysis() || ! source.isSampleAccessEnabled() || source.getSampleCount() <= 0)
+        return;
+
+    source.analysisJob = std::make_unique<SourceAnalysisJob> (source);
+    analysisPool.addJob (source.analysisJob.get(), false);
+}
+
+void GainMeterDocumentController::cancelAnalysis (GainMeterAudioSource& source)
+{
+    if (source.analysisJob == nullptr)
+        return;
+
+    analysisPool.removeJob (source.analysisJob.get(), true, -1);
+    source.analysisJob.reset();
+    source.setProgress (-1.0f);
+}
+
+void GainMeterDocumentController::didEnableAudioSourceSamplesAccess (juce::ARAAudioSource* audioSource, bool enable)
+{
+    if (enable)
+        startAnalysis (*static_cast<GainMeterAudioSource*> (audioSource));
+}
+
+void GainMeterDocumentController::willEnableAudioSourceSamplesAccess (juce::ARAAudioSource* audioSource, bool enable)
+{
+    if (! enable)
+        cancelAnalysis (*static_cast<GainMeterAudioSource*> (audioSource));
+}
+
+void GainMeterDocumentController::doUpdateAudioSourceContent (juce::ARAAudioSource* audioSource,
+                                                              juce::ARAContentUpdateScopes scopeFlags)
+{
+    if (! scopeFlags.affectSamples())
+        return;
+
+    auto& source = *static_cast<GainMeterAudioSource*> (audioSource);
+    source.setAnalysis (nullptr);
+    startAnalysis (source);
+}
+
+void GainMeterDocumentController::willDestroyAudioSource (juce::ARAAudioSource* audioSource)
+{
+    auto* source = static_cast<GainMeterAudioSource*> (audioSource);
+
+    cancelAnalysis (*source);
+    source->removeListener (this);
+    audioSources.removeFirstMatchingValue (source);
+}
+
+std::vector<GainMeterDocumentController::SourceSummary> GainMeterDocumentController::getSourceSummaries() const
+{
+    std::vector<SourceSummary> summaries;
+    summaries.reserve ((size_t) audioSources.size());
+
+    for (auto* source : audioSources)
+    {
+        SourceSummary summary;
+        summary.name = juce::String::fromUTF8 (source->getName() != nullptr ? source->getName() : "");
+        summary.progress = source->getProgress();
+        summary.analysis = source->getAnalysis();
+        summaries.push_back (std::move (summary));
+    }
+
+    return summaries;
+}
+
+//==============================================================================
+// Archiving - cached analysis survives document save/load
+
+bool GainMeterDocumentController::doStoreObjectsToStream (juce::ARAOutputStream& output,
+                                                          const juce::ARAStoreObjectsFilter* filter) noexcept
+{
+    const auto sourcesToStore = filter->getAudioSourcesToStore<GainMeterAudioSource>();
+
+    // OutputStream writes report failure individually; any failure fails the store
+    bool success = output.writeInt (archiveVersion)
+                && output.writeInt ((int) sourcesToStore.size());
+
+    for (auto* source : sourcesToStore)
+    {
+        auto analysis = source->hasValidAnalysis() ? source->getAnalysis() : nullptr;
+
+        success = success
+               && output.writeString (juce::String::fromUTF8 (source->getPersistentID()))
+               && output.writeBool (analysis != nullptr);
+
+        if (analysis == nullptr)
+            continue;
+
+        success = success
+               && output.writeDouble (analysis->sampleRate)
+               && output.writeInt64 (analysis->numSamples)
+               && output.writeFloat (analysis->integratedLufs)
+               && output.writeFloat (analysis->truePeakDb)
+               && output.writeFloat (analysis->samplePeakDb)
+               && output.writeInt ((int) analysis->overview.size());
+
+        for (const auto& entry : analysis->overview)
+            success = success && output.writeFloat (entry.peak) && output.writeFloat (entry.rms);
+    }
+
+    // Clip gain envelopes
+    const auto modificationsToStore = filter->getAudioModificationsToStore<GainMeterAudioModification>();
+    success = success && output.writeInt ((int) modificationsToStore.size());
+
+    for (auto* modification : modificationsToStore)
+    {
+        const auto& breakpoints = modification->getBreakpoints();
+
+        success = success
+               && output.writeString (juce::String::fromUTF8 (modification->getPersistentID()))
+               && output.writeInt ((int) breakpoints.size());
+
+        for (const auto& point : breakpoints)
+            success = success && output.writeDouble (point.seconds) && output.writeFloat (point.gainDb);
+    }
+
+    return success;
+}
+
+bool GainMeterDocumentController::doRestoreObjectsFromStream (juce::ARAInputStream& input,
+                                                              const juce::ARARestoreObjectsFilter* filter) noexcept
+{
+    const auto version = input.readInt();
+    if (version < 1 || version > archiveVersion)
+        return false;
+
+    const auto numSources = input.readInt();
+
+    for (int i = 0; i < numSources && ! input.failed(); ++i)
+    {
+        const auto persistentId = input.readString();
+        if (! input.readBool())
+            continue;
+
+        auto analysis = std::make_shared<SourceAnalysis>();
+        analysis->sampleRate = input.readDouble();
+        analysis->numSamples = input.readInt64();
+        analysis->integratedLufs = input.readFloat();
+        analysis->truePeakDb = input.readFloat();
+        analysis->samplePeakDb = input.readFloat();
+
+        const auto numEntries = input.readInt();
+        if (numEntries < 0 || numEntries > analysis->numSamples / SourceAnalysis::samplesPerOverviewEntry + 1)
+            return false;
+
+        analysis->overview.resize ((size_t) numEntries);
+        for (auto& entry : analysis->overview)
+        {
+            entry.peak = input.readFloat();
+            entry.rms = input.readFloat();
+        }
+
+        auto* source = filter->getAudioSourceToRestoreStateWithID<GainMeterAudioSource> (persistentId.toRawUTF8());
+        if (source == nullptr)
+            continue;
+
+        source->setAnalysis (std::move (analysis));
+
+        // A cached result that still matches the samples makes re-analysis unnecessary
+        if (source->hasValidAnalysis())
+            cancelAnalysis (*source);
+        else
+            startAnalysis (*source);
+    }
+
+    if (version < 2)
+        return ! input.failed();
+
+    const auto numModifications = input.readInt();
+
+    for (int i = 0; i < numModifications && ! input.failed(); ++i)
+    {
+        const auto persistentId = input.readString();
+        const auto numBreakpoints = input.readInt();
+
+        if (numBreakpoints < 0 || numBreakpoints > 1000000)
+            return false;
+
+        std::vector<GainEnvelope::Breakpoint> breakpoints ((size_t) numBreakpoints);
+        for (auto& point : breakpoints)
+        {
+            point.seconds = input.readDouble();
+            point.gainDb = juce::jlimit (GainEnvelope::minGainDb, GainEnvelope::maxGainDb, input.readFloat());
+        }
+
+        if (auto* modification = filter->getAudioModificationToRestoreStateWithID<GainMeterAudioModification> (persistentId.toRawUTF8()))
+            modification->setBreakpoints (std::move (breakpoints), false);
+    }
+
+    return ! input.failed();
+}
+
+//==============================================================================
+/** Entry point the ARA host uses to create document controllers. */
+const ARA::ARAFactory* JUCE_CALLTYPE createARAFactory()
+{
+    return juce::ARADocumentControllerSpecialisation::createARAFactory<GainMeterDocumentController>();
+}
+
+#endif
@@ -0,0 +1,259 @@
+/*
+    GainMeterDocumentController.h
+
+    ARA 2 document controller: whole-clip loudness and peak analysis.
+
+    With ARA the host hands the plugin random access to every audio source
+    in the document. Each source is analysed once on a background thread
+    (integrated loudness, true peak and a peak/RMS overview) as soon as its
+    samples become readable, so readings exist before the material has
+    ever been played. Results live on the audio source object, are shared
+    by every playback region that uses it, and are stored in the ARA
+    archive so reopening a document does not analyse again.
+
+    Clip gain envelopes live on audio modifications (ARA's per-clip edit
+    object) and are applied by the playback renderer.
+
+    Only compiled when the plugin is built with ARA support.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "GainEnvelope.h"
+
+#if JucePlugin_Enable_ARA
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+//==============================================================================
+/**
+ * Analysis of one complete audio source.
+ * Immutable once published; shared between the UI and the archive code.
+ */
+struct SourceAnalysis
+{
+    static constexpr int samplesPerOverviewEntry = 4096;
+
+    struct OverviewEntry
+    {
+        float peak = 0.0f;  // Largest magnitude in the span
+        float rms = 0.0f;   // RMS over all channels in the span
+    };
+
+    double sampleRate = 0.0;
+    juce::int64 numSamples = 0;
+
+    float integratedLufs = -70.0f;
+    float truePeakDb = -100.0f;
+    float samplePeakDb = -100.0f;
+
+    std::vector<OverviewEntry> overview;
+};
+
+//==============================================================================
+/**
+ * ARA audio source carrying its cached analysis and the job producing it.
+ */
+class GainMeterAudioSource : public juce::ARAAudioSource
+{
+public:
+    using juce::ARAAudioSource::ARAAudioSource;
+
+    /** Latest finished analysis, or nullptr (any thread). */
+    std::shared_ptr<const SourceAnalysis> getAnalysis() const;
+
+    /** Publishes a finished analysis (any thread). */
+    void setAnalysis (std::shared_ptr<const SourceAnalysis> newAnalysis);
+
+    /** True if the cached analysis matches the current sample data. */
+    bool hasValidAnalysis() const;
+
+    /** Analysis progress 0...1 while a job is running, -1 when idle. */
+    float getProgress() const noexcept { return progress.load(); }
+    void setProgress (float newProgress) noexcept { progress.store (newProgress); }
+
+private:
+    friend class GainMeterDocumentController;
+
+    mutable juce::SpinLock analysisLock;
+    std::shared_ptr<const SourceAnalysis> analysis;
+    std::atomic<float> progress { -1.0f };
+
+    /** Running or finished job (owned here so it is destroyed on the message thread). */
+    std::unique_ptr<juce::ThreadPoolJob> analysisJob;
+};
+
+//==============================================================================
+/**
+ * One playback renderer's copy of a clip gain envelope.
+ *
+ * Each renderer playing a modification reads it through its own slot, so
+ * every slot has one publishing thread and one audio thread. New tables
+ * arrive through an atomic pointer; the audio thread hands replaced ones
+ * back through a FIFO so they are only freed once that renderer is done
+ * with them, and never on the audio thread.
+ */
+class SegmentTableSlot
+{
+public:
+    SegmentTableSlot() = default;
+    ~SegmentTableSlot();
+
+    /**
+     * Segment table for rendering (owning renderer's audio thread), or
+     * nullptr for unity gain. Picks up a newly published table if one is waiting.
+     */
+    const GainEnvelope::SegmentTable* acquire() noexcept;
+
+private:
+    friend class GainMeterAudioModification;
+
+    /** Hands a new table to the renderer, taking ownership (not audio thread). */
+    void publish (std::unique_ptr<GainEnvelope::SegmentTable> table);
+
+    /** Frees tables the renderer has finished with (not audio thread). */
+    void freeRetiredTables();
+
+    std::atomic<GainEnvelope::SegmentTable*> pendingTable { nullptr };
+    GainEnvelope::SegmentTable* activeTable = nullptr;      // Owned; the renderer's audio thread uses it
+
+    static constexpr int retiredFifoSize = 8;
+    juce::AbstractFifo retiredFifo { retiredFifoSize };
+    std::array<GainEnvelope::SegmentTable*, retiredFifoSize> retiredTables {};
+
+    JUCE_DECLARE_NON_COPYABLE (SegmentTableSlot)
+};
+
+//==============================================================================
+/**
+ * ARA audio modification carrying a clip gain envelope.
+ *
+ * Breakpoints are in modification (source) time. Every edit compiles a new
+ * segment table on the message thread and publishes a copy to the slot of
+ * each renderer playing the modification.
+ */
+class GainMeterAudioModification : public juce::ARAAudioModification
+{
+public:
+    GainMeterAudioModification (juce::ARAAudioSource* audioSource, ARA::ARAAudioModificationHostRef hostRef,
+                                const juce::ARAAudioModification* optionalModificationToClone);
+    ~GainMeterAudioModification() override;
+
+    /** Current breakpoints, sorted by time (message thread). */
+    const std::vector<GainEnvelope::Breakpoint>& getBreakpoints() const noexcept { return breakpoints; }
+
+    /**
+     * Replaces the envelope and publishes a new segment table (message thread).
+     * @param notifyHost Tell the host the rendered samples changed (set when an edit gesture ends)
+     */
+    void setBreakpoints (std::vector<GainEnvelope::Breakpoint> newBreakpoints, bool notifyHost);
+
+    /**
+     * Returns the slot a renderer reads the envelope through, creating it
+     * with the current table on first use (renderer prepare, not audio thread).
+     */
+    SegmentTableSlot& attachRenderer (const void* renderer);
+
+    /** Frees a renderer's slot once it has stopped rendering (not audio thread). */
+    void detachRenderer (const void* renderer);
+
+private:
+    std::vector<GainEnvelope::Breakpoint> breakpoints;
+
+    /** Table compiled from the current breakpoints; copied into new slots. */
+    GainEnvelope::SegmentTable compiledTable;
+
+    /** Guards the slot list between the message thread and renderer prepare/release. */
+    juce::CriticalSection slotLock;
+    std::map<const void*, std::unique_ptr<SegmentTableSlot>> rendererSlots;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GainMeterAudioModification)
+};
+
+//==============================================================================
+/**
+ * Document controller specialisation for GainMeter.
+ *
+ * Thread roles:
+ * - ARA model callbacks: message thread (host document edits)
+ * - Analysis jobs: analysis thread pool
+ * - Read-ahead for real-time playback: shared time-slice thread
+ */
+class GainMeterDocumentController : public juce::ARADocumentControllerSpecialisation,
+                                    private juce::ARAAudioSource::Listener,
+                                    private juce::ARAAudioModification::Listener
+{
+public:
+    GainMeterDocumentController (const ARA::PlugIn::PlugInEntry* entry,
+                                 const ARA::ARADocumentControllerHostInstance* instance);
+    ~GainMeterDocumentController() override;
+
+    /** Per-source line for the editor's clip list. */
+    struct SourceSummary
+    {
+        juce::String name;
+        float progress = -1.0f;
+        std::shared_ptr<const SourceAnalysis> analysis;
+    };
+
+    /** Snapshot of all audio sources and their analysis state (message thread). */
+    std::vector<SourceSummary> getSourceSummaries() const;
+
+    /** Audio modifications (clip gain envelopes) in creation order (message thread). */
+    const juce::Array<GainMeterAudioModification*>& getAudioModifications() const noexcept { return audioModifications; }
+
+    /** Thread used by playback renderers to read ahead of real-time playback. */
+    juce::TimeSliceThread& getReadAheadThread() noexcept { return readAheadThread; }
+
+protected:
+    //==============================================================================
+    juce::ARAAudioSource* doCreateAudioSource (juce::ARADocument* document,
+                                               ARA::ARAAudioSourceHostRef hostRef) noexcept override;
+
+    juce::ARAAudioModification* doCreateAudioModification (juce::ARAAudioSource* audioSource,
+                                                           ARA::ARAAudioModificationHostRef hostRef,
+                                                           const juce::ARAAudioModification* optionalModificationToClone) noexcept override;
+
+    juce::ARAPlaybackRenderer* doCreatePlaybackRenderer() noexcept override;
+
+    bool doRestoreObjectsFromStream (juce::ARAInputStream& input,
+                                     const juce::ARARestoreObjectsFilter* filter) noexcept override;
+
+    bool doStoreObjectsToStream (juce::ARAOutputStream& output,
+                                 const juce::ARAStoreObjectsFilter* filter) noexcept override;
+
+private:
+    //==============================================================================
+    // juce::ARAAudioSource::Listener
+    void didEnableAudioSourceSamplesAccess (juce::ARAAudioSource* audioSource, bool enable) override;
+    void willEnableAudioSourceSamplesAccess (juce::ARAAudioSource* audioSource, bool enable) override;
+    void doUpdateAudioSourceContent (juce::ARAAudioSource* audioSource,
+                                     juce::ARAContentUpdateScopes scopeFlags) override;
+    void willDestroyAudioSource (juce::ARAAudioSource* audioSource) override;
+
+    // juce::ARAAudioModification::Listener
+    void willDestroyAudioModification (juce::ARAAudioModification* audioModification) override;
+
+    /** Queues a background analysis unless a valid one is cached. */
+    void startAnalysis (GainMeterAudioSource& source);
+
+    /** Interrupts and waits for a running analysis. */
+    void cancelAnalysis (GainMeterAudioSource& source);
+
+    juce::ThreadPool analysisPool { 2 };
+    juce::TimeSliceThread readAheadThread { "GainMeter ARA Read-Ahead" };
+
+    /** Sources created by this controller, in creation order. */
+    juce::Array<GainMeterAudioSource*> audioSources;
+    juce::Array<GainMeterAudioModification*> audioModifications;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GainMeterDocumentController)
+};
+
+#endif
@@ -0,0 +1,213 @@
+/*
+    GainMeterPlaybackRenderer.cpp
+
+    Implementation of the ARA playback renderer.
+
+    Author: Divij Singh
+*/
+
+#include "GainMeterPlaybackRenderer.h"
+#include "GainMeterDocumentController.h"
+
+#if JucePlugin_Enable_ARA
+
+//==============================================================================
+// Lifecycle
+
+GainMeterPlaybackRenderer::GainMeterPlaybackRenderer (ARA::PlugIn::DocumentController* documentController,
+                                                      juce::TimeSliceThread& thread)
+    : juce::ARAPlaybackRenderer (documentController), readAheadThread (thread)
+{
+}
+
+GainMeterPlaybackRenderer::~GainMeterPlaybackRenderer()
+{
+    detachFromModifications();
+}
+
+void GainMeterPlaybackRenderer::detachFromModifications()
+{
+    // Playback regions only change while the renderer is not prepared, so
+    // every modification in the map is still alive here
+    for (auto& [modification, slot] : tableSlots)
+        modification->detachRenderer (this);
+
+    tableSlots.clear();
+}
+
+void GainMeterPlaybackRenderer::prepareToPlay (double newSampleRate, int newMaximumSamplesPerBlock, int newNumChannels,
+                                               juce::AudioProcessor::ProcessingPrecision,
+                                               AlwaysNonRealtime alwaysNonRealtime)
+{
+    sampleRate = newSampleRate;
+    maximumSamplesPerBlock = newMaximumSamplesPerBlock;
+    numChannels = newNumChannels;
+    useBufferedReaders = alwaysNonRealtime == AlwaysNonRealtime::no;
+
+    readers.clear();
+    detachFromModifications();
+
+    for (auto* playbackRegion : getPlaybackRegions())
+    {
+        auto* modification = playbackRegion->getAudioModification<GainMeterAudioModification>();
+        tableSlots.emplace (modification, &modification->attachRenderer (this));
+
+        auto* audioSource = playbackRegion->getAudioModification()->getAudioSource();
+
+        if (readers.find (audioSource) != readers.end())
+            continue;
+
+        auto reader = std::make_unique<juce::ARAAudioSourceReader> (audioSource);
+
+        if (useBufferedReaders)
+        {
+            // Two seconds of read-ahead covers typical disk latency
+            const auto readAheadSamples = juce::jmax (4 * maximumSamplesPerBlock, juce::roundToInt (2.0 * sampleRate));
+            readers.emplace (audioSource, std::make_unique<juce::BufferingAudioReader> (reader.release(), readAheadThread,
+                                                                                        readAheadSamples));
+        }
+        else
+        {
+            readers.emplace (audioSource, std::move (reader));
+        }
+    }
+
+    // Scratch is sized for the largest chunk once, so block size changes never reallocate it
+    jassert (numChannels <= maxScratchChannels);
+
+    if (gainRamp == nullptr || regionBuffer.getNumChannels() < numChannels)
+    {
+        regionBuffer.setSize (juce::jmax (maxScratchChannels, numChannels), renderChunkSize);
+        gainRamp.allocate ((size_t) renderChunkSize, true);
+    }
+}
+
+void GainMeterPlaybackRenderer::releaseResources()
+{
+    // Readers and envelope slots refer to document objects that may go away
+    // while the renderer is not prepared; the scratch buffers are kept
+    readers.clear();
+    detachFromModifications();
+}
+
+//==============================================================================
+// Rendering
+
+bool GainMeterPlaybackRenderer::processBlock (juce::AudioBuffer<float>& buffer, juce::AudioProcessor::Realtime realtime,
+                                              const juce::AudioPlayHead::PositionInfo& positionInfo) noexcept
+{
+    const auto numSamples = buffer.getNumSamples();
+
+    if (gainRamp == nullptr)
+    {
+        buffer.clear();
+        return false;
+    }
+
+    if (numSamples <= renderChunkSize)
+        return renderBlock (buffer, realtime, positionInfo);
+
+    // Larger blocks (or hosts sending more than they announced) render in
+    // scratch-sized pieces, each a view into the host buffer with the song
+    // position moved along
+    bool success = true;
+    const auto blockStart = positionInfo.getTimeInSamples().orFallback (0);
+
+    for (int offset = 0; offset < numSamples; offset += renderChunkSize)
+    {
+        const auto chunkSize = juce::jmin (renderChunkSize, numSamples - offset);
+        juce::AudioBuffer<float> chunk (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), offset, chunkSize);
+
+        auto chunkPosition = positionInfo;
+        chunkPosition.setTimeInSamples (blockStart + offset);
+
+        success = renderBlock (chunk, realtime, chunkPosition) && success;
+    }
+
+    return success;
+}
+
+bool GainMeterPlaybackRenderer::renderBlock (juce::AudioBuffer<float>& buffer, juce::AudioProcessor::Realtime realtime,
+                                             const juce::AudioPlayHead::PositionInfo& positionInfo) noexcept
+{
+    const auto numSamples = buffer.getNumSamples();
+    jassert (numSamples <= renderChunkSize);
+    jassert (realtime == juce::AudioProcessor::Realtime::no || useBufferedReaders);
+    juce::ignoreUnused (realtime);
+
+    bool success = true;
+    bool didRenderAnyRegion = false;
+
+    if (positionInfo.getIsPlaying())
+    {
+        const auto blockRange = juce::Range<juce::int64>::withStartAndLength (positionInfo.getTimeInSamples().orFallback (0),
+                                                                              numSamples);
+
+        for (auto* playbackRegion : getPlaybackRegions())
+        {
+            // Region borders in song time, then clipped to the modification's samples
+            const auto playbackRange = playbackRegion->getSampleRange (sampleRate, juce::ARAPlaybackRegion::IncludeHeadAndTail::no);
+            auto renderRange = blockRange.getIntersectionWith (playbackRange);
+            if (renderRange.isEmpty())
+                continue;
+
+            const juce::Range<juce::int64> modificationRange { playbackRegion->getStartInAudioModificationSamples(),
+                                                               playbackRegion->getEndInAudioModificationSamples() };
+            const auto sourceOffset = modificationRange.getStart() - playbackRange.getStart();
+
+            renderRange = renderRange.getIntersectionWith (modificationRange.movedToStartAt (playbackRange.getStart()));
+            if (renderRange.isEmpty())
+                continue;
+
+            const auto readerIt = readers.find (playbackRegion->getAudioModification()->getAudioSource());
+            if (readerIt == readers.end())
+            {
+                success = false;
+                continue;
+            }
+
+            const auto numToRead = (int) renderRange.getLength();
+            const auto startInBuffer = (int) (renderRange.getStart() - blockRange.getStart());
+            const auto startInSource = renderRange.getStart() + sourceOffset;
+
+            // The first region renders straight into the output, later ones are mixed in
+            auto& target = didRenderAnyRegion ? regionBuffer : buffer;
+
+            if (! readerIt->second->read (&target, startInBuffer, numToRead, startInSource, true, true))
+            {
+                success = false;
+                continue;
+            }
+
+            // Clip gain envelope, in modification (source) time
+            const auto slotIt = tableSlots.find (playbackRegion->getAudioModification<GainMeterAudioModification>());
+            if (const auto* segments = slotIt != tableSlots.end() ? slotIt->second->acquire() : nullptr)
+                GainEnvelope::apply (*segments, target, startInBuffer, numToRead, startInSource, gainRamp.get());
+
+            if (didRenderAnyRegion)
+            {
+                for (int channel = 0; channel < numChannels; ++channel)
+                    buffer.addFrom (channel, startInBuffer, regionBuffer, channel, startInBuffer, numToRead);
+            }
+            else
+            {
+                // Silence the parts of the block outside the first region
+                if (startInBuffer != 0)
+                    buffer.clear (0, startInBuffer);
+
+                const auto endInBuffer = startInBuffer + numToRead;
+                if (endInBuffer < numSamples)
+                    buffer.clear (endInBuffer, numSamples - endInBuffer);
+
+                didRenderAnyRegion = true;
+            }
+        }
+    }
+
+    if (! didRenderAnyRegion)
+        buffer.clear();
+
+    return success;
+}
+
+#endif
@@ -0,0 +1,88 @@
+/*
+    GainMeterPlaybackRenderer.h
+
+    ARA playback renderer: plays the host's playback regions from their
+    audio sources, applies each clip's gain envelope, and leaves the usual
+    gain and metering stage to follow.
+
+    Only compiled when the plugin is built with ARA support.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+
+#if JucePlugin_Enable_ARA
+
+#include <map>
+
+class GainMeterAudioModification;
+class SegmentTableSlot;
+
+//==============================================================================
+/**
+ * Renders the playback regions assigned to one plugin instance.
+ *
+ * Sources are read through ARAAudioSourceReader; for real-time playback
+ * the readers are wrapped in BufferingAudioReader so disk access happens
+ * on the shared read-ahead thread instead of the audio thread.
+ */
+class GainMeterPlaybackRenderer : public juce::ARAPlaybackRenderer
+{
+public:
+    GainMeterPlaybackRenderer (ARA::PlugIn::DocumentController* documentController,
+                               juce::TimeSliceThread& readAheadThread);
+
+    ~GainMeterPlaybackRenderer() override;
+
+    void prepareToPlay (double sampleRate, int maximumSamplesPerBlock, int numChannels,
+                        juce::AudioProcessor::ProcessingPrecision precision,
+                        AlwaysNonRealtime alwaysNonRealtime) override;
+
+    void releaseResources() override;
+
+    bool processBlock (juce::AudioBuffer<float>& buffer, juce::AudioProcessor::Realtime realtime,
+                       const juce::AudioPlayHead::PositionInfo& positionInfo) noexcept override;
+
+private:
+    /** Hands this renderer's envelope slots back to their modifications. */
+    void detachFromModifications();
+
+    /**
+     * Scratch sizes, allocated once per renderer: blocks are rendered in
+     * pieces of at most this many samples (the processor's prepared block
+     * size), for up to the processor's largest (stereo) layout.
+     */
+    static constexpr int renderChunkSize = 8192;
+    static constexpr int maxScratchChannels = 2;
+
+    /** Renders a block of at most renderChunkSize samples. */
+    bool renderBlock (juce::AudioBuffer<float>& buffer, juce::AudioProcessor::Realtime realtime,
+                      const juce::AudioPlayHead::PositionInfo& positionInfo) noexcept;
+
+    juce::TimeSliceThread& readAheadThread;
+
+    double sampleRate = 44100.0;
+    int maximumSamplesPerBlock = 0;
+    int numChannels = 0;
+    bool useBufferedReaders = false;
+
+    /** One reader per audio source used by this renderer's regions. */
+    std::map<juce::ARAAudioSource*, std::unique_ptr<juce::AudioFormatReader>> readers;
+
+    /** This renderer's own gain envelope slot for each modification it plays. */
+    std::map<GainMeterAudioModification*, SegmentTableSlot*> tableSlots;
+
+    /** Scratch buffer for mixing overlapping regions (kept across releaseResources). */
+    juce::AudioBuffer<float> regionBuffer;
+
+    /** Scratch space for clip gain ramps. */
+    juce::HeapBlock<float> gainRamp;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GainMeterPlaybackRenderer)
+};
+
+#endif
@@ -0,0 +1,24 @@
+/*
+    InstanceRegistry.cpp
+
+    Implementation of the live instance list.
+
+    Author: Divij Singh
+*/
+
+#include "InstanceRegistry.h"
+
+//==============================================================================
+void InstanceRegistry::add (GainMeterAudioProcessor* processor)
+{
+    const juce::ScopedLock scopedLock (lock);
+    instances.addIfNotAlreadyThere (processor);
+    markChanged();
+}
+
+void InstanceRegistry::remove (GainMeterAudioProcessor* processor)
+{
+    const juce::ScopedLock scopedLock (lock);
+    instances.removeFirstMatchingValue (processor);
+    markChanged();
+}
@@ -0,0 +1,49 @@
+/*
+    InstanceRegistry.h
+
+    In-process list of live GainMeter processors, for the session overview.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+class GainMeterAudioProcessor;
+
+//==============================================================================
+/**
+ * Every GainMeterAudioProcessor in the process, in creation order.
+ *
+ * Held through juce::SharedResourcePointer. Processors add themselves when
+ * constructed and remove themselves when destroyed, both under the lock, so
+ * a reader holding getLock() can safely call into every listed instance.
+ * The audio thread never touches the registry.
+ */
+class InstanceRegistry
+{
+public:
+    /** Registers a processor (its constructor). */
+    void add (GainMeterAudioProcessor* processor);
+
+    /** Unregisters a processor (its destructor). */
+    void remove (GainMeterAudioProcessor* processor);
+
+    /** Bumps the version so viewers re-read names, e.g. after a track rename. */
+    void markChanged() noexcept { ++version; }
+
+    /** Changes whenever the list or a display name changes. */
+    juce::uint32 getVersion() const noexcept { return version.load(); }
+
+    /** Lock to hold while reading getInstances() or calling into the instances. */
+    const juce::CriticalSection& getLock() const noexcept { return lock; }
+
+    /** The live processors (hold getLock()). */
+    const juce::Array<GainMeterAudioProcessor*>& getInstances() const noexcept { return instances; }
+
+private:
+    juce::CriticalSection lock;
+    juce::Array<GainMeterAudioProcessor*> instances;
+    std::atomic<juce::uint32> version { 0 };
+};
@@ -0,0 +1,116 @@
+/*
+    LevelStatistics.cpp
+
+    Implementation of the session level statistics. The fused
+    gain-and-measure loops live in MeterKernels.
+
+    Author: Divij Singh
+*/
+
+#include "LevelStatistics.h"
+#include "MeterKernels.h"
+
+//==============================================================================
+// Accumulators
+
+void LevelStatistics::Accumulator::merge (const Accumulator& other) noexcept
+{
+    for (size_t bin = 0; bin < histogram.size(); ++bin)
+        histogram[bin] += other.histogram[bin];
+
+    sum += other.sum;
+    sumSquares += other.sumSquares;
+    peak = juce::jmax (peak, other.peak);
+    numSamples += other.numSamples;
+}
+
+//==============================================================================
+// Kernel
+
+LevelStatistics::BlockResult LevelStatistics::applyGainAndAccumulate (float* data, const float* gains, float constantGain,
+                                                                      int numSamples, Accumulator& accumulator) noexcept
+{
+    const auto result = MeterKernels::getActive().applyGainAndMeasure (data, gains, constantGain, numSamples,
+                                                                       accumulator.sum, accumulator.sumSquares,
+                                                                       accumulator.histogram.data());
+
+    accumulator.peak = juce::jmax (accumulator.peak, result.peak);
+    accumulator.numSamples += numSamples;
+
+    return result;
+}
+
+float LevelStatistics::getBinLowerEdgeDb (int bin) noexcept
+{
+    const auto octave = lowestOctave + bin / binsPerOctave;
+    const auto fraction = 1.0f + (float) (bin % binsPerOctave) / (float) binsPerOctave;
+
+    return 20.0f * std::log10 (std::ldexp (fraction, octave));
+}
+
+//==============================================================================
+// Audio Thread Publishing
+
+void LevelStatistics::prepare (double sampleRate)
+{
+    publishInterval = juce::jmax (1, juce::roundToInt (sampleRate * 0.1));
+}
+
+void LevelStatistics::publish (int numSamples, int numChannels) noexcept
+{
+    samplesSincePublish += numSamples;
+    if (samplesSincePublish < publishInterval)
+        return;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+    // FIFO full (message thread stalled): keep accumulating, nothing is lost
+    if (size1 + size2 == 0)
+        return;
+
+    auto& snapshot = snapshots[(size_t) (size1 > 0 ? start1 : start2)];
+    snapshot.numChannels = juce::jmin (numChannels, maxChannels);
+
+    for (int channel = 0; channel < maxChannels; ++channel)
+    {
+        snapshot.channels[(size_t) channel] = pending[(size_t) channel];
+        pending[(size_t) channel] = {};
+    }
+
+    fifo.finishedWrite (1);
+    samplesSincePublish = 0;
+}
+
+//==============================================================================
+// Message Thread
+
+void LevelStatistics::processPending()
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (fifo.getNumReady(), start1, size1, start2, size2);
+
+    auto mergeSnapshot = [this] (const Snapshot& snapshot)
+    {
+        totalChannels = juce::jmax (totalChannels, snapshot.numChannels);
+
+        for (int channel = 0; channel < snapshot.numChannels; ++channel)
+            totals[(size_t) channel].merge (snapshot.channels[(size_t) channel]);
+    };
+
+    for (int i = 0; i < size1; ++i)
+        mergeSnapshot (snapshots[(size_t) (start1 + i)]);
+
+    for (int i = 0; i < size2; ++i)
+        mergeSnapshot (snapshots[(size_t) (start2 + i)]);
+
+    fifo.finishedRead (size1 + size2);
+}
+
+void LevelStatistics::reset()
+{
+    for (auto& channelTotals : totals)
+        channelTotals = {};
+
+    totalChannels = 0;
+}
@@ -0,0 +1,126 @@
+/*
+    LevelStatistics.h
+
+    Session-long level distribution and signal statistics for mastering QC.
+
+    Per-channel accumulators (dBFS histogram, DC sum, energy, peak) are
+    filled by a fused gain-and-measure kernel in the audio thread's gain
+    pass. Every ~100 ms the accumulators are handed to the message thread
+    through a lock-free FIFO, where they are merged into session totals.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+
+//==============================================================================
+/**
+ * Level histogram and statistics accumulated over the whole session.
+ *
+ * Histogram bins are a quarter octave (~1.5 dB) wide and are indexed
+ * straight from the float's exponent and top mantissa bits, so binning
+ * needs no logarithm.
+ *
+ * Thread roles:
+ * - Audio thread: applyGainAndAccumulate(), publish()
+ * - Message thread: processPending(), getTotals(), reset()
+ */
+class LevelStatistics
+{
+public:
+    static constexpr int maxChannels = 2;
+    static constexpr int binsPerOctave = 4;
+    static constexpr int lowestOctave = -24;    // 2^-24 ~ -144 dBFS, lower edge of bin 0
+    static constexpr int numOctaves = 26;       // Up to 2^2 = +12 dBFS (the gain ceiling)
+    static constexpr int numBins = numOctaves * binsPerOctave;
+
+    /** Everything measured on one channel over some span of samples. */
+    struct Accumulator
+    {
+        std::array<juce::uint32, numBins> histogram {};
+        double sum = 0.0;           // For DC offset
+        double sumSquares = 0.0;    // For RMS / crest factor
+        float peak = 0.0f;
+        juce::int64 numSamples = 0;
+
+        /** Adds another accumulator's counts and sums into this one. */
+        void merge (const Accumulator& other) noexcept;
+    };
+
+    /**
+     * Result of one call to the fused kernel. Trivial (no member initialisers)
+     * because the per-instruction-set kernels return it; value-initialise with {}.
+     */
+    struct BlockResult
+    {
+        float peak;                 // Post-gain sample peak of the block
+        int numClipped;             // Post-gain samples at or above full scale
+    };
+
+    //==============================================================================
+    /**
+     * Applies gain and measures the result in one pass over a channel (audio thread).
+     *
+     * @param data      Channel samples, modified in place
+     * @param gains     Per-sample gain ramp, or nullptr to use constantGain
+     * @param constantGain Gain used when gains is nullptr
+     * @param numSamples Number of samples
+     * @param accumulator Receives histogram and sums of the post-gain samples
+     */
+    static BlockResult applyGainAndAccumulate (float* data, const float* gains, float constantGain,
+                                               int numSamples, Accumulator& accumulator) noexcept;
+
+    /** Lower edge of a histogram bin in dBFS. */
+    static float getBinLowerEdgeDb (int bin) noexcept;
+
+    //==============================================================================
+    /** Sets how often pending accumulators are published (~100 ms). */
+    void prepare (double sampleRate);
+
+    /** Accumulator the kernel should fill for a channel (audio thread). */
+    Accumulator& getPendingAccumulator (int channel) noexcept { return pending[(size_t) channel]; }
+
+    /**
+     * Publishes the pending accumulators once enough samples have passed (audio thread).
+     * @param numSamples Samples processed in the current block
+     * @param numChannels Channels that were accumulated
+     */
+    void publish (int numSamples, int numChannels) noexcept;
+
+    /** Merges published accumulators into the session totals (message thread). */
+    void processPending();
+
+    /** Session totals for a channel (message thread). */
+    const Accumulator& getTotals (int channel) const noexcept { return totals[(size_t) channel]; }
+
+    /** Number of channels that have contributed to the totals. */
+    int getNumChannels() const noexcept { return totalChannels; }
+
+    /** Clears the session totals (message thread). */
+    void reset();
+
+private:
+    /** One publication: accumulators for every channel. */
+    struct Snapshot
+    {
+        std::array<Accumulator, maxChannels> channels;
+        int numChannels = 0;
+    };
+
+    // Audio thread
+    std::array<Accumulator, maxChannels> pending;
+    int samplesSincePublish = 0;
+    int publishInterval = 4410;
+
+    // Audio -> message thread FIFO
+    static constexpr int fifoSize = 16;
+    juce::AbstractFifo fifo { fifoSize };
+    std::array<Snapshot, fifoSize> snapshots;
+
+    // Message thread
+    std::array<Accumulator, maxChannels> totals;
+    int totalChannels = 0;
+};
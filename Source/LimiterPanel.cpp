@@ -0,0 +1,129 @@
+/*
+    LimiterPanel.cpp
+
+    Implementation of the limiter controls.
+
+    Author: Divij Singh
+*/
+
+#include "LimiterPanel.h"
+#include "PluginProcessor.h"
+
+namespace
+{
+    /** Deepest reduction the bar shows. */
+    constexpr float meterRangeDb = 12.0f;
+
+    /** Bar fall per 30 Hz tick (about 20 dB/s). */
+    constexpr float meterFallDb = 0.7f;
+}
+
+//==============================================================================
+// Lifecycle
+
+LimiterPanel::LimiterPanel (GainMeterAudioProcessor& p)
+    : processor (p)
+{
+    auto setUpSlider = [this] (juce::Slider& slider, juce::Label& label, const juce::String& name,
+                               juce::AudioParameterFloat& parameter, const juce::String& suffix)
+    {
+        const auto& range = parameter.range;
+        slider.setSliderStyle (juce::Slider::RotaryHorizontalVerticalDrag);
+        slider.setTextBoxStyle (juce::Slider::TextBoxBelow, false, 70, 18);
+        slider.setNormalisableRange ({ (double) range.start, (double) range.end, (double) range.interval, (double) range.skew });
+        slider.setValue (parameter.get(), juce::dontSendNotification);
+        slider.setDoubleClickReturnValue (true, parameter.convertFrom0to1 (parameter.getDefaultValue()));
+        slider.setTextValueSuffix (suffix);
+        slider.onValueChange = [&slider, &parameter] { parameter = (float) slider.getValue(); };
+        addAndMakeVisible (slider);
+
+        label.setText (name, juce::dontSendNotification);
+        label.setJustificationType (juce::Justification::centred);
+        addAndMakeVisible (label);
+    };
+
+    setUpSlider (ceilingSlider, ceilingLabel, "Ceiling", *processor.limiterCeilingParameter, " dBTP");
+    setUpSlider (lookaheadSlider, lookaheadLabel, "Lookahead", *processor.limiterLookaheadParameter, " ms");
+    setUpSlider (releaseSlider, releaseLabel, "Release", *processor.limiterReleaseParameter, " ms");
+
+    enableButton.setToggleState (processor.limiterParameter->get(), juce::dontSendNotification);
+    enableButton.onClick = [this] { *processor.limiterParameter = enableButton.getToggleState(); };
+    addAndMakeVisible (enableButton);
+
+    startTimerHz (30);
+}
+
+LimiterPanel::~LimiterPanel()
+{
+    stopTimer();
+}
+
+//==============================================================================
+// Layout and Painting
+
+void LimiterPanel::resized()
+{
+    auto area = getLocalBounds().reduced (8);
+
+    meterArea = area.removeFromRight (40).withTrimmedTop (24).withTrimmedBottom (18);
+    area.removeFromRight (8);
+
+    enableButton.setBounds (area.removeFromTop (24).removeFromLeft (100));
+    area.removeFromTop (8);
+
+    auto knobs = area.removeFromTop (juce::jmin (area.getHeight() - 20, 160));
+    const auto knobWidth = knobs.getWidth() / 3;
+
+    auto layOutKnob = [] (juce::Rectangle<int> column, juce::Label& label, juce::Slider& slider)
+    {
+        label.setBounds (column.removeFromTop (18));
+        slider.setBounds (column.reduced (4));
+    };
+
+    layOutKnob (knobs.removeFromLeft (knobWidth), ceilingLabel, ceilingSlider);
+    layOutKnob (knobs.removeFromLeft (knobWidth), lookaheadLabel, lookaheadSlider);
+    layOutKnob (knobs, releaseLabel, releaseSlider);
+}
+
+void LimiterPanel::timerCallback()
+{
+    // Keep the controls in step with automation and state changes
+    enableButton.setToggleState (processor.limiterParameter->get(), juce::dontSendNotification);
+
+    const auto enabled = enableButton.getToggleState();
+    ceilingSlider.setEnabled (enabled);
+    lookaheadSlider.setEnabled (enabled);
+    releaseSlider.setEnabled (enabled);
+
+    const auto reduction = processor.getLimiterReduction();
+    displayedReductionDb = juce::jmax (reduction, displayedReductionDb - meterFallDb, 0.0f);
+
+    repaint();
+}
+
+void LimiterPanel::paint (juce::Graphics& g)
+{
+    g.fillAll (juce::Colours::black);
+
+    // Gain-reduction bar, growing down from the top
+    g.setColour (juce::Colour (0xff202020));
+    g.fillRect (meterArea);
+
+    const auto depth = juce::jlimit (0.0f, 1.0f, displayedReductionDb / meterRangeDb);
+    g.setColour (juce::Colours::orange);
+    g.fillRect (meterArea.withHeight (juce::roundToInt (depth * (float) meterArea.getHeight())));
+
+    g.setFont (11.0f);
+    g.setColour (juce::Colours::grey);
+    g.drawText ("GR", meterArea.withY (meterArea.getY() - 20).withHeight (18), juce::Justification::centred, false);
+    g.setColour (juce::Colours::white);
+    g.drawText (juce::String (-displayedReductionDb, 1), meterArea.withY (meterArea.getBottom() + 2).withHeight (16),
+                juce::Justification::centred, false);
+
+    // Latency the host is compensating for
+    const auto latency = processor.getLatencySamples();
+    g.setColour (juce::Colours::grey);
+    g.drawText (latency > 0 ? "Latency: " + juce::String (latency) + " samples" : juce::String ("No added latency"),
+                getLocalBounds().reduced (8).removeFromBottom (16).withTrimmedRight (48),
+                juce::Justification::centredLeft, false);
+}
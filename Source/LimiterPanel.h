@@ -0,0 +1,47 @@
+/*
+    LimiterPanel.h
+
+    Controls and gain-reduction meter for the true-peak safety limiter.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+class GainMeterAudioProcessor;
+
+//==============================================================================
+/**
+ * Limiter switch, ceiling, lookahead and release, plus a gain-reduction bar
+ * and the latency currently reported to the host.
+ *
+ * All settings are processor parameters; a lookahead change reaches the
+ * audio thread (and the host's delay compensation) on the processor's timer.
+ */
+class LimiterPanel : public juce::Component, private juce::Timer
+{
+public:
+    /** @param processor Owning processor (limiter parameters and reduction readout) */
+    explicit LimiterPanel (GainMeterAudioProcessor& processor);
+    ~LimiterPanel() override;
+
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    void timerCallback() override;
+
+    GainMeterAudioProcessor& processor;
+
+    juce::ToggleButton enableButton { "Limiter" };
+    juce::Slider ceilingSlider, lookaheadSlider, releaseSlider;
+    juce::Label ceilingLabel, lookaheadLabel, releaseLabel;
+
+    /** Bar area and its displayed reduction (instant attack, ~20 dB/s fall) */
+    juce::Rectangle<int> meterArea;
+    float displayedReductionDb = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LimiterPanel)
+};
@@ -0,0 +1,128 @@
+/*
+    LinkGroupPanel.cpp
+
+    Implementation of the link group controls.
+
+    Author: Divij Singh
+*/
+
+#include "LinkGroupPanel.h"
+#include "PluginProcessor.h"
+
+//==============================================================================
+// Lifecycle
+
+LinkGroupPanel::LinkGroupPanel (GainMeterAudioProcessor& p)
+    : processor (p)
+{
+    groupLabel.setText ("Link group", juce::dontSendNotification);
+    addAndMakeVisible (groupLabel);
+
+    // Pick an existing group or type a new name
+    groupBox.setEditableText (true);
+    groupBox.setTextWhenNothingSelected ("Not linked - type a name");
+    groupBox.onChange = [this] { joinSelectedGroup(); };
+    addAndMakeVisible (groupBox);
+
+    leaveButton.onClick = [this] { processor.joinLinkGroup ({}); refresh(); };
+    addAndMakeVisible (leaveButton);
+
+    offsetLabel.setText ("Group gain", juce::dontSendNotification);
+    addAndMakeVisible (offsetLabel);
+
+    offsetSlider.setSliderStyle (juce::Slider::LinearHorizontal);
+    offsetSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 70, 18);
+    offsetSlider.setRange (LinkGroupRegistry::minOffsetDb, LinkGroupRegistry::maxOffsetDb, 0.1);
+    offsetSlider.setDoubleClickReturnValue (true, 0.0);
+    offsetSlider.setTextValueSuffix (" dB");
+    offsetSlider.onValueChange = [this] { processor.setLinkGroupOffset ((float) offsetSlider.getValue()); };
+    addAndMakeVisible (offsetSlider);
+
+    membersLabel.setColour (juce::Label::textColourId, juce::Colours::grey);
+    addAndMakeVisible (membersLabel);
+
+    refresh();
+    startTimerHz (5);
+}
+
+LinkGroupPanel::~LinkGroupPanel()
+{
+    stopTimer();
+}
+
+//==============================================================================
+// Group Membership
+
+void LinkGroupPanel::joinSelectedGroup()
+{
+    const auto name = groupBox.getText().trim();
+    if (name == processor.getLinkGroupName())
+        return;
+
+    if (! processor.joinLinkGroup (name))
+        juce::AlertWindow::showMessageBoxAsync (juce::MessageBoxIconType::WarningIcon, "Link group",
+                                                "All " + juce::String (LinkGroupRegistry::maxGroups)
+                                                    + " link groups are in use.");
+
+    refresh();
+}
+
+void LinkGroupPanel::refresh()
+{
+    const auto names = processor.getLinkGroupNames();
+    const auto current = processor.getLinkGroupName();
+
+    if (names != shownNames)
+    {
+        shownNames = names;
+        groupBox.clear (juce::dontSendNotification);
+        groupBox.addItemList (names, 1);
+    }
+
+    // Don't fight the user while they type a new name
+    if (! groupBox.hasKeyboardFocus (true))
+        groupBox.setText (current, juce::dontSendNotification);
+
+    const auto linked = current.isNotEmpty();
+    leaveButton.setEnabled (linked);
+    offsetSlider.setEnabled (linked);
+
+    if (! offsetSlider.isMouseButtonDown())
+        offsetSlider.setValue (processor.getLinkGroupOffset(), juce::dontSendNotification);
+
+    const auto size = processor.getLinkGroupSize();
+    membersLabel.setText (linked ? juce::String (size) + (size == 1 ? " instance" : " instances") + " in this group"
+                                 : juce::String ("Instances in the same group move together"),
+                          juce::dontSendNotification);
+}
+
+void LinkGroupPanel::timerCallback()
+{
+    refresh();
+}
+
+//==============================================================================
+// Layout and Painting
+
+void LinkGroupPanel::resized()
+{
+    auto area = getLocalBounds().reduced (8);
+
+    auto groupRow = area.removeFromTop (24);
+    groupLabel.setBounds (groupRow.removeFromLeft (80));
+    leaveButton.setBounds (groupRow.removeFromRight (70));
+    groupBox.setBounds (groupRow.reduced (4, 0));
+
+    area.removeFromTop (12);
+    auto offsetRow = area.removeFromTop (24);
+    offsetLabel.setBounds (offsetRow.removeFromLeft (80));
+    offsetSlider.setBounds (offsetRow.reduced (4, 0));
+
+    area.removeFromTop (8);
+    membersLabel.setBounds (area.removeFromTop (20));
+}
+
+void LinkGroupPanel::paint (juce::Graphics& g)
+{
+    g.fillAll (juce::Colours::black);
+}
@@ -0,0 +1,52 @@
+/*
+    LinkGroupPanel.h
+
+    Link group picker and group gain fader.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+class GainMeterAudioProcessor;
+
+//==============================================================================
+/**
+ * Joins or leaves a named link group and moves the group's gain offset.
+ *
+ * The group list and fader follow changes made from other instances,
+ * polled a few times a second.
+ */
+class LinkGroupPanel : public juce::Component, private juce::Timer
+{
+public:
+    /** @param processor Owning processor (link group membership) */
+    explicit LinkGroupPanel (GainMeterAudioProcessor& processor);
+    ~LinkGroupPanel() override;
+
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    void timerCallback() override;
+
+    /** Joins the group named in the picker (a new name creates a group). */
+    void joinSelectedGroup();
+
+    /** Refreshes the picker list, fader and member count from the registry. */
+    void refresh();
+
+    GainMeterAudioProcessor& processor;
+
+    juce::Label groupLabel, offsetLabel, membersLabel;
+    juce::ComboBox groupBox;
+    juce::TextButton leaveButton { "Leave" };
+    juce::Slider offsetSlider;
+
+    /** Names shown in the picker, to rebuild it only when the list changes. */
+    juce::StringArray shownNames;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LinkGroupPanel)
+};
@@ -0,0 +1,84 @@
+/*
+    LinkGroupRegistry.cpp
+
+    Implementation of the link group registry.
+
+    Author: Divij Singh
+*/
+
+#include "LinkGroupRegistry.h"
+
+//==============================================================================
+int LinkGroupRegistry::join (const juce::String& name, float initialOffsetDb)
+{
+    jassert (name.isNotEmpty());
+
+    const juce::ScopedLock scopedLock (lock);
+    auto freeSlot = noGroup;
+
+    for (int slot = 0; slot < maxGroups; ++slot)
+    {
+        if (names[(size_t) slot] == name)
+        {
+            slots[(size_t) slot].numMembers.fetch_add (1);
+            return slot;
+        }
+
+        if (freeSlot == noGroup && names[(size_t) slot].isEmpty())
+            freeSlot = slot;
+    }
+
+    if (freeSlot != noGroup)
+    {
+        names[(size_t) freeSlot] = name;
+        setOffset (freeSlot, initialOffsetDb);
+        slots[(size_t) freeSlot].numMembers.store (1);
+    }
+
+    return freeSlot;
+}
+
+void LinkGroupRegistry::leave (int slot)
+{
+    if (slot < 0 || slot >= maxGroups)
+        return;
+
+    const juce::ScopedLock scopedLock (lock);
+
+    if (slots[(size_t) slot].numMembers.fetch_sub (1) == 1)
+        names[(size_t) slot].clear();
+}
+
+juce::String LinkGroupRegistry::getName (int slot) const
+{
+    if (slot < 0 || slot >= maxGroups)
+        return {};
+
+    const juce::ScopedLock scopedLock (lock);
+    return names[(size_t) slot];
+}
+
+juce::StringArray LinkGroupRegistry::getGroupNames() const
+{
+    const juce::ScopedLock scopedLock (lock);
+    juce::StringArray result;
+
+    for (const auto& name : names)
+        if (name.isNotEmpty())
+            result.add (name);
+
+    result.sortNatural();
+    return result;
+}
+
+int LinkGroupRegistry::getNumMembers (int slot) const noexcept
+{
+    return slot >= 0 && slot < maxGroups ? slots[(size_t) slot].numMembers.load() : 0;
+}
+
+void LinkGroupRegistry::setOffset (int slot, float offsetDb) noexcept
+{
+    if (slot >= 0 && slot < maxGroups)
+        slots[(size_t) slot].offsetDb.store (juce::jlimit (minOffsetDb, maxOffsetDb, offsetDb),
+                                             std::memory_order_relaxed);
+}
@@ -0,0 +1,90 @@
+/*
+    LinkGroupRegistry.h
+
+    In-process registry of named link groups, so GainMeter instances can
+    move together like channels on a VCA fader.
+
+    Each group owns one slot in a fixed array. A slot holds the group's gain
+    offset and member count and sits on its own cache line, so instances
+    reading one group never contend with writes to another. The array is
+    never resized: an instance keeps its slot index and reads the offset
+    with one relaxed atomic load per block, whatever the number of
+    instances or groups.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+
+//==============================================================================
+/**
+ * Named groups of instances sharing a gain offset.
+ *
+ * Held through juce::SharedResourcePointer so every instance in the process
+ * sees the same groups.
+ *
+ * Thread roles:
+ * - join(), leave(), names: any non-audio thread (membership changes lock)
+ * - getOffset(): any thread, lock-free (the audio thread's read)
+ * - setOffset(): any thread, lock-free
+ */
+class LinkGroupRegistry
+{
+public:
+    /** Most groups that can exist at once. */
+    static constexpr int maxGroups = 64;
+
+    /** Slot index meaning "not in a group". */
+    static constexpr int noGroup = -1;
+
+    /** Offset range, matching the gain parameter. */
+    static constexpr float minOffsetDb = -60.0f;
+    static constexpr float maxOffsetDb = 12.0f;
+
+    /**
+     * Joins a group by name, creating it when no instance is in it yet.
+     * @param name            Group name (case-sensitive, not empty)
+     * @param initialOffsetDb Offset for a newly created group, e.g. from a saved session
+     * @return The group's slot, or noGroup when all slots are taken
+     */
+    int join (const juce::String& name, float initialOffsetDb);
+
+    /** Leaves a group; the last member to leave frees its slot. */
+    void leave (int slot);
+
+    /** Name of the group in a slot (empty for a free slot). */
+    juce::String getName (int slot) const;
+
+    /** Names of all groups with members, for group pickers. */
+    juce::StringArray getGroupNames() const;
+
+    /** Number of instances in the group. */
+    int getNumMembers (int slot) const noexcept;
+
+    /** Group gain offset in dB, added to each member's gain. */
+    float getOffset (int slot) const noexcept
+    {
+        return slots[(size_t) slot].offsetDb.load (std::memory_order_relaxed);
+    }
+
+    /** Moves the whole group (clamped to the offset range). */
+    void setOffset (int slot, float offsetDb) noexcept;
+
+private:
+    /** One group's shared state, alone on its cache line. */
+    struct alignas (64) Slot
+    {
+        std::atomic<float> offsetDb { 0.0f };
+        std::atomic<int> numMembers { 0 };
+    };
+
+    std::array<Slot, maxGroups> slots;
+
+    // Guarded by lock; only membership changes and name lookups take it
+    std::array<juce::String, maxGroups> names;
+    juce::CriticalSection lock;
+};
@@ -0,0 +1,260 @@
+/*
+    LoudnessMeter.cpp
+
+    Implementation of the BS.1770 loudness meter.
+
+    K-weighting coefficients are computed for the actual sample rate with
+    the standard bilinear-transform design (matches the 48 kHz reference
+    coefficients in BS.1770 Annex 1).
+
+    Author: Divij Singh
+*/
+
+#include "LoudnessMeter.h"
+
+//==============================================================================
+// Helpers
+
+float LoudnessMeter::energyToLufs (double energy) noexcept
+{
+    if (energy <= 0.0)
+        return silenceLufs;
+
+    return juce::jmax (silenceLufs, (float) (-0.691 + 10.0 * std::log10 (energy)));
+}
+
+//==============================================================================
+// Preparation
+
+void LoudnessMeter::prepare (double sampleRate)
+{
+    const auto pi = juce::MathConstants<double>::pi;
+
+    // Stage 1: high-shelf pre-filter modelling the head
+    Biquad shelf {};
+    {
+        const auto f0 = 1681.974450955533;
+        const auto gainDb = 3.999843853973347;
+        const auto q = 0.7071752369554196;
+
+        const auto k = std::tan (pi * f0 / sampleRate);
+        const auto vh = std::pow (10.0, gainDb / 20.0);
+        const auto vb = std::pow (vh, 0.4996667741545416);
+        const auto a0 = 1.0 + k / q + k * k;
+
+        shelf.b0 = (vh + vb * k / q + k * k) / a0;
+        shelf.b1 = 2.0 * (k * k - vh) / a0;
+        shelf.b2 = (vh - vb * k / q + k * k) / a0;
+        shelf.a1 = 2.0 * (k * k - 1.0) / a0;
+        shelf.a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    // Stage 2: RLB high-pass
+    Biquad highPass {};
+    {
+        const auto f0 = 38.13547087602444;
+        const auto q = 0.5003270373238773;
+
+        const auto k = std::tan (pi * f0 / sampleRate);
+        const auto a0 = 1.0 + k / q + k * k;
+
+        highPass.b0 = 1.0;
+        highPass.b1 = -2.0;
+        highPass.b2 = 1.0;
+        highPass.a1 = 2.0 * (k * k - 1.0) / a0;
+        highPass.a2 = (1.0 - k / q + k * k) / a0;
+    }
+
+    for (auto& channelFilters : kFilters)
+    {
+        channelFilters[0] = shelf;
+        channelFilters[1] = highPass;
+    }
+
+    // 100 ms step energies are rate-independent, so a rate change mid-session
+    // keeps the windows and the gating history
+    samplesPerStep = juce::jmax (1, juce::roundToInt (sampleRate * 0.1));
+    restartStep();
+}
+
+void LoudnessMeter::restartStep() noexcept
+{
+    for (auto& channelFilters : kFilters)
+        for (auto& filter : channelFilters)
+            filter.z1 = filter.z2 = 0.0;
+
+    samplesInStep = 0;
+    stepSumSquares = 0.0;
+}
+
+void LoudnessMeter::resetMeasurement() noexcept
+{
+    restartStep();
+
+    stepEnergies.fill (0.0);
+    stepIndex = 0;
+    numStepsFilled = 0;
+
+    momentaryLufs.store (silenceLufs);
+    shortTermLufs.store (silenceLufs);
+
+    // Tell the message thread to drop its gating history (retried until delivered)
+    resetPending = true;
+    pushGatingBlock ({ 0.0, true });
+}
+
+//==============================================================================
+// Audio Thread
+
+void LoudnessMeter::pushGatingBlock (const GatingBlock& block) noexcept
+{
+    auto write = [this] (const GatingBlock& blockToWrite)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+        if (size1 + size2 == 0)
+            return false; // Message thread stalled
+
+        gatingBlocks[(size_t) (size1 > 0 ? start1 : start2)] = blockToWrite;
+        fifo.finishedWrite (1);
+        return true;
+    };
+
+    // An undelivered reset marker must go first so old and new blocks never mix
+    if (resetPending)
+    {
+        if (! write ({ 0.0, true }))
+            return;
+
+        resetPending = false;
+
+        if (block.isReset)
+            return;
+    }
+
+    write (block);
+}
+
+void LoudnessMeter::process (const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept
+{
+    numChannels = juce::jmin (numChannels, maxChannels);
+    const auto& kernels = MeterKernels::getActive();
+    int position = 0;
+
+    while (position < numSamples)
+    {
+        const auto chunk = juce::jmin (numSamples - position, samplesPerStep - samplesInStep);
+
+        // K-weight and accumulate energy; L and R both have weight 1.0
+        for (int channel = 0; channel < numChannels; ++channel)
+            stepSumSquares += kernels.filterAndSumSquares (buffer.getReadPointer (channel, position), chunk,
+                                                           kFilters[(size_t) channel].data());
+
+        samplesInStep += chunk;
+        position += chunk;
+
+        if (samplesInStep < samplesPerStep)
+            continue;
+
+        // Completed a 100 ms step: update the sliding windows
+        stepEnergies[(size_t) stepIndex] = stepSumSquares / samplesPerStep;
+        stepIndex = (stepIndex + 1) % stepsPerShortTerm;
+        numStepsFilled = juce::jmin (numStepsFilled + 1, stepsPerShortTerm);
+        samplesInStep = 0;
+        stepSumSquares = 0.0;
+
+        auto windowEnergy = [this] (int numSteps)
+        {
+            double sum = 0.0;
+            for (int step = 1; step <= numSteps; ++step)
+                sum += stepEnergies[(size_t) ((stepIndex - step + stepsPerShortTerm) % stepsPerShortTerm)];
+
+            return sum / numSteps;
+        };
+
+        if (numStepsFilled >= stepsPerMomentary)
+        {
+            const auto momentaryEnergy = windowEnergy (stepsPerMomentary);
+            momentaryLufs.store (energyToLufs (momentaryEnergy));
+
+            // Every momentary block (400 ms, 75% overlap) is a gating block
+            pushGatingBlock ({ momentaryEnergy, false });
+        }
+
+        shortTermLufs.store (energyToLufs (windowEnergy (numStepsFilled)));
+    }
+}
+
+//==============================================================================
+// Message Thread
+
+void LoudnessMeter::processPending()
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (fifo.getNumReady(), start1, size1, start2, size2);
+
+    if (size1 + size2 == 0)
+        return;
+
+    auto addBlock = [this] (const GatingBlock& block)
+    {
+        if (block.isReset)
+        {
+            gateCounts.fill (0);
+            gateEnergies.fill (0.0);
+            return;
+        }
+
+        const auto lufs = energyToLufs (block.energy);
+        if (lufs <= silenceLufs)
+            return; // Absolute gate
+
+        const auto bin = juce::jlimit (0, numHistogramBins - 1,
+                                       (int) ((lufs - histogramMinLufs) / histogramBinWidth));
+        ++gateCounts[(size_t) bin];
+        gateEnergies[(size_t) bin] += block.energy;
+    };
+
+    for (int i = 0; i < size1; ++i)
+        addBlock (gatingBlocks[(size_t) (start1 + i)]);
+
+    for (int i = 0; i < size2; ++i)
+        addBlock (gatingBlocks[(size_t) (start2 + i)]);
+
+    fifo.finishedRead (size1 + size2);
+
+    integratedLufs.store (computeIntegratedLoudness());
+}
+
+float LoudnessMeter::computeIntegratedLoudness() const
+{
+    // Stage 1: mean of all blocks above the absolute gate
+    juce::uint64 count = 0;
+    double energy = 0.0;
+
+    for (int bin = 0; bin < numHistogramBins; ++bin)
+    {
+        count += gateCounts[(size_t) bin];
+        energy += gateEnergies[(size_t) bin];
+    }
+
+    if (count == 0)
+        return silenceLufs;
+
+    // Stage 2: relative gate 10 LU below the absolute-gated loudness
+    const auto relativeGate = energyToLufs (energy / (double) count) - 10.0f;
+    const auto firstBin = juce::jlimit (0, numHistogramBins - 1,
+                                        (int) std::ceil ((relativeGate - histogramMinLufs) / histogramBinWidth));
+
+    count = 0;
+    energy = 0.0;
+
+    for (int bin = firstBin; bin < numHistogramBins; ++bin)
+    {
+        count += gateCounts[(size_t) bin];
+        energy += gateEnergies[(size_t) bin];
+    }
+
+    return count > 0 ? energyToLufs (energy / (double) count) : silenceLufs;
+}
@@ -0,0 +1,118 @@
+/*
+    LoudnessMeter.h
+
+    ITU-R BS.1770 / EBU R128 loudness measurement.
+
+    The audio thread K-weights the signal and produces momentary (400 ms)
+    and short-term (3 s) loudness every 100 ms. Each momentary block is
+    also queued for the message thread, which keeps a fixed-size gating
+    histogram so integrated loudness can be recomputed at any time without
+    storing the block history.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "MeterKernels.h"
+#include <array>
+
+//==============================================================================
+/**
+ * Momentary, short-term and integrated loudness (LUFS).
+ *
+ * Thread roles:
+ * - Audio thread: process(), resetMeasurement()
+ * - Message thread: processPending(), getIntegratedLoudness()
+ * - Any thread: getMomentaryLoudness(), getShortTermLoudness()
+ */
+class LoudnessMeter
+{
+public:
+    static constexpr int maxChannels = 2;
+    static constexpr float silenceLufs = -70.0f;    // Absolute gate, also the display floor
+
+    /** Converts a mean-square energy to LUFS. */
+    static float energyToLufs (double energy) noexcept;
+
+    /**
+     * Computes K-weighting coefficients for the sample rate (not real-time safe).
+     * The momentary, short-term and integrated measurements carry over; only the
+     * filter state and the unfinished 100 ms step start again.
+     */
+    void prepare (double sampleRate);
+
+    /** K-weights and measures one block of post-gain audio (audio thread). */
+    void process (const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept;
+
+    /**
+     * Restarts the measurement (audio thread).
+     * The message-thread gate is cleared when it reaches the reset marker.
+     */
+    void resetMeasurement() noexcept;
+
+    /** Latest momentary loudness (400 ms window). */
+    float getMomentaryLoudness() const noexcept { return momentaryLufs.load(); }
+
+    /** Latest short-term loudness (3 s window). */
+    float getShortTermLoudness() const noexcept { return shortTermLufs.load(); }
+
+    /** Gated integrated loudness since the last reset. */
+    float getIntegratedLoudness() const noexcept { return integratedLufs.load(); }
+
+    /** Moves queued blocks into the gating histogram and updates the integrated value (message thread). */
+    void processPending();
+
+private:
+    //==============================================================================
+    using Biquad = MeterKernels::Biquad;
+
+    /** Pre-filter (high shelf) and RLB high-pass per channel. */
+    std::array<std::array<Biquad, 2>, maxChannels> kFilters {};
+
+    /** Clears the filter state and the unfinished step. */
+    void restartStep() noexcept;
+
+    // 100 ms step energies for the sliding windows
+    static constexpr int stepsPerMomentary = 4;     // 400 ms
+    static constexpr int stepsPerShortTerm = 30;    // 3 s
+    std::array<double, stepsPerShortTerm> stepEnergies {};
+    int stepIndex = 0;
+    int numStepsFilled = 0;
+    int samplesPerStep = 4410;
+    int samplesInStep = 0;
+    double stepSumSquares = 0.0;
+
+    std::atomic<float> momentaryLufs { silenceLufs };
+    std::atomic<float> shortTermLufs { silenceLufs };
+    std::atomic<float> integratedLufs { silenceLufs };
+
+    //==============================================================================
+    // Audio -> message thread gating blocks
+    struct GatingBlock
+    {
+        double energy = 0.0;
+        bool isReset = false;       // Marks a measurement restart
+    };
+
+    static constexpr int fifoSize = 256;
+    juce::AbstractFifo fifo { fifoSize };
+    std::array<GatingBlock, fifoSize> gatingBlocks {};
+    bool resetPending = false;      // Audio thread: reset marker still to be queued
+
+    void pushGatingBlock (const GatingBlock& block) noexcept;
+
+    //==============================================================================
+    // Message thread gating histogram: 0.1 LU bins from -70 to +10 LUFS
+    static constexpr float histogramMinLufs = silenceLufs;
+    static constexpr float histogramBinWidth = 0.1f;
+    static constexpr int numHistogramBins = 800;
+
+    std::array<juce::uint32, numHistogramBins> gateCounts {};
+    std::array<double, numHistogramBins> gateEnergies {};
+
+    /** Two-stage gated mean of the histogram (absolute -70 LUFS, relative -10 LU). */
+    float computeIntegratedLoudness() const;
+};
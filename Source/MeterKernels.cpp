@@ -0,0 +1,106 @@
+/*
+    MeterKernels.cpp
+
+    Baseline kernel variant and the one-time variant selection.
+
+    Author: Divij Singh
+*/
+
+#include "MeterKernelsImpl.h"
+
+#if defined (__ARM_NEON) || defined (__ARM_NEON__) || defined (_M_ARM64)
+ GAINMETER_DEFINE_KERNEL_TABLE (getBaselineMeterKernels, "NEON")
+#elif defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)
+ GAINMETER_DEFINE_KERNEL_TABLE (getBaselineMeterKernels, "SSE2")
+#else
+ GAINMETER_DEFINE_KERNEL_TABLE (getBaselineMeterKernels, "Scalar")
+#endif
+
+// Defined in the per-instruction-set translation units (nullptr when not built)
+const MeterKernels::Table* getAvx2MeterKernels() noexcept;
+const MeterKernels::Table* getAvx512MeterKernels() noexcept;
+
+namespace
+{
+    struct Selection
+    {
+        const MeterKernels::Table* table = nullptr;
+        juce::String description;
+    };
+
+    juce::String normaliseName (const juce::String& name)
+    {
+        return name.removeCharacters ("-_ ").toLowerCase();
+    }
+
+    Selection selectKernels()
+    {
+        using Stats = juce::SystemStats;
+
+        struct Candidate
+        {
+            const MeterKernels::Table* table;
+            bool supported;
+        };
+
+        // Best first; the baseline is what the whole plugin was compiled for
+        const Candidate candidates[] {
+            { getAvx512MeterKernels(), Stats::hasAVX512F() && Stats::hasAVX512BW() && Stats::hasAVX512DQ()
+                                       && Stats::hasAVX512VL() && Stats::hasFMA3() },
+            { getAvx2MeterKernels(),   Stats::hasAVX2() && Stats::hasFMA3() },
+            { getBaselineMeterKernels(), true }
+        };
+
+        const auto requested = Stats::getEnvironmentVariable ("GAINMETER_KERNELS", {}).trim();
+        juce::String refusal;
+
+        if (requested.isNotEmpty())
+        {
+            refusal = "not in this build";
+
+            for (const auto& candidate : candidates)
+            {
+                if (candidate.table == nullptr || normaliseName (candidate.table->name) != normaliseName (requested))
+                    continue;
+
+                if (candidate.supported)
+                    return { candidate.table, juce::String (candidate.table->name) + " (forced)" };
+
+                refusal = "not supported by this CPU";
+            }
+        }
+
+        for (const auto& candidate : candidates)
+        {
+            if (candidate.table == nullptr || ! candidate.supported)
+                continue;
+
+            Selection selection { candidate.table, candidate.table->name };
+
+            if (refusal.isNotEmpty())
+                selection.description << " (GAINMETER_KERNELS=" << requested << " " << refusal << ")";
+
+            return selection;
+        }
+
+        jassertfalse; // The baseline is always supported
+        return { getBaselineMeterKernels(), getBaselineMeterKernels()->name };
+    }
+
+    const Selection& getSelection()
+    {
+        static const Selection selection = selectKernels();
+        return selection;
+    }
+}
+
+//==============================================================================
+const MeterKernels::Table& MeterKernels::getActive() noexcept
+{
+    return *getSelection().table;
+}
+
+juce::String MeterKernels::getDescription()
+{
+    return getSelection().description;
+}
@@ -0,0 +1,106 @@
+/*
+    MeterKernels.h
+
+    Runtime-dispatched inner loops for the gain pass and the meters.
+
+    The same kernel source is compiled once per instruction set (the
+    baseline SSE2/NEON build plus AVX2 and AVX-512 on x86-64). The best
+    variant the CPU supports is picked once, when the first processor is
+    created, and called through a table of function pointers.
+
+    Set GAINMETER_KERNELS to scalar, sse2, neon, avx2 or avx512 before
+    starting the host to force a variant for benchmarking. Variants that
+    are missing from the build or not supported by the CPU are refused.
+    Every variant is checked against a scalar reference by the
+    GainMeterKernelTest ctest target, not at plugin load.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "LevelStatistics.h"
+
+//==============================================================================
+/**
+ * Kernel table selection and the types the kernels share with their callers.
+ *
+ * Kernels are real-time safe; selection happens off the audio thread.
+ */
+class MeterKernels
+{
+public:
+    // The types below cross into the per-instruction-set kernel files, so
+    // they have no member initialisers: a trivial constructor is never
+    // emitted as a function an AVX translation unit could contribute (see
+    // MeterKernelsImpl.h). Value-initialise them with {}.
+
+    /** Transposed direct form II biquad with double-precision state (K-weighting stages). */
+    struct Biquad
+    {
+        double b0, b1, b2, a1, a2;
+        double z1, z2;
+    };
+
+    /** Stereo channel matrix: left' = m00 * L + m01 * R, right' = m10 * L + m11 * R. */
+    struct ChannelMatrix
+    {
+        float m00, m01, m10, m11;
+    };
+
+    /** Post-gain mid and side peaks from the mid/side kernel. */
+    struct MidSideResult
+    {
+        float midPeak;
+        float sidePeak;
+    };
+
+    /** One compiled variant of every kernel. */
+    struct Table
+    {
+        const char* name;
+
+        /**
+         * Multiplies by a gain ramp (or constantGain when gains is nullptr) and
+         * returns peak and clip count, adding to the running sum and sum of
+         * squares and each output sample to its quarter-octave bin of a
+         * LevelStatistics histogram, all in one pass.
+         */
+        LevelStatistics::BlockResult (*applyGainAndMeasure) (float* data, const float* gains, float constantGain,
+                                                             int numSamples, double& sum, double& sumSquares,
+                                                             juce::uint32* histogram) noexcept;
+
+        /** Gain multiply plus sample peak only (channels outside the statistics). */
+        float (*applyGainAndFindPeak) (float* data, const float* gains, float constantGain, int numSamples) noexcept;
+
+        /** Sample peak of a read-only channel (sidechain key detection). */
+        float (*findPeak) (const float* data, int numSamples) noexcept;
+
+        /**
+         * Mid/side encode, gain and decode in place: mid = (L + R) * midGain,
+         * side = (L - R) * sideGain, L = mid + side, R = mid - side. The gains
+         * include the 0.5 encode factor and any master gain. Ramps are used
+         * when midGains is not nullptr (sideGains must then be set too).
+         */
+        MidSideResult (*applyMidSideGain) (float* left, float* right, const float* midGains, const float* sideGains,
+                                           float midGain, float sideGain, int numSamples) noexcept;
+
+        /**
+         * Applies a 2x2 channel matrix in place, moving the coefficients linearly
+         * from start (exclusive) to end (inclusive) over the block. left and
+         * right may be the same channel for mono.
+         */
+        void (*applyChannelMatrix) (float* left, float* right, const ChannelMatrix& start,
+                                    const ChannelMatrix& end, int numSamples) noexcept;
+
+        /** Runs two cascaded biquads over a channel and returns the sum of squared output. */
+        double (*filterAndSumSquares) (const float* data, int numSamples, Biquad* stages) noexcept;
+    };
+
+    /** The selected variant (the first call makes the selection). */
+    static const Table& getActive() noexcept;
+
+    /** Selected variant name plus the reason when an override was refused, for display. */
+    static juce::String getDescription();
+};
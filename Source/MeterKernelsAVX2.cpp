@@ -0,0 +1,18 @@
+/*
+    MeterKernelsAVX2.cpp
+
+    AVX2 kernel variant. Built with AVX2 target flags (see CMakeLists.txt);
+    only called after MeterKernels has checked the CPU supports them.
+
+    Author: Divij Singh
+*/
+
+#include "MeterKernels.h"
+
+#if defined (__AVX2__)
+ #include "MeterKernelsImpl.h"
+
+ GAINMETER_DEFINE_KERNEL_TABLE (getAvx2MeterKernels, "AVX2")
+#else
+ const MeterKernels::Table* getAvx2MeterKernels() noexcept { return nullptr; }
+#endif
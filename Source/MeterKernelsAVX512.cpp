@@ -0,0 +1,18 @@
+/*
+    MeterKernelsAVX512.cpp
+
+    AVX-512 kernel variant. Built with AVX-512 target flags (see CMakeLists.txt);
+    only called after MeterKernels has checked the CPU supports them.
+
+    Author: Divij Singh
+*/
+
+#include "MeterKernels.h"
+
+#if defined (__AVX512F__)
+ #include "MeterKernelsImpl.h"
+
+ GAINMETER_DEFINE_KERNEL_TABLE (getAvx512MeterKernels, "AVX-512")
+#else
+ const MeterKernels::Table* getAvx512MeterKernels() noexcept { return nullptr; }
+#endif
@@ -0,0 +1,315 @@
+/*
+    MeterKernelsImpl.h
+
+    Kernel bodies shared by every instruction-set variant. Included only by
+    the MeterKernels*.cpp files, each of which is built with its own
+    target flags and exposes one MeterKernels::Table.
+
+    Everything here has internal linkage and calls nothing but the helpers
+    in this file: an inline JUCE or standard library function instantiated
+    in an AVX translation unit could be the copy the linker keeps for the
+    whole plugin, and would then fault on CPUs without AVX. For the same
+    reason the structs the kernels take and return (BlockResult, Biquad,
+    ChannelMatrix, MidSideResult) are trivial: member initialisers would
+    give them implicit constructors that unoptimised builds emit as shared
+    inline functions.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include "MeterKernels.h"
+#include <cstring>
+
+namespace
+{
+    /** Independent accumulator lanes - lets the compiler keep one SIMD register per sum. */
+    constexpr int numLanes = 8;
+
+    inline float magnitudeOf (float x) noexcept     { return x < 0.0f ? -x : x; }
+    inline float larger (float a, float b) noexcept { return a < b ? b : a; }
+
+    /**
+     * Quarter-octave LevelStatistics histogram bin of a sample. The top bits
+     * of |x| are (exponent << 2 | top two mantissa bits), i.e. a quarter-octave
+     * bin number. Zero and denormals land in bin 0. Branch-free so it
+     * vectorises inside the gain loop.
+     */
+    inline int histogramBin (float sample) noexcept
+    {
+        constexpr auto binOffset = (127 + LevelStatistics::lowestOctave) * LevelStatistics::binsPerOctave;
+        constexpr auto lastBin = LevelStatistics::numBins - 1;
+
+        juce::uint32 bits;
+        std::memcpy (&bits, &sample, sizeof (bits));
+
+        const auto index = (int) ((bits & 0x7fffffffu) >> 21) - binOffset;
+        return index < 0 ? 0 : (index > lastBin ? lastBin : index);
+    }
+
+    //==============================================================================
+    /**
+     * Gain multiply plus peak, sum, sum of squares, clip count and histogram.
+     * Written lane-wise without cross-iteration dependencies so the gain and
+     * bin computation vectorise; only the bin increments are scalar, taken
+     * from registers in the same pass.
+     */
+    template <bool useRamp>
+    LevelStatistics::BlockResult applyGainAndMeasureLanes (float* data, const float* gains, float constantGain,
+                                                           int numSamples, double& sum, double& sumSquares,
+                                                           juce::uint32* histogram) noexcept
+    {
+        float lanePeak[numLanes] {};
+        float laneSum[numLanes] {};
+        float laneSquares[numLanes] {};
+        int laneClipped[numLanes] {};
+
+        int i = 0;
+        for (; i + numLanes <= numSamples; i += numLanes)
+        {
+            int laneBin[numLanes];
+
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                const auto gain = useRamp ? gains[i + lane] : constantGain;
+                const auto sample = data[i + lane] * gain;
+                const auto magnitude = magnitudeOf (sample);
+
+                data[i + lane] = sample;
+                lanePeak[lane] = larger (lanePeak[lane], magnitude);
+                laneSum[lane] += sample;
+                laneSquares[lane] += sample * sample;
+                laneClipped[lane] += magnitude >= 1.0f ? 1 : 0;
+                laneBin[lane] = histogramBin (sample);
+            }
+
+            for (int lane = 0; lane < numLanes; ++lane)
+                ++histogram[laneBin[lane]];
+        }
+
+        // Remainder
+        for (int lane = 0; i < numSamples; ++i, ++lane)
+        {
+            const auto gain = useRamp ? gains[i] : constantGain;
+            const auto sample = data[i] * gain;
+            const auto magnitude = magnitudeOf (sample);
+
+            data[i] = sample;
+            lanePeak[lane] = larger (lanePeak[lane], magnitude);
+            laneSum[lane] += sample;
+            laneSquares[lane] += sample * sample;
+            laneClipped[lane] += magnitude >= 1.0f ? 1 : 0;
+            ++histogram[histogramBin (sample)];
+        }
+
+        LevelStatistics::BlockResult result {};
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            result.peak = larger (result.peak, lanePeak[lane]);
+            result.numClipped += laneClipped[lane];
+            sum += laneSum[lane];
+            sumSquares += laneSquares[lane];
+        }
+
+        return result;
+    }
+
+    LevelStatistics::BlockResult applyGainAndMeasure (float* data, const float* gains, float constantGain,
+                                                      int numSamples, double& sum, double& sumSquares,
+                                                      juce::uint32* histogram) noexcept
+    {
+        return gains != nullptr
+                 ? applyGainAndMeasureLanes<true>  (data, gains, constantGain, numSamples, sum, sumSquares, histogram)
+                 : applyGainAndMeasureLanes<false> (data, gains, constantGain, numSamples, sum, sumSquares, histogram);
+    }
+
+    //==============================================================================
+    template <bool useRamp>
+    float applyGainAndFindPeakLanes (float* data, const float* gains, float constantGain, int numSamples) noexcept
+    {
+        float lanePeak[numLanes] {};
+
+        int i = 0;
+        for (; i + numLanes <= numSamples; i += numLanes)
+        {
+            for (int lane = 0; lane < numLanes; ++lane)
+            {
+                const auto sample = data[i + lane] * (useRamp ? gains[i + lane] : constantGain);
+                data[i + lane] = sample;
+                lanePeak[lane] = larger (lanePeak[lane], magnitudeOf (sample));
+            }
+        }
+
+        for (; i < numSamples; ++i)
+        {
+            const auto sample = data[i] * (useRamp ? gains[i] : constantGain);
+            data[i] = sample;
+            lanePeak[0] = larger (lanePeak[0], magnitudeOf (sample));
+        }
+
+        float peak = 0.0f;
+        for (int lane = 0; lane < numLanes; ++lane)
+            peak = larger (peak, lanePeak[lane]);
+
+        return peak;
+    }
+
+    float applyGainAndFindPeak (float* data, const float* gains, float constantGain, int numSamples) noexcept
+    {
+        return gains != nullptr ? applyGainAndFindPeakLanes<true>  (data, gains, constantGain, numSamples)
+                                : applyGainAndFindPeakLanes<false> (data, gains, constantGain, numSamples);
+    }
+
+    float findPeak (const float* data, int numSamples) noexcept
+    {
+        float lanePeak[numLanes] {};
+
+        int i = 0;
+        for (; i + numLanes <= numSamples; i += numLanes)
+            for (int lane = 0; lane < numLanes; ++lane)
+                lanePeak[lane] = larger (lanePeak[lane], magnitudeOf (data[i + lane]));
+
+        for (; i < numSamples; ++i)
+            lanePeak[0] = larger (lanePeak[0], magnitudeOf (data[i]));
+
+        float peak = 0.0f;
+        for (int lane = 0; lane < numLanes; ++lane)
+            peak = larger (peak, lanePeak[lane]);
+
+        return peak;
+    }
+
+    //==============================================================================
+    template <bool useRamp>
+    MeterKernels::MidSideResult applyMidSideGainLanes (float* left, float* right, const float* midGains,
+                                                       const float* sideGains, float midGain, float sideGain,
+                                                       int numSamples) noexcept
+    {
+        float laneMid[numLanes] {};
+        float laneSide[numLanes] {};
+
+        // One add/sub pair to encode and one to decode around the two multiplies
+        auto processSample = [&] (int i, int lane)
+        {
+            const auto l = left[i];
+            const auto r = right[i];
+            const auto mid = (l + r) * (useRamp ? midGains[i] : midGain);
+            const auto side = (l - r) * (useRamp ? sideGains[i] : sideGain);
+
+            left[i] = mid + side;
+            right[i] = mid - side;
+            laneMid[lane] = larger (laneMid[lane], magnitudeOf (mid));
+            laneSide[lane] = larger (laneSide[lane], magnitudeOf (side));
+        };
+
+        int i = 0;
+        for (; i + numLanes <= numSamples; i += numLanes)
+            for (int lane = 0; lane < numLanes; ++lane)
+                processSample (i + lane, lane);
+
+        for (; i < numSamples; ++i)
+            processSample (i, 0);
+
+        MeterKernels::MidSideResult result {};
+        for (int lane = 0; lane < numLanes; ++lane)
+        {
+            result.midPeak = larger (result.midPeak, laneMid[lane]);
+            result.sidePeak = larger (result.sidePeak, laneSide[lane]);
+        }
+
+        return result;
+    }
+
+    MeterKernels::MidSideResult applyMidSideGain (float* left, float* right, const float* midGains,
+                                                  const float* sideGains, float midGain, float sideGain,
+                                                  int numSamples) noexcept
+    {
+        return midGains != nullptr
+                 ? applyMidSideGainLanes<true>  (left, right, midGains, sideGains, midGain, sideGain, numSamples)
+                 : applyMidSideGainLanes<false> (left, right, midGains, sideGains, midGain, sideGain, numSamples);
+    }
+
+    //==============================================================================
+    template <bool interpolate>
+    void applyChannelMatrixLanes (float* left, float* right, const MeterKernels::ChannelMatrix& start,
+                                  const MeterKernels::ChannelMatrix& end, int numSamples) noexcept
+    {
+        // Coefficients in locals so stores through left/right cannot change them
+        const auto s00 = start.m00, s01 = start.m01, s10 = start.m10, s11 = start.m11;
+        const auto e00 = end.m00, e01 = end.m01, e10 = end.m10, e11 = end.m11;
+
+        const auto scale = numSamples > 0 ? 1.0f / (float) numSamples : 0.0f;
+        const auto d00 = (e00 - s00) * scale, d01 = (e01 - s01) * scale;
+        const auto d10 = (e10 - s10) * scale, d11 = (e11 - s11) * scale;
+
+        // Each coefficient is computed from the sample index rather than
+        // accumulated, so iterations are independent and the loop vectorises
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto position = (float) (i + 1);
+            const auto m00 = interpolate ? s00 + d00 * position : e00;
+            const auto m01 = interpolate ? s01 + d01 * position : e01;
+            const auto m10 = interpolate ? s10 + d10 * position : e10;
+            const auto m11 = interpolate ? s11 + d11 * position : e11;
+
+            const auto l = left[i];
+            const auto r = right[i];
+            left[i] = m00 * l + m01 * r;
+            right[i] = m10 * l + m11 * r;
+        }
+    }
+
+    void applyChannelMatrix (float* left, float* right, const MeterKernels::ChannelMatrix& start,
+                             const MeterKernels::ChannelMatrix& end, int numSamples) noexcept
+    {
+        const auto isConstant = start.m00 == end.m00 && start.m01 == end.m01
+                             && start.m10 == end.m10 && start.m11 == end.m11;
+
+        if (isConstant)
+            applyChannelMatrixLanes<false> (left, right, start, end, numSamples);
+        else
+            applyChannelMatrixLanes<true> (left, right, start, end, numSamples);
+    }
+
+    //==============================================================================
+    double filterAndSumSquares (const float* data, int numSamples, MeterKernels::Biquad* stages) noexcept
+    {
+        // The recursion is serial; wider variants gain from FMA and keeping
+        // both stages' state in registers for the whole block
+        auto first = stages[0];
+        auto second = stages[1];
+        double sumSquares = 0.0;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto x = (double) data[i];
+
+            const auto y1 = first.b0 * x + first.z1;
+            first.z1 = first.b1 * x - first.a1 * y1 + first.z2;
+            first.z2 = first.b2 * x - first.a2 * y1;
+
+            const auto y2 = second.b0 * y1 + second.z1;
+            second.z1 = second.b1 * y1 - second.a1 * y2 + second.z2;
+            second.z2 = second.b2 * y1 - second.a2 * y2;
+
+            sumSquares += y2 * y2;
+        }
+
+        stages[0] = first;
+        stages[1] = second;
+        return sumSquares;
+    }
+}
+
+/** Defines a function returning this translation unit's kernel table. */
+#define GAINMETER_DEFINE_KERNEL_TABLE(functionName, variantName)                          \
+    const MeterKernels::Table* functionName() noexcept                                    \
+    {                                                                                     \
+        static const MeterKernels::Table table { variantName, applyGainAndMeasure,        \
+                                                 applyGainAndFindPeak,                    \
+                                                 findPeak, applyMidSideGain,              \
+                                                 applyChannelMatrix,                      \
+                                                 filterAndSumSquares };                   \
+        return &table;                                                                    \
+    }
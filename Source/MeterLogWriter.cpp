@@ -0,0 +1,244 @@
+/*
+    MeterLogWriter.cpp
+
+    Implementation of the background meter-log writer.
+
+    Author: Divij Singh
+*/
+
+#include "MeterLogWriter.h"
+
+namespace
+{
+    juce::String formatDb (float linear)
+    {
+        return juce::String (juce::Decibels::gainToDecibels (linear, -100.0f), 2);
+    }
+
+    juce::String formatTimestamp (juce::Time time)
+    {
+        // ISO 8601 with milliseconds and local offset
+        return time.toISO8601 (true);
+    }
+}
+
+//==============================================================================
+// Lifecycle
+
+MeterLogWriter::MeterLogWriter()
+    : juce::Thread ("GainMeter Log Writer")
+{
+}
+
+MeterLogWriter::~MeterLogWriter()
+{
+    stop();
+}
+
+void MeterLogWriter::prepare (double newSampleRate)
+{
+    sampleRate.store (newSampleRate);
+    samplesPerRecord = juce::jmax (1, juce::roundToInt (newSampleRate * 0.1));
+    samplesInRecord = 0;
+    pending = {};
+}
+
+bool MeterLogWriter::start (const juce::File& newDirectory, Format newFormat, const juce::String& newPrefix)
+{
+    stop();
+
+    directory = newDirectory;
+    format = newFormat;
+    filePrefix = newPrefix;
+    fileIndex = 0;
+    sessionStartSample = -1;
+
+    if (! directory.createDirectory() || ! openNextFile())
+        return false;
+
+    // Records queued by an earlier session belong to its file, not this one
+    fifo.finishedRead (fifo.getNumReady());
+    droppedRecords.store (0);
+
+    active.store (true);
+    startThread();
+    return true;
+}
+
+void MeterLogWriter::stop()
+{
+    if (! active.exchange (false) && ! isThreadRunning())
+        return;
+
+    // The writer drains whatever is left before it exits
+    signalThreadShouldExit();
+    notify();
+    stopThread (5000);
+
+    stream.reset();
+
+    const juce::ScopedLock lock (fileLock);
+    currentFile = juce::File();
+}
+
+juce::File MeterLogWriter::getCurrentFile() const
+{
+    const juce::ScopedLock lock (fileLock);
+    return currentFile;
+}
+
+//==============================================================================
+// Audio Thread
+
+void MeterLogWriter::pushBlock (int numSamples, float peakLinear, float truePeakLinear, int numClipped,
+                                float momentaryLufs, float shortTermLufs) noexcept
+{
+    samplesProcessed += numSamples;
+
+    if (! active.load (std::memory_order_relaxed))
+        return;
+
+    pending.peakLinear = juce::jmax (pending.peakLinear, peakLinear);
+    pending.truePeakLinear = juce::jmax (pending.truePeakLinear, truePeakLinear);
+    pending.numClipped += numClipped;
+    samplesInRecord += numSamples;
+
+    if (samplesInRecord < samplesPerRecord)
+        return;
+
+    pending.sampleIndex = samplesProcessed;
+
+    // Wall-clock stamp taken when the audio ran, so transport stops, host
+    // suspends and offline renders cannot shift it (a clock read, no lock)
+    pending.wallClockMs = juce::Time::currentTimeMillis();
+    pending.momentaryLufs = momentaryLufs;
+    pending.shortTermLufs = shortTermLufs;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+    if (size1 + size2 > 0)
+    {
+        records[(size_t) (size1 > 0 ? start1 : start2)] = pending;
+        fifo.finishedWrite (1);
+    }
+    else
+    {
+        droppedRecords.fetch_add (1, std::memory_order_relaxed);
+    }
+
+    pending = {};
+    samplesInRecord = 0;
+}
+
+//==============================================================================
+// Writer Thread
+
+void MeterLogWriter::run()
+{
+    for (;;)
+    {
+        const auto exiting = threadShouldExit();
+
+        int start1, size1, start2, size2;
+        fifo.prepareToRead (fifo.getNumReady(), start1, size1, start2, size2);
+
+        writeRecords (records.data() + start1, size1);
+        writeRecords (records.data() + start2, size2);
+        fifo.finishedRead (size1 + size2);
+
+        if (stream != nullptr && size1 + size2 > 0)
+            stream->flush();
+
+        // One last pass after the exit request so nothing queued is lost
+        if (exiting)
+            break;
+
+        wait (writeIntervalMs);
+    }
+}
+
+bool MeterLogWriter::openNextFile()
+{
+    stream.reset();
+
+    const auto name = filePrefix + "-" + juce::Time::getCurrentTime().formatted ("%Y%m%d-%H%M%S")
+                    + "-" + juce::String (fileIndex++).paddedLeft ('0', 3)
+                    + (format == Format::csv ? ".csv" : ".jsonl");
+
+    auto file = directory.getChildFile (name);
+    auto newStream = std::make_unique<juce::FileOutputStream> (file);
+
+    if (! newStream->openedOk())
+        return false;
+
+    if (format == Format::csv)
+        *newStream << "timestamp,elapsed_s,momentary_lufs,short_term_lufs,peak_dbfs,true_peak_dbtp,clipped_samples\n";
+
+    stream = std::move (newStream);
+    fileOpenedAt = juce::Time::getCurrentTime();
+
+    const juce::ScopedLock lock (fileLock);
+    currentFile = file;
+    return true;
+}
+
+void MeterLogWriter::writeRecords (const Record* batch, int numRecords)
+{
+    if (numRecords <= 0)
+        return;
+
+    // Rotate before the batch so a file never ends mid-batch
+    const auto age = (juce::Time::getCurrentTime() - fileOpenedAt).inSeconds();
+    if (stream == nullptr || stream->getPosition() >= maxFileBytes || age >= maxFileSeconds)
+        if (! openNextFile())
+            return; // Disk trouble: drop this batch and retry with the next one
+
+    const auto rate = sampleRate.load();
+
+    if (sessionStartSample < 0)
+        sessionStartSample = batch[0].sampleIndex;
+
+    // Report gaps caused by a stalled writer
+    if (auto dropped = droppedRecords.exchange (0); dropped > 0)
+    {
+        if (format == Format::csv)
+            *stream << "# dropped " << (int) dropped << " records\n";
+        else
+            *stream << "{\"dropped_records\":" << (int) dropped << "}\n";
+    }
+
+    juce::String text;
+    text.preallocateBytes ((size_t) numRecords * 128);
+
+    for (int i = 0; i < numRecords; ++i)
+    {
+        const auto& record = batch[i];
+        // timestamp is wall-clock time; elapsed_s is processed audio time only
+        const auto elapsed = (double) (record.sampleIndex - sessionStartSample) / rate;
+        const auto timestamp = formatTimestamp (juce::Time (record.wallClockMs));
+
+        if (format == Format::csv)
+        {
+            text << timestamp << ","
+                 << juce::String (elapsed, 1) << ","
+                 << juce::String (record.momentaryLufs, 2) << ","
+                 << juce::String (record.shortTermLufs, 2) << ","
+                 << formatDb (record.peakLinear) << ","
+                 << formatDb (record.truePeakLinear) << ","
+                 << record.numClipped << "\n";
+        }
+        else
+        {
+            text << "{\"timestamp\":\"" << timestamp << "\""
+                 << ",\"elapsed_s\":" << juce::String (elapsed, 1)
+                 << ",\"momentary_lufs\":" << juce::String (record.momentaryLufs, 2)
+                 << ",\"short_term_lufs\":" << juce::String (record.shortTermLufs, 2)
+                 << ",\"peak_dbfs\":" << formatDb (record.peakLinear)
+                 << ",\"true_peak_dbtp\":" << formatDb (record.truePeakLinear)
+                 << ",\"clipped_samples\":" << record.numClipped << "}\n";
+        }
+    }
+
+    stream->writeText (text, false, false, nullptr);
+}
@@ -0,0 +1,138 @@
+/*
+    MeterLogWriter.h
+
+    Background writer for loudness compliance logs.
+
+    The audio thread condenses meter readings into one record per 100 ms,
+    stamped with the wall-clock time the interval was processed, and
+    pushes them through a lock-free FIFO. A background thread batches
+    the records, formats them as CSV or JSON Lines and appends them to a
+    log file, rotating to a new file by size and age. A slow disk only
+    ever delays the writer thread; when the FIFO fills, records are
+    counted as dropped and the gap is noted in the log.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+
+//==============================================================================
+/**
+ * Streams meter snapshots to rotating log files.
+ *
+ * Thread roles:
+ * - Audio thread: prepare() (from prepareToPlay), pushBlock()
+ * - Message thread: start(), stop(), isActive(), getCurrentFile()
+ * - Writer thread: everything else
+ */
+class MeterLogWriter : private juce::Thread
+{
+public:
+    enum class Format
+    {
+        csv,        // Header row plus one row per record
+        jsonLines   // One JSON object per line
+    };
+
+    MeterLogWriter();
+    ~MeterLogWriter() override;
+
+    /** Stores the sample rate and resets the record interval (not real-time safe). */
+    void prepare (double sampleRate);
+
+    /**
+     * Accumulates one block of meter readings and queues a record every
+     * 100 ms (audio thread, wait-free). Does nothing while logging is off.
+     *
+     * @param numSamples    Block length
+     * @param peakLinear    Sample peak of the block
+     * @param truePeakLinear True peak of the block
+     * @param numClipped    Samples at or above full scale in the block
+     * @param momentaryLufs Current momentary loudness
+     * @param shortTermLufs Current short-term loudness
+     */
+    void pushBlock (int numSamples, float peakLinear, float truePeakLinear, int numClipped,
+                    float momentaryLufs, float shortTermLufs) noexcept;
+
+    /**
+     * Starts logging into a directory (message thread).
+     * @param directory Created if missing
+     * @param format    File format for this session
+     * @param filePrefix Start of every file name, e.g. "GainMeter-1"
+     * @return false if the first log file could not be opened
+     */
+    bool start (const juce::File& directory, Format format, const juce::String& filePrefix);
+
+    /** Flushes outstanding records and closes the file (message thread). */
+    void stop();
+
+    /** True while records are being written. */
+    bool isActive() const noexcept { return active.load(); }
+
+    /** File currently written to (message thread, for display). */
+    juce::File getCurrentFile() const;
+
+    /** Rotation limits. */
+    static constexpr juce::int64 maxFileBytes = 16 * 1024 * 1024;
+    static constexpr double maxFileSeconds = 60.0 * 60.0;
+
+private:
+    /** One 100 ms summary. */
+    struct Record
+    {
+        juce::int64 sampleIndex = 0;    // Audio-thread sample counter at the end of the interval
+        juce::int64 wallClockMs = 0;    // Wall-clock time the interval ended, for the timestamp
+        float momentaryLufs = -70.0f;
+        float shortTermLufs = -70.0f;
+        float peakLinear = 0.0f;
+        float truePeakLinear = 0.0f;
+        int numClipped = 0;
+    };
+
+    /** Batches and writes records until asked to stop. */
+    void run() override;
+
+    /** Formats and appends a batch; rotates first if needed. */
+    void writeRecords (const Record* records, int numRecords);
+
+    /** Closes the current file and opens the next one with a header. */
+    bool openNextFile();
+
+    //==============================================================================
+    // Audio thread
+    std::atomic<bool> active { false };
+    std::atomic<double> sampleRate { 44100.0 };
+    int samplesPerRecord = 4410;
+    Record pending;
+    int samplesInRecord = 0;
+    juce::int64 samplesProcessed = 0;
+    std::atomic<juce::uint32> droppedRecords { 0 };
+
+    // Audio -> writer FIFO (~100 s of records, so the disk may stall that long)
+    static constexpr int fifoSize = 1024;
+    juce::AbstractFifo fifo { fifoSize };
+    std::array<Record, fifoSize> records {};
+
+    //==============================================================================
+    // Writer thread
+    juce::File directory;
+    juce::String filePrefix;
+    Format format = Format::csv;
+    std::unique_ptr<juce::FileOutputStream> stream;
+    juce::Time fileOpenedAt;
+    int fileIndex = 0;
+
+    /** Sample counter of the first record; elapsed_s counts processed audio from here. */
+    juce::int64 sessionStartSample = -1;
+
+    mutable juce::CriticalSection fileLock;     // Guards currentFile for the UI
+    juce::File currentFile;
+
+    /** How long the writer sleeps between batches. */
+    static constexpr int writeIntervalMs = 250;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MeterLogWriter)
+};
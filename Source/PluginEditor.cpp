@@ -17,7 +17,11 @@
 // Editor Constructor - Complete UI Setup
 
 GainMeterAudioProcessorEditor::GainMeterAudioProcessorEditor (GainMeterAudioProcessor& p)
-    : AudioProcessorEditor (&p), audioProcessor (p)
+    : AudioProcessorEditor (&p),
+     #if JucePlugin_Enable_ARA
+      AudioProcessorEditorARAExtension (&p),
+     #endif
+      audioProcessor (p)
 {
     //==============================================================================
     // Gain Slider Configuration
@@ -66,17 +70,98 @@ GainMeterAudioProcessorEditor::GainMeterAudioProcessorEditor (GainMeterAudioProc
     peakMeter = std::make_unique<PeakMeter>(audioProcessor);
     addAndMakeVisible(*peakMeter);
     
+    //==============================================================================
+    // Mid/Side Controls
+
+    midSideButton.setToggleState(audioProcessor.midSideParameter->get(), juce::dontSendNotification);
+    midSideButton.onClick = [this] { *audioProcessor.midSideParameter = midSideButton.getToggleState(); };
+    addAndMakeVisible(midSideButton);
+
+    // Same range and units as the main gain slider
+    auto setUpMidSideSlider = [this] (juce::Slider& slider, juce::Label& label, const juce::String& name, float value)
+    {
+        slider.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
+        slider.setRange(-60.0, 12.0, 0.1);
+        slider.setValue(value);
+        slider.setDoubleClickReturnValue(true, 0.0);
+        slider.setTextBoxStyle(juce::Slider::TextBoxBelow, false, 60, 16);
+        slider.setTextValueSuffix(" dB");
+        slider.addListener(this);
+        addAndMakeVisible(slider);
+
+        label.setText(name, juce::dontSendNotification);
+        label.setJustificationType(juce::Justification::centred);
+        addAndMakeVisible(label);
+    };
+
+    setUpMidSideSlider(midSlider, midLabel, "Mid", audioProcessor.midGainParameter->get());
+    setUpMidSideSlider(sideSlider, sideLabel, "Side", audioProcessor.sideGainParameter->get());
+
+    midSideMeter = std::make_unique<MidSideMeter>(audioProcessor);
+    addAndMakeVisible(*midSideMeter);
+    
+    //==============================================================================
+    // Analysis Views Setup
+    
+    // Creating the displays starts background analysis; destroying them stops it
+    spectrumDisplay = std::make_unique<SpectrumDisplay>(audioProcessor.getSpectrumAnalyser());
+    spectrogramDisplay = std::make_unique<SpectrogramDisplay>(audioProcessor.getSpectrumAnalyser());
+    waveformDisplay = std::make_unique<WaveformHistoryDisplay>(audioProcessor.getWaveformHistory());
+    stereoDisplay = std::make_unique<StereoDisplay>(audioProcessor.getStereoAnalyser());
+    statisticsDisplay = std::make_unique<StatisticsDisplay>(audioProcessor);
+    timelineDisplay = std::make_unique<TimelineDisplay>(audioProcessor);
+    channelPanel = std::make_unique<ChannelUtilityPanel>(audioProcessor);
+    limiterPanel = std::make_unique<LimiterPanel>(audioProcessor);
+    sidechainPanel = std::make_unique<SidechainPanel>(audioProcessor);
+    linkGroupPanel = std::make_unique<LinkGroupPanel>(audioProcessor);
+    sessionOverview = std::make_unique<SessionOverview>(audioProcessor);
+    
+    // Tabs only reference the views - the editor keeps ownership
+    auto tabColour = juce::Colour(0xff2a2a2a);
+    analysisTabs.addTab("Spectrum", tabColour, spectrumDisplay.get(), false);
+    analysisTabs.addTab("Spectrogram", tabColour, spectrogramDisplay.get(), false);
+    analysisTabs.addTab("History", tabColour, waveformDisplay.get(), false);
+    analysisTabs.addTab("Stereo", tabColour, stereoDisplay.get(), false);
+    analysisTabs.addTab("Statistics", tabColour, statisticsDisplay.get(), false);
+    analysisTabs.addTab("Timeline", tabColour, timelineDisplay.get(), false);
+    analysisTabs.addTab("Channels", tabColour, channelPanel.get(), false);
+    analysisTabs.addTab("Limiter", tabColour, limiterPanel.get(), false);
+    analysisTabs.addTab("Sidechain", tabColour, sidechainPanel.get(), false);
+    analysisTabs.addTab("Link", tabColour, linkGroupPanel.get(), false);
+    analysisTabs.addTab("Session", tabColour, sessionOverview.get(), false);
+
+   #if JucePlugin_Enable_ARA
+    // Clip analysis needs the document controller behind the ARA editor view
+    if (auto* editorView = getARAEditorView())
+    {
+        if (auto* controller = juce::ARADocumentControllerSpecialisation::getSpecialisedDocumentController<GainMeterDocumentController>(editorView->getDocumentController()))
+        {
+            clipAnalysisDisplay = std::make_unique<ClipAnalysisDisplay>(*controller);
+            analysisTabs.addTab("Clips", tabColour, clipAnalysisDisplay.get(), false);
+
+            clipGainDisplay = std::make_unique<ClipGainDisplay>(*controller);
+            analysisTabs.addTab("Clip Gain", tabColour, clipGainDisplay.get(), false);
+        }
+    }
+   #endif
+    addAndMakeVisible(analysisTabs);
+    
     //==============================================================================
     // Window Configuration
     
     // Set reasonable default size for plugin window
-    // Dimensions chosen to accommodate controls with comfortable spacing
-    setSize (300, 400);
+    // Dimensions chosen to accommodate controls with comfortable spacing,
+    // with the analyser to the right of the gain/meter column
+    setSize (800, 500);
 }
 
 GainMeterAudioProcessorEditor::~GainMeterAudioProcessorEditor()
 {
-    // std::unique_ptr handles automatic cleanup of peakMeter
+    // Detach views from the tabs before the unique_ptrs below destroy them
+    analysisTabs.clearTabs();
+    
+    // std::unique_ptr handles automatic cleanup of peakMeter and the analysis
+    // views (the last one to go takes the analyser off the shared pool)
     // JUCE handles cleanup of slider and label components
 }
 
@@ -108,9 +193,9 @@ void GainMeterAudioProcessorEditor::paint (juce::Graphics& g)
     g.setColour(juce::Colours::white);
     g.setFont(juce::Font(20.0f, juce::Font::bold));
     
-    // Center title in reserved header area
+    // Center title above the gain/meter column
     g.drawText("Gain Meter", 
-              getLocalBounds().removeFromTop(40),
+              getLocalBounds().removeFromLeft(300).removeFromTop(40),
               juce::Justification::centred, 
               true);
 }
@@ -134,9 +219,28 @@ void GainMeterAudioProcessorEditor::resized()
     //==============================================================================
     // Horizontal Split Layout
     
-    // Divide available space between gain control and meter display
-    auto gainSection = bounds.removeFromLeft(bounds.getWidth() / 2);
-    auto meterSection = bounds; // Remaining area for meter
+    // Fixed-width gain/meter column on the left, analyser fills the rest
+    auto controlSection = bounds.removeFromLeft(260);
+    auto analysisSection = bounds;
+
+    //==============================================================================
+    // Position Mid/Side Strip
+
+    // Switch and meters on top, the two knobs side by side below
+    auto midSideSection = controlSection.removeFromBottom(120).reduced(10, 0);
+    auto midSideHeader = midSideSection.removeFromTop(30);
+    midSideButton.setBounds(midSideHeader.removeFromLeft(90));
+    midSideMeter->setBounds(midSideHeader.reduced(0, 2));
+
+    auto midSection = midSideSection.removeFromLeft(midSideSection.getWidth() / 2);
+    midLabel.setBounds(midSection.removeFromTop(16));
+    midSlider.setBounds(midSection);
+    sideLabel.setBounds(midSideSection.removeFromTop(16));
+    sideSlider.setBounds(midSideSection);
+    
+    // Divide control column between gain control and meter display
+    auto gainSection = controlSection.removeFromLeft(controlSection.getWidth() / 2);
+    auto meterSection = controlSection; // Remaining area for meter
     
     //==============================================================================
     // Position Gain Controls
@@ -152,6 +256,11 @@ void GainMeterAudioProcessorEditor::resized()
     
     // Meter takes remaining space with margins
     peakMeter->setBounds(meterSection.reduced(10));
+    
+    //==============================================================================
+    // Position Analyser
+    
+    analysisTabs.setBounds(analysisSection.reduced(10));
 }
 
 //==============================================================================
@@ -180,6 +289,15 @@ void GainMeterAudioProcessorEditor::sliderValueChanged(juce::Slider* slider)
          */
     }
     
+    else if (slider == &midSlider)
+    {
+        *audioProcessor.midGainParameter = static_cast<float>(midSlider.getValue());
+    }
+    else if (slider == &sideSlider)
+    {
+        *audioProcessor.sideGainParameter = static_cast<float>(sideSlider.getValue());
+    }
+
     // Extensible pattern for additional controls:
     // else if (slider == &otherSlider) { ... }
 }
\ No newline at end of file
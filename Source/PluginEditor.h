@@ -16,6 +16,19 @@
 #include <juce_gui_basics/juce_gui_basics.h>
 #include <juce_core/juce_core.h>
 #include "PluginProcessor.h"
+#include "SpectrumDisplay.h"
+#include "SpectrogramDisplay.h"
+#include "WaveformHistoryDisplay.h"
+#include "StereoDisplay.h"
+#include "StatisticsDisplay.h"
+#include "TimelineDisplay.h"
+#include "ChannelUtilityPanel.h"
+#include "LimiterPanel.h"
+#include "SidechainPanel.h"
+#include "LinkGroupPanel.h"
+#include "SessionOverview.h"
+#include "ClipAnalysisDisplay.h"
+#include "ClipGainDisplay.h"
 
 //==============================================================================
 /**
@@ -25,6 +38,7 @@
  * - 30 FPS update rate for smooth animation
  * - Color-coded level indication (green/yellow/red)
  * - dB scale with numeric readout
+ * - Peak-hold marker and clip counter (click the meter to reset both)
  * - Thread-safe communication with audio processor
  */
 class PeakMeter : public juce::Component, private juce::Timer
@@ -82,6 +96,29 @@ public:
             g.setColour(meterColor);
             g.fillRect(meterRect);
         }
+
+        // Draw peak-hold marker as a thin line at the highest level seen
+        auto holdDb = audioProcessor.getPeakHoldLevel();
+        auto normalizedHold = juce::jlimit(0.0f, 1.0f, juce::jmap(holdDb, -60.0f, 12.0f, 0.0f, 1.0f));
+        if (normalizedHold > 0.0f)
+        {
+            auto holdBounds = getLocalBounds().reduced(4);
+            auto holdY = holdBounds.getBottom() - static_cast<int>(holdBounds.getHeight() * normalizedHold);
+            g.setColour(juce::Colours::white);
+            g.fillRect(holdBounds.getX(), holdY, holdBounds.getWidth(), 2);
+        }
+
+        // Draw clip indicator at the top once anything has hit full scale
+        auto clips = audioProcessor.getClipCount();
+        if (clips > 0)
+        {
+            auto clipBounds = getLocalBounds().reduced(4).removeFromTop(20);
+            g.setColour(juce::Colours::red);
+            g.fillRect(clipBounds);
+            g.setColour(juce::Colours::white);
+            g.setFont(12.0f);
+            g.drawText("CLIP " + juce::String(clips), clipBounds, juce::Justification::centred, true);
+        }
         
         // Draw numeric level display
         g.setColour(juce::Colours::white);
@@ -91,6 +128,16 @@ public:
                   juce::Justification::centred, true);
     }
     
+    /**
+     * Clicking the meter resets the peak hold and clip counter.
+     * Resets travel to the audio thread through the processor's command queue.
+     */
+    void mouseDown(const juce::MouseEvent&) override
+    {
+        audioProcessor.postCommand({ ProcessorCommand::Type::resetPeakHold });
+        audioProcessor.postCommand({ ProcessorCommand::Type::clearClipCounter });
+    }
+    
 private:
     GainMeterAudioProcessor& audioProcessor;
     
@@ -104,6 +151,58 @@ private:
     }
 };
 
+//==============================================================================
+/**
+ * Post-gain mid and side peak meters for mid/side mode.
+ *
+ * Two horizontal bars on the same -60..+12 dB scale as the main meter,
+ * dimmed while mid/side mode is off.
+ */
+class MidSideMeter : public juce::Component, private juce::Timer
+{
+public:
+    explicit MidSideMeter(GainMeterAudioProcessor& processor) : audioProcessor(processor)
+    {
+        startTimerHz(30);
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        const auto active = audioProcessor.midSideParameter->get();
+        auto bounds = getLocalBounds();
+
+        auto drawBar = [&g, active] (juce::Rectangle<int> area, const juce::String& name, float levelDb)
+        {
+            g.setColour(juce::Colours::grey);
+            g.setFont(12.0f);
+            g.drawText(name, area.removeFromLeft(14), juce::Justification::centredLeft, false);
+
+            g.setColour(juce::Colours::black);
+            g.fillRect(area);
+
+            auto normalizedLevel = juce::jlimit(0.0f, 1.0f, juce::jmap(levelDb, -60.0f, 12.0f, 0.0f, 1.0f));
+            auto barWidth = static_cast<int>(area.getWidth() * normalizedLevel);
+            auto meterColor = levelDb < -12.0f ? juce::Colours::green
+                            : levelDb < -3.0f  ? juce::Colours::yellow
+                                               : juce::Colours::red;
+
+            g.setColour(active ? meterColor : meterColor.withAlpha(0.3f));
+            g.fillRect(area.removeFromLeft(barWidth));
+        };
+
+        drawBar(bounds.removeFromTop(getHeight() / 2).reduced(0, 2), "M", audioProcessor.getMidPeakLevel());
+        drawBar(bounds.reduced(0, 2), "S", audioProcessor.getSidePeakLevel());
+    }
+
+private:
+    GainMeterAudioProcessor& audioProcessor;
+
+    void timerCallback() override
+    {
+        repaint();
+    }
+};
+
 //==============================================================================
 /**
  * Main plugin editor window containing gain control and peak meter.
@@ -115,6 +214,9 @@ private:
  * - Professional visual styling
  */
 class GainMeterAudioProcessorEditor : public juce::AudioProcessorEditor,
+                                     #if JucePlugin_Enable_ARA
+                                      public juce::AudioProcessorEditorARAExtension,
+                                     #endif
                                       private juce::Slider::Listener
 {
 public:
@@ -173,6 +275,50 @@ private:
     /** Real-time peak level meter display */
     std::unique_ptr<PeakMeter> peakMeter;
 
+    /** Mid/side mode switch, mid and side gain knobs and their meters */
+    juce::ToggleButton midSideButton { "Mid/Side" };
+    juce::Slider midSlider, sideSlider;
+    juce::Label midLabel, sideLabel;
+    std::unique_ptr<MidSideMeter> midSideMeter;
+
+    /** Tabbed area hosting the analysis views */
+    juce::TabbedComponent analysisTabs { juce::TabbedButtonBar::TabsAtTop };
+
+    /** Post-gain spectrum analyser view (analysis runs while this exists) */
+    std::unique_ptr<SpectrumDisplay> spectrumDisplay;
+
+    /** Scrolling spectrogram fed by the same analyser */
+    std::unique_ptr<SpectrogramDisplay> spectrogramDisplay;
+
+    /** Zoomable waveform and level history lane */
+    std::unique_ptr<WaveformHistoryDisplay> waveformDisplay;
+
+    /** Goniometer and correlation meter */
+    std::unique_ptr<StereoDisplay> stereoDisplay;
+    std::unique_ptr<StatisticsDisplay> statisticsDisplay;
+    std::unique_ptr<TimelineDisplay> timelineDisplay;
+
+    /** Input trim, polarity, swap and balance controls */
+    std::unique_ptr<ChannelUtilityPanel> channelPanel;
+
+    /** True-peak limiter controls and gain-reduction meter */
+    std::unique_ptr<LimiterPanel> limiterPanel;
+
+    /** Sidechain key meter and ducking controls */
+    std::unique_ptr<SidechainPanel> sidechainPanel;
+
+    /** Link group picker and group gain */
+    std::unique_ptr<LinkGroupPanel> linkGroupPanel;
+
+    /** Meter bridge for every instance in the process */
+    std::unique_ptr<SessionOverview> sessionOverview;
+
+   #if JucePlugin_Enable_ARA
+    /** Whole-clip analysis, only when hosted through ARA. */
+    std::unique_ptr<ClipAnalysisDisplay> clipAnalysisDisplay;
+    std::unique_ptr<ClipGainDisplay> clipGainDisplay;
+   #endif
+
     //==============================================================================
     // Development Safety
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GainMeterAudioProcessorEditor)
@@ -13,6 +13,45 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+namespace
+{
+    /** Hands out process-unique instance numbers for the control socket. */
+    std::atomic<int> nextInstanceId { 1 };
+
+    /** Longest time a remote gain overrides the parameter before the parameter wins again. */
+    constexpr double remoteGainHoldSeconds = 0.5;
+
+    /** Upper end of the limiter lookahead parameter; sizes the limiter's buffers. */
+    constexpr float maxLimiterLookaheadMs = 10.0f;
+
+    /**
+     * Worst case the DSP arena is sized for, so hosts switching sample rate or
+     * buffer size only trigger coefficient updates. Faster rates still work but
+     * grow the arena once; larger blocks are processed in chunks of this size.
+     */
+    constexpr double maxPreparedSampleRate = 384000.0;
+    constexpr int maxPreparedBlockSize = 8192;
+
+   #if GAINMETER_CLAP
+    /**
+     * Main gain parameter as seen by the CLAP wrapper: declares monophonic
+     * modulation so hosts send CLAP_EVENT_PARAM_MOD offsets (in dB) for it.
+     */
+    class ModulatableGainParameter : public juce::AudioParameterFloat,
+                                     public clap_juce_extensions::clap_juce_parameter_capabilities
+    {
+    public:
+        using juce::AudioParameterFloat::AudioParameterFloat;
+
+        bool supportsMonophonicModulation() override { return true; }
+    };
+
+    using GainParameter = ModulatableGainParameter;
+   #else
+    using GainParameter = juce::AudioParameterFloat;
+   #endif
+}
+
 //==============================================================================
 // Constructor - Initialize plugin with default settings
 GainMeterAudioProcessor::GainMeterAudioProcessor()
@@ -21,24 +60,101 @@ GainMeterAudioProcessor::GainMeterAudioProcessor()
                      #if ! JucePlugin_IsMidiEffect
                       #if ! JucePlugin_IsSynth
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                       .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
                       #endif
                        .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
-                       )
+                       ),
+#else
+     :
 #endif
+       instanceId (nextInstanceId++)
 {
     // Create main gain parameter with professional audio range
     // -60dB provides effective silence, +12dB allows useful boost without extremes
-    addParameter(gainParameter = new juce::AudioParameterFloat(
+    addParameter(gainParameter = new GainParameter(
         "gain",                                                 // Parameter ID for automation
         "Gain",                                                 // Display name
         juce::NormalisableRange<float>(-60.0f, 12.0f, 0.1f),  // Min, max, step size
         0.0f                                                    // Default: unity gain (no change)
     ));
+
+    // Mid/side mode: independent gain for the sum and difference of a stereo pair
+    addParameter(midSideParameter = new juce::AudioParameterBool("midSide", "Mid/Side", false));
+    addParameter(midGainParameter = new juce::AudioParameterFloat(
+        "midGain", "Mid Gain", juce::NormalisableRange<float>(-60.0f, 12.0f, 0.1f), 0.0f));
+    addParameter(sideGainParameter = new juce::AudioParameterFloat(
+        "sideGain", "Side Gain", juce::NormalisableRange<float>(-60.0f, 12.0f, 0.1f), 0.0f));
+
+    // Input channel utilities, folded into one 2x2 matrix ahead of the gain stage
+    addParameter(trimLeftParameter = new juce::AudioParameterFloat(
+        "trimLeft", "Trim L", juce::NormalisableRange<float>(-24.0f, 24.0f, 0.1f), 0.0f));
+    addParameter(trimRightParameter = new juce::AudioParameterFloat(
+        "trimRight", "Trim R", juce::NormalisableRange<float>(-24.0f, 24.0f, 0.1f), 0.0f));
+    addParameter(invertLeftParameter = new juce::AudioParameterBool("invertLeft", "Invert L", false));
+    addParameter(invertRightParameter = new juce::AudioParameterBool("invertRight", "Invert R", false));
+    addParameter(swapChannelsParameter = new juce::AudioParameterBool("swapChannels", "Swap L/R", false));
+    addParameter(balanceParameter = new juce::AudioParameterFloat(
+        "balance", "Balance", juce::NormalisableRange<float>(-100.0f, 100.0f, 1.0f), 0.0f));
+    addParameter(panLawParameter = new juce::AudioParameterChoice(
+        "panLaw", "Pan Law", juce::StringArray { "0 dB", "-3 dB", "-6 dB" }, 0));
+
+    // True-peak safety limiter after the gain stage (off by default: it adds latency)
+    addParameter(limiterParameter = new juce::AudioParameterBool("limiter", "Limiter", false));
+    addParameter(limiterCeilingParameter = new juce::AudioParameterFloat(
+        "limiterCeiling", "Ceiling", juce::NormalisableRange<float>(-12.0f, 0.0f, 0.1f), -1.0f));
+    addParameter(limiterLookaheadParameter = new juce::AudioParameterFloat(
+        "limiterLookahead", "Lookahead", juce::NormalisableRange<float>(1.0f, maxLimiterLookaheadMs, 0.1f), 2.0f));
+    addParameter(limiterReleaseParameter = new juce::AudioParameterFloat(
+        "limiterRelease", "Release", juce::NormalisableRange<float>(10.0f, 1000.0f, 1.0f, 0.4f), 100.0f));
+
+    // Sidechain ducking of the main gain
+    addParameter(duckingParameter = new juce::AudioParameterBool("ducking", "Ducking", false));
+    addParameter(duckThresholdParameter = new juce::AudioParameterFloat(
+        "duckThreshold", "Duck Threshold", juce::NormalisableRange<float>(-60.0f, 0.0f, 0.1f), -30.0f));
+    addParameter(duckRangeParameter = new juce::AudioParameterFloat(
+        "duckRange", "Duck Range", juce::NormalisableRange<float>(0.0f, 40.0f, 0.1f), 12.0f));
+    addParameter(duckAttackParameter = new juce::AudioParameterFloat(
+        "duckAttack", "Duck Attack", juce::NormalisableRange<float>(1.0f, 200.0f, 0.1f, 0.4f), 10.0f));
+    addParameter(duckReleaseParameter = new juce::AudioParameterFloat(
+        "duckRelease", "Duck Release", juce::NormalisableRange<float>(20.0f, 2000.0f, 1.0f, 0.4f), 300.0f));
+
+    // Optional control socket for automated level-calibration rigs.
+    // One socket per instance: <dir>/gainmeter-<pid>-<instance>.sock
+    auto socketDirectory = juce::SystemStats::getEnvironmentVariable ("GAINMETER_CONTROL_SOCKET_DIR", {});
+    if (socketDirectory.isNotEmpty())
+    {
+        auto socketFile = juce::File (socketDirectory)
+                              .getChildFile ("gainmeter-" + juce::String (juce::Process::getProcessId())
+                                             + "-" + juce::String (instanceId) + ".sock");
+
+        controlServer = std::make_unique<ControlSocketServer> (*this, socketFile);
+
+        if (! controlServer->start())
+            controlServer.reset(); // Unsupported platform or unusable path - run without it
+    }
+
+    // Pick the DSP kernel variant now rather than on the first audio callback
+    MeterKernels::getActive();
+
+    // Appear in the session overview of every editor in the process
+    instanceRegistry->add(this);
+
+    // Drain audio-thread history data on the message thread
+    startTimerHz(30);
 }
 
 GainMeterAudioProcessor::~GainMeterAudioProcessor()
 {
+    // Leave the overview first; viewers hold the registry lock while reading us
+    instanceRegistry->remove(this);
+
+    // Stop the socket thread before any state it reads is destroyed
+    controlServer.reset();
+    linkGroups->leave(linkGroupSlot.exchange(LinkGroupRegistry::noGroup));
+    cancelPendingUpdate();
+    stopTimer();
+
     // JUCE handles parameter cleanup automatically
 }
 
@@ -121,12 +237,90 @@ void GainMeterAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBl
     
     // Set initial target to current parameter value
     gainSmoother.setTargetValue(juce::Decibels::decibelsToGain(gainParameter->get()));
+
+    // Mid/side gains have their own smoothing and start at their settled values
+    midSmoother.reset(sampleRate, 0.05);
+    sideSmoother.reset(sampleRate, 0.05);
+    midSmoother.setCurrentAndTargetValue(getMidSideTargetGain(*midGainParameter));
+    sideSmoother.setCurrentAndTargetValue(getMidSideTargetGain(*sideGainParameter));
+
+    // Channel matrix coefficients are smoothed per block over the same time
+    const auto matrix = computeChannelMatrix(getMainBusNumInputChannels() >= 2);
+    const float coefficients[] { matrix.m00, matrix.m01, matrix.m10, matrix.m11 };
+
+    for (size_t index = 0; index < matrixSmoothers.size(); ++index)
+    {
+        matrixSmoothers[index].reset(sampleRate, 0.05);
+        matrixSmoothers[index].setCurrentAndTargetValue(coefficients[index]);
+    }
+
+    //==============================================================================
+    // DSP arena: every rate- and block-size-dependent buffer in one aligned block,
+    // handed out in the order processBlock touches them. It is sized for the
+    // worst-case rate, block size and channel count rather than the current
+    // ones, so a later prepareToPlay reuses the same block without allocating.
+
+    // Scratch space for the per-sample gain ramp (larger host blocks are chunked)
+    const auto rampSize = maxPreparedBlockSize;
+    const auto arenaSampleRate = juce::jmax(sampleRate, maxPreparedSampleRate);
+    const auto maxLimiterLookahead = (int) std::ceil(maxLimiterLookaheadMs * 0.001 * arenaSampleRate);
+    const auto numLimiterChannels = TruePeakLimiter::maxChannels;
+
+    dspArena.prepare(3 * DspArena::getBytesFor<float>((size_t) rampSize)
+                     + TruePeakLimiter::getArenaBytes(maxLimiterLookahead, numLimiterChannels)
+                     + StereoAnalyser::getArenaBytes(arenaSampleRate));
+
+    gainRamp = dspArena.allocate<float>((size_t) rampSize);
+    midRamp = dspArena.allocate<float>((size_t) rampSize);
+    sideRamp = dspArena.allocate<float>((size_t) rampSize);
+    gainRampSize = rampSize;
+
+    // The limiter is sized for the longest lookahead, so later changes only
+    // need a command; the current setting is reported as latency right away
+    truePeakLimiter.prepare(sampleRate, maxLimiterLookahead, numLimiterChannels, dspArena);
+    limiterLookahead = getLimiterLookaheadTarget(sampleRate);
+    truePeakLimiter.setLookahead(juce::jmax(0, limiterLookahead));
+    reportedLimiterLookahead.store(limiterLookahead);
+    preparedSampleRate.store(sampleRate);
+    setLatencySamples(limiterLookahead < 0 ? 0 : truePeakLimiter.getLatencySamples());
+
+    stereoAnalyser.prepare(sampleRate, dspArena);
+    dspMemoryBytes.store(dspArena.getCapacity());
+
+    sidechainDucker.prepare(sampleRate);
+    spectrumAnalyser.prepare(sampleRate);
+    waveformHistory.prepare(sampleRate);
+    levelStatistics.prepare(sampleRate);
+    loudnessMeter.prepare(sampleRate);
+    truePeakDetector.reset();
+    timelineHistory.prepare(sampleRate);
+    meterLogWriter.prepare(sampleRate);
+
+    remoteGainHoldSamples = 0;
+    remoteGainHoldLength = static_cast<int>(sampleRate * remoteGainHoldSeconds);
+
+   #if JucePlugin_Enable_ARA
+    // Playback renderers open their clip readers here
+    prepareToPlayForARA(sampleRate, samplesPerBlock, getMainBusNumOutputChannels(), getProcessingPrecision());
+   #else
+    juce::ignoreUnused(samplesPerBlock);
+   #endif
 }
 
 void GainMeterAudioProcessor::releaseResources()
 {
-    // Simple plugin - no large allocations to clean up
-    // More complex plugins would free buffers, close files, etc.
+   #if JucePlugin_Enable_ARA
+    releaseResourcesForARA();
+   #endif
+
+    // Components drop their arena pointers and processBlock passes audio through
+    // untouched until the next prepareToPlay. The worst-case arena itself is kept:
+    // hosts release and prepare around every sample-rate change, and reusing the
+    // block is what keeps those changes allocation-free.
+    truePeakLimiter.releaseStorage();
+    stereoAnalyser.releaseStorage();
+    gainRamp = midRamp = sideRamp = nullptr;
+    gainRampSize = 0;
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -145,6 +339,14 @@ bool GainMeterAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts
    #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
         return false;
+
+    // The sidechain key may be mono, stereo or disconnected
+    if (layouts.inputBuses.size() > 1)
+    {
+        const auto key = layouts.getChannelSet(true, 1);
+        if (! key.isDisabled() && key != juce::AudioChannelSet::mono() && key != juce::AudioChannelSet::stereo())
+            return false;
+    }
    #endif
 
     return true;
@@ -160,44 +362,625 @@ void GainMeterAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, ju
     // Prevent denormalized numbers from causing CPU spikes
     juce::ScopedNoDenormals noDenormals;
     
-    auto totalNumInputChannels  = getTotalNumInputChannels();
+    // Main bus only; sidechain channels follow it in the buffer
+    auto totalNumInputChannels  = getMainBusNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
+    auto numSamples = buffer.getNumSamples();
+
     // Clear any unused output channels to prevent noise
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear (i, 0, buffer.getNumSamples());
+        buffer.clear (i, 0, numSamples);
+
+    // Called outside prepareToPlay/releaseResources: no DSP buffers to work with
+    if (gainRampSize == 0)
+        return;
+
+   #if JucePlugin_Enable_ARA
+    // Bound to ARA: the playback renderer replaces the input with the clip audio,
+    // which then goes through the gain and metering stage like any other signal.
+    // It only sees the main bus, so the sidechain key after it stays intact.
+    if (isBoundToARA())
+    {
+        auto mainBus = getBusBuffer(buffer, false, 0);
+        processBlockForARA(mainBus, isRealtime(), getPlayHead());
+    }
+   #endif
+
+    // Apply commands queued by other threads before reading any parameters
+    uiCommandQueue.drain ([this] (const ProcessorCommand& command) { applyCommand (command); });
+    remoteCommandQueue.drain ([this] (const ProcessorCommand& command) { applyCommand (command); });
+
+    // A recent remote gain wins until the parameter has caught up with it
+    auto gainDb = gainParameter->get();
+    if (remoteGainHoldSamples > 0)
+    {
+        if (std::abs(gainDb - remoteGainDb) < 0.05f)
+            remoteGainHoldSamples = 0;
+        else
+        {
+            gainDb = remoteGainDb;
+            remoteGainHoldSamples -= numSamples;
+        }
+    }
+
+    // Non-destructive host modulation (CLAP) rides on top of the parameter
+    if (gainModulationDb != 0.0f)
+        gainDb = juce::jlimit(gainParameter->range.start, gainParameter->range.end, gainDb + gainModulationDb);
+
+    // Link group offset: one atomic load from a slot that never moves
+    const auto linkSlot = linkGroupSlot.load(std::memory_order_relaxed);
+    if (linkSlot != LinkGroupRegistry::noGroup)
+        gainDb = juce::jlimit(gainParameter->range.start, gainParameter->range.end, gainDb + linkGroups->getOffset(linkSlot));
+
+    // Sidechain key: metered whenever connected, and ducks the gain when enabled.
+    // The ducking gain is part of the gain target, so it shares the smoothing.
+    auto duckingGain = 1.0f;
+    float keyPeak = 0.0f;
+
+    const auto* keyBus = getBus(true, 1);
+    const auto numKeyChannels = keyBus != nullptr && keyBus->isEnabled() ? juce::jmin(2, keyBus->getNumberOfChannels()) : 0;
+    const auto firstKeyChannel = totalNumInputChannels;
+
+    if (numKeyChannels > 0 && firstKeyChannel + numKeyChannels <= buffer.getNumChannels())
+    {
+        sidechainDucker.setParameters(duckThresholdParameter->get(), duckRangeParameter->get(),
+                                      duckAttackParameter->get(), duckReleaseParameter->get());
+        duckingGain = sidechainDucker.process(buffer.getArrayOfReadPointers() + firstKeyChannel, numKeyChannels, numSamples);
+        keyPeak = sidechainDucker.getBlockPeak();
+
+        if (! duckingParameter->get())
+            duckingGain = 1.0f;
+    }
+    else
+    {
+        sidechainDucker.reset();
+    }
 
     // Convert dB parameter to linear gain factor
-    auto targetGain = juce::Decibels::decibelsToGain(gainParameter->get());
+    auto targetGain = juce::Decibels::decibelsToGain(gainDb) * duckingGain;
     gainSmoother.setTargetValue(targetGain);
+
+    // Input trim, polarity, swap and balance: one matrix pass over the block
+    // (skipped entirely while the matrix is the identity)
+    applyChannelMatrix(buffer, totalNumInputChannels, numSamples);
+
+    // Mid/side gains sit at unity while the mode is off, so switching it is click-free
+    midSmoother.setTargetValue(getMidSideTargetGain(*midGainParameter));
+    sideSmoother.setTargetValue(getMidSideTargetGain(*sideGainParameter));
     
     // Track peak level across all channels for metering
     float peakLevel = 0.0f;
-    
-    // Process each audio channel independently
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
+    float midPeak = 0.0f, sidePeak = 0.0f;
+    int blockClipped = 0;
+    const auto numMeteredChannels = juce::jmin(totalNumInputChannels, LevelStatistics::maxChannels);
+
+    // Unity mid and side gains are the identity, so the plain gain pass is used
+    const auto useMidSide = numMeteredChannels == 2
+                         && (midSmoother.isSmoothing() || sideSmoother.isSmoothing()
+                             || midSmoother.getTargetValue() != 1.0f || sideSmoother.getTargetValue() != 1.0f);
+
+    // With the limiter in the path the statistics are taken from its output
+    const auto useLimiter = limiterLookahead >= 0;
+
+    // Gain pass: one fused kernel per channel applies the gain and fills the
+    // level statistics. Blocks larger than announced are handled in chunks.
+    for (int offset = 0; offset < numSamples; offset += gainRampSize)
+    {
+        auto chunkSize = juce::jmin(gainRampSize, numSamples - offset);
+        const float* ramp = nullptr;
+
+        if (gainSmoother.isSmoothing())
+        {
+            // Advance the smoother once per sample frame so every channel gets
+            // the same gain and the ramp lasts exactly the smoothing time
+            for (int sample = 0; sample < chunkSize; ++sample)
+                gainRamp[sample] = gainSmoother.getNextValue();
+
+            ramp = gainRamp;
+        }
+
+        // Mid/side: the master gain and the 0.5 encode factor are folded into the
+        // mid and side gains, so encode, gain and decode take a single pass and
+        // the statistics below measure the result at unity gain
+        auto statisticsRamp = ramp;
+        auto statisticsGain = gainSmoother.getTargetValue();
+
+        if (useMidSide)
+        {
+            const float* midGains = nullptr;
+            const float* sideGains = nullptr;
+
+            if (ramp != nullptr || midSmoother.isSmoothing() || sideSmoother.isSmoothing())
+            {
+                for (int sample = 0; sample < chunkSize; ++sample)
+                {
+                    const auto masterGain = 0.5f * (ramp != nullptr ? ramp[sample] : statisticsGain);
+                    midRamp[sample] = masterGain * midSmoother.getNextValue();
+                    sideRamp[sample] = masterGain * sideSmoother.getNextValue();
+                }
+
+                midGains = midRamp;
+                sideGains = sideRamp;
+            }
+
+            auto result = MeterKernels::getActive().applyMidSideGain(buffer.getWritePointer(0, offset),
+                                                                      buffer.getWritePointer(1, offset),
+                                                                      midGains, sideGains,
+                                                                      0.5f * statisticsGain * midSmoother.getTargetValue(),
+                                                                      0.5f * statisticsGain * sideSmoother.getTargetValue(),
+                                                                      chunkSize);
+            midPeak = juce::jmax(midPeak, result.midPeak);
+            sidePeak = juce::jmax(sidePeak, result.sidePeak);
+
+            statisticsRamp = nullptr;
+            statisticsGain = 1.0f;
+        }
+
+        if (useLimiter)
+        {
+            // Gain only; the statistics are taken from the limiter output below
+            for (int channel = useMidSide ? numMeteredChannels : 0; channel < totalNumInputChannels; ++channel)
+                MeterKernels::getActive().applyGainAndFindPeak(buffer.getWritePointer(channel, offset), ramp,
+                                                               gainSmoother.getTargetValue(), chunkSize);
+            continue;
+        }
+
+        for (int channel = 0; channel < numMeteredChannels; ++channel)
+        {
+            auto result = LevelStatistics::applyGainAndAccumulate(buffer.getWritePointer(channel, offset), statisticsRamp,
+                                                                  statisticsGain, chunkSize,
+                                                                  levelStatistics.getPendingAccumulator(channel));
+            peakLevel = juce::jmax(peakLevel, result.peak);
+            blockClipped += result.numClipped;
+        }
+
+        // Channels beyond the statistics range still get the gain and the peak
+        for (int channel = numMeteredChannels; channel < totalNumInputChannels; ++channel)
+        {
+            peakLevel = juce::jmax(peakLevel, MeterKernels::getActive().applyGainAndFindPeak(buffer.getWritePointer(channel, offset), ramp,
+                                                                                            gainSmoother.getTargetValue(), chunkSize));
+        }
+    }
+
+    if (useLimiter)
     {
-        auto* channelData = buffer.getWritePointer(channel);
-        
-        // Process each sample with smooth gain interpolation
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+        // Statistics pass at unity gain over the limited signal
+        truePeakLimiter.setParameters(limiterCeilingParameter->get(), limiterReleaseParameter->get());
+        const auto lowestGain = truePeakLimiter.process(buffer, numMeteredChannels, numSamples);
+        limiterReductionDb.store(-juce::Decibels::gainToDecibels(lowestGain, -60.0f));
+
+        for (int channel = 0; channel < numMeteredChannels; ++channel)
         {
-            // Get smoothly interpolated gain value (prevents clicks)
-            auto currentGain = gainSmoother.getNextValue();
-            
-            // Apply gain to audio sample
-            channelData[sample] *= currentGain;
-            
-            // Track peak level for visual meter (absolute value for magnitude)
-            peakLevel = juce::jmax(peakLevel, std::abs(channelData[sample]));
+            auto result = LevelStatistics::applyGainAndAccumulate(buffer.getWritePointer(channel), nullptr, 1.0f, numSamples,
+                                                                  levelStatistics.getPendingAccumulator(channel));
+            peakLevel = juce::jmax(peakLevel, result.peak);
+            blockClipped += result.numClipped;
         }
     }
+    else
+    {
+        limiterReductionDb.store(0.0f);
+    }
+
+    clippedSamples += blockClipped;
+    levelStatistics.publish(numSamples, numMeteredChannels);
+
+    // Hand the post-gain signal to the spectrum analyser (a memcpy at most)
+    spectrumAnalyser.pushSamples(buffer, totalNumInputChannels, numSamples);
+
+    // Reduce the block into history buckets (fixed cost, no allocation)
+    waveformHistory.pushBlock(buffer, totalNumInputChannels, numSamples);
+
+    // Stereo correlation and goniometer points (O(1) per sample)
+    stereoAnalyser.process(buffer, totalNumInputChannels, numSamples);
+
+    // Loudness (K-weighted, 100 ms steps) and inter-sample peaks
+    loudnessMeter.process(buffer, numMeteredChannels, numSamples);
+
+    float blockTruePeak = 0.0f;
+    for (int channel = 0; channel < numMeteredChannels; ++channel)
+        blockTruePeak = juce::jmax(blockTruePeak,
+                                   truePeakDetector.processBlock(channel, buffer.getReadPointer(channel), numSamples));
+
+    truePeakHoldLinear = juce::jmax(truePeakHoldLinear, blockTruePeak);
+
+    // Compliance log records (a FIFO push every 100 ms while logging)
+    meterLogWriter.pushBlock(numSamples, peakLevel, blockTruePeak, blockClipped,
+                             loudnessMeter.getMomentaryLoudness(), loudnessMeter.getShortTermLoudness());
+
+    // Stamp the block with the host's song position for the timeline lane
+    if (auto* playHead = getPlayHead())
+        if (auto position = playHead->getPosition())
+            timelineHistory.pushBlock(*position, peakLevel, loudnessMeter.getMomentaryLoudness());
+
+    peakHoldLinear = juce::jmax(peakHoldLinear, peakLevel);
     
     // Update peak level for UI thread (thread-safe atomic operation)
     if (peakLevel > 0.0f)
         currentPeakLevel.store(juce::Decibels::gainToDecibels(peakLevel));
     else
         currentPeakLevel.store(-60.0f); // Represent silence as -60dB floor
+
+    peakHoldLevel.store(juce::Decibels::gainToDecibels(peakHoldLinear, -60.0f));
+    clipCount.store(clippedSamples);
+    keyPeakLevel.store(juce::Decibels::gainToDecibels(keyPeak, -60.0f));
+    duckingReductionDb.store(-juce::Decibels::gainToDecibels(duckingGain));
+    midPeakLevel.store(juce::Decibels::gainToDecibels(midPeak, -60.0f));
+    sidePeakLevel.store(juce::Decibels::gainToDecibels(sidePeak, -60.0f));
+    truePeakHoldLevel.store(juce::Decibels::gainToDecibels(truePeakHoldLinear, -60.0f));
+}
+
+#if GAINMETER_CLAP
+//==============================================================================
+// CLAP Direct Processing
+
+clap_process_status GainMeterAudioProcessor::clap_direct_process (const clap_process* process) noexcept
+{
+    if (process->audio_outputs_count == 0)
+        return CLAP_PROCESS_CONTINUE;
+
+    const auto numFrames = (int) process->frames_count;
+    const auto& output = process->audio_outputs[0];
+    const auto numChannels = juce::jmin((int) output.channel_count, 2); // Mono or stereo layouts only
+
+    // Process in place on the output buffers, bringing the input across if the host separated them
+    if (process->audio_inputs_count > 0)
+    {
+        const auto& input = process->audio_inputs[0];
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            if (channel >= (int) input.channel_count)
+                juce::FloatVectorOperations::clear(output.data32[channel], numFrames);
+            else if (input.data32[channel] != output.data32[channel])
+                juce::FloatVectorOperations::copy(output.data32[channel], input.data32[channel], numFrames);
+        }
+    }
+
+    // Main channels followed by the sidechain key, matching the processBlock buffer layout
+    std::array<float*, 4> channels {};
+    auto numBufferChannels = numChannels;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        channels[(size_t) channel] = output.data32[channel];
+
+    if (process->audio_inputs_count > 1)
+    {
+        const auto& key = process->audio_inputs[1];
+
+        // processBlock only reads the key channels
+        for (juce::uint32 channel = 0; channel < juce::jmin(key.channel_count, 2u); ++channel)
+            channels[(size_t) numBufferChannels++] = const_cast<float*>(key.data32[channel]);
+    }
+
+    juce::MidiBuffer noMidi;
+    const auto* events = process->in_events;
+    const auto numEvents = events->size(events);
+    juce::uint32 eventIndex = 0;
+
+    for (int position = 0; position < numFrames;)
+    {
+        // Apply every event due at this sample, then run up to the next one
+        auto spanEnd = numFrames;
+
+        while (eventIndex < numEvents)
+        {
+            const auto* header = events->get(events, eventIndex);
+
+            if ((int) header->time > position)
+            {
+                spanEnd = juce::jmin(numFrames, (int) header->time);
+                break;
+            }
+
+            handleClapEvent(header);
+            ++eventIndex;
+        }
+
+        // Views into the host buffers - no allocation, no copy
+        juce::AudioBuffer<float> span (channels.data(), numBufferChannels, position, spanEnd - position);
+        processBlock(span, noMidi);
+
+        position = spanEnd;
+    }
+
+    // Events stamped at or past the last frame still take effect for the next block
+    for (; eventIndex < numEvents; ++eventIndex)
+        handleClapEvent(events->get(events, eventIndex));
+
+    return CLAP_PROCESS_CONTINUE;
+}
+
+void GainMeterAudioProcessor::handleClapEvent (const clap_event_header* header) noexcept
+{
+    if (header->space_id != CLAP_CORE_EVENT_SPACE_ID)
+        return;
+
+    // The wrapper stores its parameter lookup in each parameter's cookie
+    auto getParameter = [] (void* cookie) -> juce::AudioProcessorParameter*
+    {
+        const auto* variant = static_cast<const JUCEParameterVariant*>(cookie);
+        return variant != nullptr ? variant->processorParam : nullptr;
+    };
+
+    switch (header->type)
+    {
+        case CLAP_EVENT_PARAM_VALUE:
+        {
+            const auto* event = reinterpret_cast<const clap_event_param_value*>(header);
+
+            // Ranged parameters are exposed to CLAP in plain units (dB, or 0/1 for the switch)
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(getParameter(event->cookie)))
+                ranged->setValue(ranged->convertTo0to1((float) event->value));
+            break;
+        }
+
+        case CLAP_EVENT_PARAM_MOD:
+        {
+            const auto* event = reinterpret_cast<const clap_event_param_mod*>(header);
+
+            if (getParameter(event->cookie) == gainParameter)
+                gainModulationDb = (float) event->amount;
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+#endif
+
+//==============================================================================
+// Commands and Remote Control
+
+GainMeterAudioProcessor::MeterSnapshot GainMeterAudioProcessor::getMeterSnapshot() const
+{
+    MeterSnapshot snapshot;
+    snapshot.gainDb = getGainValue();
+    snapshot.peakDb = getPeakLevel();
+    snapshot.momentaryLufs = loudnessMeter.getMomentaryLoudness();
+    snapshot.shortTermLufs = loudnessMeter.getShortTermLoudness();
+    snapshot.integratedLufs = loudnessMeter.getIntegratedLoudness();
+    snapshot.truePeakDb = getTruePeakHoldLevel();
+    return snapshot;
+}
+
+std::optional<float> GainMeterAudioProcessor::postRemoteGainChange (float newGainDb)
+{
+    // Match exactly what the parameter will store, so the audio thread can
+    // recognise when the asynchronous parameter update has landed
+    const auto& range = gainParameter->getNormalisableRange();
+    const auto legalGainDb = range.snapToLegalValue(juce::jlimit(range.start, range.end, newGainDb));
+
+    if (! remoteCommandQueue.push ({ ProcessorCommand::Type::setGain, legalGainDb }))
+        return std::nullopt;
+
+    // Keep the host and its automation in sync with what the audio thread plays
+    pendingRemoteGainDb.store(legalGainDb);
+    triggerAsyncUpdate();
+
+    return legalGainDb;
+}
+
+juce::String GainMeterAudioProcessor::getDisplayName() const
+{
+    const juce::ScopedLock lock (trackNameLock);
+    return trackName.isNotEmpty() ? trackName : "GainMeter " + juce::String(instanceId);
+}
+
+void GainMeterAudioProcessor::updateTrackProperties (const TrackProperties& properties)
+{
+    {
+        const juce::ScopedLock lock (trackNameLock);
+        trackName = properties.name;
+    }
+
+    instanceRegistry->markChanged();
+}
+
+bool GainMeterAudioProcessor::postCommand (const ProcessorCommand& command)
+{
+    // The UI queue is single-producer: only the message thread may push
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    return uiCommandQueue.push (command);
+}
+
+void GainMeterAudioProcessor::handleAsyncUpdate()
+{
+    // Message thread: publish the remote change as a regular parameter gesture
+    const auto newGainDb = pendingRemoteGainDb.load();
+
+    gainParameter->beginChangeGesture();
+    *gainParameter = newGainDb;
+    gainParameter->endChangeGesture();
+}
+
+void GainMeterAudioProcessor::timerCallback()
+{
+    waveformHistory.processPending();
+    levelStatistics.processPending();
+    loudnessMeter.processPending();
+    timelineHistory.processPending();
+    updateLimiterLatency();
+}
+
+bool GainMeterAudioProcessor::joinLinkGroup (const juce::String& name, float initialOffsetDb)
+{
+    const auto currentSlot = linkGroupSlot.load();
+
+    if (currentSlot != LinkGroupRegistry::noGroup && linkGroups->getName(currentSlot) == name)
+        return true;
+
+    auto newSlot = LinkGroupRegistry::noGroup;
+    if (name.isNotEmpty())
+    {
+        newSlot = linkGroups->join(name, initialOffsetDb);
+        if (newSlot == LinkGroupRegistry::noGroup)
+            return false;
+    }
+
+    // Switch before leaving, so the audio thread has moved on before the old slot can be reused
+    linkGroupSlot.store(newSlot);
+    linkGroups->leave(currentSlot);
+    return true;
+}
+
+juce::String GainMeterAudioProcessor::getLinkGroupName() const
+{
+    return linkGroups->getName(linkGroupSlot.load());
+}
+
+float GainMeterAudioProcessor::getLinkGroupOffset() const
+{
+    const auto slot = linkGroupSlot.load();
+    return slot != LinkGroupRegistry::noGroup ? linkGroups->getOffset(slot) : 0.0f;
+}
+
+void GainMeterAudioProcessor::setLinkGroupOffset (float offsetDb)
+{
+    linkGroups->setOffset(linkGroupSlot.load(), offsetDb);
+}
+
+int GainMeterAudioProcessor::getLinkGroupSize() const
+{
+    return linkGroups->getNumMembers(linkGroupSlot.load());
+}
+
+bool GainMeterAudioProcessor::hasSidechainInput() const
+{
+    const auto* keyBus = getBus(true, 1);
+    return keyBus != nullptr && keyBus->isEnabled();
+}
+
+int GainMeterAudioProcessor::getLimiterLookaheadTarget (double sampleRate) const
+{
+    if (! limiterParameter->get())
+        return -1;
+
+    return juce::jmax(1, juce::roundToInt(limiterLookaheadParameter->get() * 0.001 * sampleRate));
+}
+
+void GainMeterAudioProcessor::updateLimiterLatency()
+{
+    const auto sampleRate = preparedSampleRate.load();
+    if (sampleRate <= 0.0)
+        return;
+
+    const auto lookahead = getLimiterLookaheadTarget(sampleRate);
+    if (lookahead == reportedLimiterLookahead.load())
+        return;
+
+    // A full queue just means trying again on the next tick
+    if (! postCommand({ ProcessorCommand::Type::setLimiterLookahead, (float) lookahead }))
+        return;
+
+    reportedLimiterLookahead.store(lookahead);
+    setLatencySamples(lookahead < 0 ? 0 : lookahead + TruePeakLimiter::detectorDelay);
+}
+
+bool GainMeterAudioProcessor::startMeterLog (const juce::File& directory, MeterLogWriter::Format format)
+{
+    return meterLogWriter.start(directory, format, "GainMeter-" + juce::String(instanceId));
+}
+
+void GainMeterAudioProcessor::stopMeterLog()
+{
+    meterLogWriter.stop();
+}
+
+void GainMeterAudioProcessor::resetSessionStatistics()
+{
+    levelStatistics.reset();
+    postCommand({ ProcessorCommand::Type::resetIntegratedLoudness });
+}
+
+bool GainMeterAudioProcessor::exportStatistics (const juce::File& file) const
+{
+    juce::FileOutputStream stream (file);
+    if (! stream.openedOk())
+        return false;
+
+    stream.setPosition(0);
+    stream.truncate();
+
+    const auto integrated = loudnessMeter.getIntegratedLoudness();
+    const auto truePeak = getTruePeakHoldLevel();
+    const auto numChannels = levelStatistics.getNumChannels();
+
+    // Summary section
+    stream << "statistic,channel,value\n";
+    stream << "integrated_lufs,all," << juce::String(integrated, 2) << "\n";
+    stream << "true_peak_dbtp,all," << juce::String(truePeak, 2) << "\n";
+    stream << "plr_db,all," << juce::String(truePeak - integrated, 2) << "\n";
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto& totals = levelStatistics.getTotals(channel);
+        if (totals.numSamples == 0)
+            continue;
+
+        const auto dcOffset = totals.sum / (double) totals.numSamples;
+        const auto rms = std::sqrt(totals.sumSquares / (double) totals.numSamples);
+        const auto crestDb = rms > 0.0 ? juce::Decibels::gainToDecibels(totals.peak / rms, -200.0) : 0.0;
+
+        stream << "dc_offset," << channel << "," << juce::String(dcOffset, 8) << "\n";
+        stream << "rms_dbfs," << channel << "," << juce::String(juce::Decibels::gainToDecibels(rms, -200.0), 2) << "\n";
+        stream << "crest_factor_db," << channel << "," << juce::String(crestDb, 2) << "\n";
+    }
+
+    // Histogram section: one row per bin, one count column per channel
+    stream << "\nbin_lower_dbfs,bin_upper_dbfs";
+    for (int channel = 0; channel < numChannels; ++channel)
+        stream << ",count_ch" << channel;
+    stream << "\n";
+
+    for (int bin = 0; bin < LevelStatistics::numBins; ++bin)
+    {
+        stream << juce::String(LevelStatistics::getBinLowerEdgeDb(bin), 2) << ","
+               << juce::String(LevelStatistics::getBinLowerEdgeDb(bin + 1), 2);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            stream << "," << juce::String((juce::int64) levelStatistics.getTotals(channel).histogram[(size_t) bin]);
+
+        stream << "\n";
+    }
+
+    stream.flush();
+    return stream.getStatus().wasOk();
+}
+
+void GainMeterAudioProcessor::applyCommand (const ProcessorCommand& command) noexcept
+{
+    switch (command.type)
+    {
+        case ProcessorCommand::Type::setGain:
+            // Takes effect this block; smoothing still prevents clicks
+            remoteGainDb = command.value;
+            remoteGainHoldSamples = remoteGainHoldLength;
+            break;
+
+        case ProcessorCommand::Type::resetPeakHold:
+            peakHoldLinear = 0.0f;
+            truePeakHoldLinear = 0.0f;
+            break;
+
+        case ProcessorCommand::Type::clearClipCounter:
+            clippedSamples = 0;
+            break;
+
+        case ProcessorCommand::Type::resetIntegratedLoudness:
+            loudnessMeter.resetMeasurement();
+            break;
+
+        case ProcessorCommand::Type::setLimiterLookahead:
+            // The limiter restarts with an empty delay line at the new latency
+            limiterLookahead = (int) command.value;
+            if (limiterLookahead >= 0)
+                truePeakLimiter.setLookahead(limiterLookahead);
+            break;
+    }
 }
 
 //==============================================================================
@@ -214,6 +997,99 @@ juce::AudioProcessorEditor* GainMeterAudioProcessor::createEditor()
     return new GainMeterAudioProcessorEditor (*this);
 }
 
+//==============================================================================
+// Mid/Side
+
+float GainMeterAudioProcessor::getMidSideTargetGain (const juce::AudioParameterFloat& parameter) const
+{
+    return midSideParameter->get() ? juce::Decibels::decibelsToGain(parameter.get()) : 1.0f;
+}
+
+//==============================================================================
+// Channel Matrix
+
+MeterKernels::ChannelMatrix GainMeterAudioProcessor::computeChannelMatrix (bool isStereo) const
+{
+    auto channelGain = [] (const juce::AudioParameterFloat& trim, const juce::AudioParameterBool& invert)
+    {
+        return juce::Decibels::decibelsToGain(trim.get()) * (invert.get() ? -1.0f : 1.0f);
+    };
+
+    const auto left = channelGain(*trimLeftParameter, *invertLeftParameter);
+
+    // Mono: only the left trim and polarity apply
+    if (! isStereo)
+        return { left, 0.0f, 0.0f, left };
+
+    const auto right = channelGain(*trimRightParameter, *invertRightParameter);
+
+    // Balance gains per pan law; 0 dB keeps the centre at unity and only attenuates
+    const auto balance = balanceParameter->get() / 100.0f;
+    float leftBalance = 1.0f, rightBalance = 1.0f;
+
+    switch (panLawParameter->getIndex())
+    {
+        case 1: // -3 dB constant power
+        {
+            const auto angle = (balance + 1.0f) * juce::MathConstants<float>::pi * 0.25f;
+            leftBalance = std::cos(angle);
+            rightBalance = std::sin(angle);
+            break;
+        }
+
+        case 2: // -6 dB linear
+            leftBalance = 0.5f * (1.0f - balance);
+            rightBalance = 0.5f * (1.0f + balance);
+            break;
+
+        default:
+            leftBalance = juce::jmin(1.0f, 1.0f - balance);
+            rightBalance = juce::jmin(1.0f, 1.0f + balance);
+            break;
+    }
+
+    // Trim and polarity per input, then the swap, then balance per output
+    if (swapChannelsParameter->get())
+        return { 0.0f, leftBalance * right, rightBalance * left, 0.0f };
+
+    return { leftBalance * left, 0.0f, 0.0f, rightBalance * right };
+}
+
+void GainMeterAudioProcessor::applyChannelMatrix (juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept
+{
+    if (numChannels == 0 || numSamples == 0)
+        return;
+
+    const auto target = computeChannelMatrix(numChannels >= 2);
+    const float targets[] { target.m00, target.m01, target.m10, target.m11 };
+    float starts[4], ends[4];
+    bool isIdentity = true;
+
+    for (size_t index = 0; index < matrixSmoothers.size(); ++index)
+    {
+        auto& smoother = matrixSmoothers[index];
+        smoother.setTargetValue(targets[index]);
+
+        starts[index] = smoother.getCurrentValue();
+        ends[index] = smoother.isSmoothing() ? smoother.skip(numSamples) : smoother.getCurrentValue();
+
+        const auto identityValue = (index == 0 || index == 3) ? 1.0f : 0.0f;
+        isIdentity = isIdentity && starts[index] == identityValue && ends[index] == identityValue;
+    }
+
+    if (isIdentity)
+        return;
+
+    // Mono runs the same kernel with both outputs on the one channel
+    auto* left = buffer.getWritePointer(0);
+    auto* right = numChannels >= 2 ? buffer.getWritePointer(1) : left;
+
+    MeterKernels::getActive().applyChannelMatrix(left, right,
+                                                 { starts[0], starts[1], starts[2], starts[3] },
+                                                 { ends[0], ends[1], ends[2], ends[3] },
+                                                 numSamples);
+}
+
 //==============================================================================
 // State Persistence - Project Save/Load Support
 
@@ -222,8 +1098,20 @@ void GainMeterAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
     // Create hierarchical data structure for plugin state
     auto state = juce::ValueTree("GainMeterState");
     
-    // Store current parameter value
-    state.setProperty("gain", gainParameter->get(), nullptr);
+    // Store every parameter in its plain units (dB, switch state, choice index)
+    for (auto* parameter : getParameters())
+        if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+            state.setProperty(ranged->paramID, ranged->convertFrom0to1(ranged->getValue()), nullptr);
+
+    // Optional measured history, quantised and GZIP-compressed
+    state.setProperty("saveHistory", getSaveHistoryInState(), nullptr);
+
+    // Link group membership and the group's offset (used if this instance recreates the group)
+    state.setProperty("linkGroup", getLinkGroupName(), nullptr);
+    state.setProperty("linkGroupOffset", getLinkGroupOffset(), nullptr);
+
+    if (getSaveHistoryInState())
+        state.setProperty("timelineHistory", timelineHistory.saveCompressed().toBase64Encoding(), nullptr);
     
     // Convert to XML format for cross-platform compatibility
     std::unique_ptr<juce::XmlElement> xml(state.createXml());
@@ -244,8 +1132,18 @@ void GainMeterAudioProcessor::setStateInformation (const void* data, int sizeInB
         {
             auto state = juce::ValueTree::fromXml(*xmlState);
             
-            // Restore parameter with fallback default
-            *gainParameter = state.getProperty("gain", 0.0f);
+            // Restore parameters; ones missing from older sessions go back to their defaults
+            for (auto* parameter : getParameters())
+                if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(parameter))
+                    ranged->setValueNotifyingHost(state.hasProperty(ranged->paramID)
+                                                      ? ranged->convertTo0to1(state.getProperty(ranged->paramID))
+                                                      : ranged->getDefaultValue());
+            setSaveHistoryInState(state.getProperty("saveHistory", false));
+            joinLinkGroup(state.getProperty("linkGroup").toString(), (float) state.getProperty("linkGroupOffset", 0.0f));
+
+            // History is decoded in the background so large sessions load quickly
+            if (state.hasProperty("timelineHistory"))
+                timelineHistory.restoreCompressedAsync(state.getProperty("timelineHistory").toString());
         }
     }
 }
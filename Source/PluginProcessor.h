@@ -16,21 +16,60 @@
 #include <juce_audio_utils/juce_audio_utils.h>
 #include <juce_core/juce_core.h>
 #include <juce_data_structures/juce_data_structures.h>
+#include <optional>
+
+#if GAINMETER_CLAP
+ #include <clap-juce-extensions/clap-juce-extensions.h>
+#endif
+#include "CommandQueue.h"
+#include "DspArena.h"
+#include "ControlSocketServer.h"
+#include "SpectrumAnalyser.h"
+#include "WaveformHistory.h"
+#include "StereoAnalyser.h"
+#include "LevelStatistics.h"
+#include "MeterKernels.h"
+#include "LoudnessMeter.h"
+#include "TruePeakDetector.h"
+#include "TruePeakLimiter.h"
+#include "SidechainDucker.h"
+#include "LinkGroupRegistry.h"
+#include "InstanceRegistry.h"
+#include "TimelineHistory.h"
+#include "MeterLogWriter.h"
 
 /**
  * Real-time gain control and peak metering audio processor.
  * 
  * Features:
  * - Real-time gain adjustment with parameter smoothing
+ * - Optional mid/side mode with independently smoothed mid and side gains
+ * - Input trim, polarity, swap and balance as one smoothed channel matrix
  * - Peak level detection for visual metering
  * - Thread-safe communication between audio and UI threads
  * - Full DAW integration (automation, state persistence)
  * - Cross-platform VST3/AU support
+ * - Optional Unix-domain control socket for automated test rigs
+ * - Post-gain FFT spectrum analysis on the process-wide analysis pool
+ * - Session-length waveform/level history in bounded memory
+ * - Stereo phase correlation and goniometer feed
+ * - EBU R128 loudness, true peak and session level statistics
+ * - Optional lookahead true-peak limiter (latency reported while enabled)
+ * - Optional sidechain input: key metering and ducking of the main gain
+ * - VCA-style link groups sharing a gain offset across instances
+ * - Session overview of every instance in the process
+ * - Peak/loudness history aligned to the host timeline
+ * - CLAP builds: sample-accurate gain events and modulation (direct processing)
  */
-class GainMeterAudioProcessor : public juce::AudioProcessor
+class GainMeterAudioProcessor : public juce::AudioProcessor,
+                                private juce::AsyncUpdater,
+                                private juce::Timer
                             #if JucePlugin_Enable_ARA
                              , public juce::AudioProcessorARAExtension
                             #endif
+                            #if GAINMETER_CLAP
+                             , public clap_juce_extensions::clap_juce_audio_processor_capabilities
+                            #endif
 {
 public:
     //==============================================================================
@@ -44,9 +83,12 @@ public:
     /** Called before audio processing starts. Initialize sample-rate dependent resources. */
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
     
-    /** Called when audio processing stops. Clean up resources. */
+    /** Called when audio processing stops. Detaches the DSP state (the arena is kept for the next prepare). */
     void releaseResources() override;
 
+    /** Bytes of DSP state this instance holds (0 before the first prepareToPlay). */
+    size_t getDspMemoryBytes() const { return dspMemoryBytes.load(); }
+
    #ifndef JucePlugin_PreferredChannelConfigurations
     /** Determines which channel configurations this plugin supports. */
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
@@ -63,6 +105,20 @@ public:
      */
     void processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) override;
 
+   #if GAINMETER_CLAP
+    //==============================================================================
+    // CLAP Direct Processing
+
+    /** Handle CLAP process calls ourselves so parameter events are sample-accurate. */
+    bool supportsDirectProcess() override { return true; }
+
+    /**
+     * Splits the host block at every input event and runs processBlock on
+     * each span, so automation and modulation land on the exact sample.
+     */
+    clap_process_status clap_direct_process (const clap_process* process) noexcept override;
+   #endif
+
     //==============================================================================
     // Plugin Editor Interface
     
@@ -131,6 +187,83 @@ public:
      * @return Current peak level in decibels (-60.0 to +12.0 range)
      */
     float getPeakLevel() const { return currentPeakLevel.load(); }
+
+    /**
+     * Thread-safe access to the highest peak since the last reset.
+     * @return Held peak level in decibels (-60.0 floor)
+     */
+    float getPeakHoldLevel() const { return peakHoldLevel.load(); }
+
+    /**
+     * Thread-safe access to the number of clipped samples since the last reset.
+     * A sample counts as clipped when its post-gain magnitude reaches 0 dBFS.
+     */
+    int getClipCount() const { return clipCount.load(); }
+
+    /**
+     * Queues a command for the audio thread (message thread only).
+     *
+     * Use this for any editor action that changes audio-thread state, e.g.
+     * resetting the peak hold or clip counter. Commands are applied at the
+     * start of the next processBlock().
+     *
+     * @return false if the queue is full and the command was dropped
+     */
+    bool postCommand (const ProcessorCommand& command);
+
+    /** Spectrum analyser fed with the post-gain signal (editor access). */
+    SpectrumAnalyser& getSpectrumAnalyser() noexcept { return spectrumAnalyser; }
+
+    /** Waveform/level history pyramid (message thread access only). */
+    WaveformHistory& getWaveformHistory() noexcept { return waveformHistory; }
+
+    /** Correlation meter and goniometer feed (editor access). */
+    StereoAnalyser& getStereoAnalyser() noexcept { return stereoAnalyser; }
+
+    //==============================================================================
+    // Loudness and Session Statistics
+
+    /** Loudness meter (any thread for readings). */
+    const LoudnessMeter& getLoudnessMeter() const noexcept { return loudnessMeter; }
+
+    /** Session level histogram and sums (message thread access only). */
+    const LevelStatistics& getLevelStatistics() const noexcept { return levelStatistics; }
+
+    /** Timeline-stamped peak and loudness history (message thread access only). */
+    TimelineHistory& getTimelineHistory() noexcept { return timelineHistory; }
+
+    /** Whether getStateInformation() includes the compressed timeline history. */
+    bool getSaveHistoryInState() const noexcept { return saveHistoryInState.load(); }
+    void setSaveHistoryInState (bool shouldSave) noexcept { saveHistoryInState.store(shouldSave); }
+
+    /** Highest true peak since the last peak-hold reset, in dBTP. */
+    float getTruePeakHoldLevel() const { return truePeakHoldLevel.load(); }
+
+    /**
+     * Clears the level histogram and restarts integrated loudness (message thread).
+     */
+    void resetSessionStatistics();
+
+    /**
+     * Writes the session statistics as CSV: summary rows (integrated loudness,
+     * true peak, PLR, per-channel DC offset and crest factor) followed by the
+     * level histogram (message thread).
+     * @return false if the file could not be written
+     */
+    bool exportStatistics (const juce::File& file) const;
+
+    /**
+     * Starts streaming 100 ms loudness/peak records to rotating log files
+     * in a directory (message thread).
+     * @return false if the log file could not be created
+     */
+    bool startMeterLog (const juce::File& directory, MeterLogWriter::Format format);
+
+    /** Flushes and closes the compliance log (message thread). */
+    void stopMeterLog();
+
+    /** Compliance log state for the UI. */
+    const MeterLogWriter& getMeterLogWriter() const noexcept { return meterLogWriter; }
     
     /** 
      * Main gain parameter - exposed publicly for direct editor access.
@@ -138,7 +271,205 @@ public:
      */
     juce::AudioParameterFloat* gainParameter;
 
+    /**
+     * Mid/side mode switch and the mid and side gains (-60dB to +12dB).
+     * Only stereo buses are affected; the gains sit at unity while the mode is off.
+     */
+    juce::AudioParameterBool* midSideParameter;
+    juce::AudioParameterFloat* midGainParameter;
+    juce::AudioParameterFloat* sideGainParameter;
+
+    /**
+     * Input channel utilities applied ahead of the gain stage as one 2x2 matrix:
+     * per-channel trim (-24dB to +24dB) and polarity, L/R swap, and balance
+     * (-100% left to +100% right) with a 0 dB, -3 dB or -6 dB pan law.
+     */
+    juce::AudioParameterFloat* trimLeftParameter;
+    juce::AudioParameterFloat* trimRightParameter;
+    juce::AudioParameterBool* invertLeftParameter;
+    juce::AudioParameterBool* invertRightParameter;
+    juce::AudioParameterBool* swapChannelsParameter;
+    juce::AudioParameterFloat* balanceParameter;
+    juce::AudioParameterChoice* panLawParameter;
+
+    /**
+     * Optional true-peak safety limiter after the gain stage: on/off, ceiling
+     * (-12 to 0 dBTP), lookahead (1 to 10 ms) and release (10 to 1000 ms).
+     * The lookahead plus the interpolator delay is reported as latency while
+     * the limiter is on; changing it takes effect on the next timer tick.
+     */
+    juce::AudioParameterBool* limiterParameter;
+    juce::AudioParameterFloat* limiterCeilingParameter;
+    juce::AudioParameterFloat* limiterLookaheadParameter;
+    juce::AudioParameterFloat* limiterReleaseParameter;
+
+    /** Limiter gain reduction over the last block in dB (0 when idle or off). */
+    float getLimiterReduction() const { return limiterReductionDb.load(); }
+
+    /**
+     * Sidechain ducking: on/off, threshold (-60 to 0 dB), range (0 to 40 dB),
+     * attack (1 to 200 ms) and release (20 to 2000 ms). The ducking gain is
+     * folded into the gain target, so it also passes through the gain smoothing.
+     */
+    juce::AudioParameterBool* duckingParameter;
+    juce::AudioParameterFloat* duckThresholdParameter;
+    juce::AudioParameterFloat* duckRangeParameter;
+    juce::AudioParameterFloat* duckAttackParameter;
+    juce::AudioParameterFloat* duckReleaseParameter;
+
+    /** True while the host has the sidechain bus enabled. */
+    bool hasSidechainInput() const;
+
+    /** Sidechain key block peak in dB (-60 floor, also while disconnected). */
+    float getKeyPeakLevel() const { return keyPeakLevel.load(); }
+
+    /** Current ducking depth in dB (0 while not ducking). */
+    float getDuckingReduction() const { return duckingReductionDb.load(); }
+
+    /** Post-gain mid and side block peaks in dB (-60 floor while M/S is inactive). */
+    float getMidPeakLevel() const { return midPeakLevel.load(); }
+    float getSidePeakLevel() const { return sidePeakLevel.load(); }
+
+    //==============================================================================
+    // Link Groups
+
+    /**
+     * Moves this instance into a named link group, creating the group if it
+     * has no members yet, and leaves the current one. An empty name only
+     * leaves (message thread; state restore may call it from the host's thread).
+     *
+     * @param name            Group name
+     * @param initialOffsetDb Offset given to a newly created group
+     * @return false when every group slot is taken (the instance stays where it was)
+     */
+    bool joinLinkGroup (const juce::String& name, float initialOffsetDb = 0.0f);
+
+    /** Current group name, empty when not linked. */
+    juce::String getLinkGroupName() const;
+
+    /** Current group's gain offset in dB (0 when not linked). */
+    float getLinkGroupOffset() const;
+
+    /** Moves every member of the current group; ignored when not linked. */
+    void setLinkGroupOffset (float offsetDb);
+
+    /** Number of instances in the current group (0 when not linked). */
+    int getLinkGroupSize() const;
+
+    /** Names of every group in the process, for the group picker. */
+    juce::StringArray getLinkGroupNames() const { return linkGroups->getGroupNames(); }
+
+    //==============================================================================
+    // Remote Control Interface
+
+    /** Point-in-time view of the meter state, safe to take from any thread. */
+    struct MeterSnapshot
+    {
+        float gainDb = 0.0f;            // Current gain parameter value
+        float peakDb = -60.0f;          // Most recent block peak
+        float momentaryLufs = -70.0f;   // 400 ms loudness
+        float shortTermLufs = -70.0f;   // 3 s loudness
+        float integratedLufs = -70.0f;  // Gated loudness since last reset
+        float truePeakDb = -60.0f;      // Highest true peak since last reset (dBTP)
+    };
+
+    /** Captures the current meter readings (any thread). */
+    MeterSnapshot getMeterSnapshot() const;
+
+    /** Process-unique number identifying this instance on the control socket. */
+    int getInstanceId() const noexcept { return instanceId; }
+
+    /** Host track name when the host reports one, otherwise "GainMeter <id>" (any thread). */
+    juce::String getDisplayName() const;
+
+    /** Keeps the host's track name for the session overview. */
+    void updateTrackProperties (const TrackProperties& properties) override;
+
+    /**
+     * Requests a gain change from a non-audio, non-message thread.
+     *
+     * The value is clamped and snapped to the parameter range, delivered to
+     * the audio thread through the remote command queue (audible within one
+     * block plus the smoothing time), and committed to the host-visible
+     * parameter asynchronously on the message thread.
+     *
+     * @param newGainDb Requested gain in decibels
+     * @return The gain that will be applied, or nothing if the queue is full
+     */
+    std::optional<float> postRemoteGainChange (float newGainDb);
+
 private:
+    //==============================================================================
+    // Remote Control Internals
+
+    /** Commits a remote gain change to the parameter (message thread). */
+    void handleAsyncUpdate() override;
+
+    /**
+     * Message-thread housekeeping: moves data queued by the audio thread
+     * into the history structures, whether or not an editor is open.
+     */
+    void timerCallback() override;
+
+    /** Linear target for the mid or side smoother: the parameter in M/S mode, unity otherwise. */
+    float getMidSideTargetGain (const juce::AudioParameterFloat& parameter) const;
+
+    /** Target channel matrix for the current trim, polarity, swap and balance settings. */
+    MeterKernels::ChannelMatrix computeChannelMatrix (bool isStereo) const;
+
+    /** Moves the smoothed matrix towards its target and applies it to the block (audio thread). */
+    void applyChannelMatrix (juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept;
+
+    /** Limiter lookahead the parameters ask for at a sample rate, or -1 while the limiter is off. */
+    int getLimiterLookaheadTarget (double sampleRate) const;
+
+    /**
+     * Reports a changed limiter latency to the host and hands the new
+     * lookahead to the audio thread (message thread).
+     */
+    void updateLimiterLatency();
+
+    /** Applies one queued command (audio thread, start of block). */
+    void applyCommand (const ProcessorCommand& command) noexcept;
+
+   #if GAINMETER_CLAP
+    /** Applies one CLAP parameter value or modulation event (audio thread). */
+    void handleClapEvent (const clap_event_header* header) noexcept;
+   #endif
+
+    /** Host modulation offset added to the gain parameter, in dB (audio thread; CLAP only). */
+    float gainModulationDb = 0.0f;
+
+    /** Commands from the message thread (editor) to the audio thread. */
+    CommandQueue<ProcessorCommand, 64> uiCommandQueue;
+
+    /** Commands from the control socket thread to the audio thread. */
+    CommandQueue<ProcessorCommand, 64> remoteCommandQueue;
+
+    /** Optional control socket, created when GAINMETER_CONTROL_SOCKET_DIR is set. */
+    std::unique_ptr<ControlSocketServer> controlServer;
+
+    /** Latest remote gain awaiting commit to the parameter on the message thread. */
+    std::atomic<float> pendingRemoteGainDb { 0.0f };
+
+    /**
+     * Audio-thread copy of the last remote gain. Overrides the parameter value
+     * until the asynchronous parameter update lands (or the hold expires), so
+     * the change is not undone by the next block.
+     */
+    float remoteGainDb = 0.0f;
+    int remoteGainHoldSamples = 0;
+    int remoteGainHoldLength = 0;
+
+    const int instanceId;
+
+    /** Every live instance, for the session overview; this one is listed for its lifetime. */
+    juce::SharedResourcePointer<InstanceRegistry> instanceRegistry;
+
+    /** Track name from updateTrackProperties(), guarded by trackNameLock. */
+    juce::String trackName;
+    juce::CriticalSection trackNameLock;
+
     //==============================================================================
     // Thread-Safe Inter-Thread Communication
     
@@ -147,12 +478,81 @@ private:
      * Updated by audio thread, read by UI thread. Atomic ensures thread safety.
      */
     std::atomic<float> currentPeakLevel { 0.0f };
+
+    /** Held maximum peak (dB) and clip count, published for the UI thread. */
+    std::atomic<float> peakHoldLevel { -60.0f };
+    std::atomic<int> clipCount { 0 };
+
+    /** Audio-thread accumulators behind peakHoldLevel and clipCount. */
+    float peakHoldLinear = 0.0f;
+    int clippedSamples = 0;
     
     /** 
      * Smooths gain parameter changes to prevent audio clicks.
      * Provides gradual transitions when user adjusts gain control.
      */
     juce::LinearSmoothedValue<float> gainSmoother;
+
+    /** Independent smoothing for the mid and side gains. */
+    juce::LinearSmoothedValue<float> midSmoother, sideSmoother;
+
+    /** Channel matrix coefficients (m00, m01, m10, m11), advanced once per block. */
+    std::array<juce::LinearSmoothedValue<float>, 4> matrixSmoothers;
+    std::atomic<float> midPeakLevel { -60.0f }, sidePeakLevel { -60.0f };
+
+    /** Background spectrum analysis; the audio thread only copies samples into it. */
+    SpectrumAnalyser spectrumAnalyser;
+
+    /** Min/max/RMS history; fed from the audio thread, built on the message thread. */
+    WaveformHistory waveformHistory;
+
+    /** Running-sum correlation and decimated goniometer points. */
+    StereoAnalyser stereoAnalyser;
+
+    /** Histogram, DC and energy accumulators filled in the gain pass. */
+    LevelStatistics levelStatistics;
+
+    /** K-weighted loudness with message-thread gating. */
+    LoudnessMeter loudnessMeter;
+
+    /** Meter values placed on the host timeline. */
+    TimelineHistory timelineHistory;
+    std::atomic<bool> saveHistoryInState { false };
+
+    /** Background compliance log (audio thread only pushes records). */
+    MeterLogWriter meterLogWriter;
+
+    /** 4x oversampled inter-sample peak detection. */
+    TruePeakDetector truePeakDetector;
+    float truePeakHoldLinear = 0.0f;
+    std::atomic<float> truePeakHoldLevel { -60.0f };
+
+    /** True-peak limiter after the gain stage; the statistics measure its output. */
+    TruePeakLimiter truePeakLimiter;
+    int limiterLookahead = -1; // Audio thread: active lookahead, -1 while bypassed
+    std::atomic<int> reportedLimiterLookahead { -1 }; // Lookahead behind the reported latency
+    std::atomic<double> preparedSampleRate { 0.0 };
+    std::atomic<float> limiterReductionDb { 0.0f };
+
+    /** Process-wide link groups and this instance's slot (read once per block). */
+    juce::SharedResourcePointer<LinkGroupRegistry> linkGroups;
+    std::atomic<int> linkGroupSlot { LinkGroupRegistry::noGroup };
+
+    /** Key envelope follower for sidechain ducking. */
+    SidechainDucker sidechainDucker;
+    std::atomic<float> keyPeakLevel { -60.0f }, duckingReductionDb { 0.0f };
+
+    /** Rate- and block-size-dependent DSP buffers, sized for the worst case in prepareToPlay. */
+    DspArena dspArena;
+    std::atomic<size_t> dspMemoryBytes { 0 };
+
+    /** Per-sample gain ramp shared by all channels while the gain is smoothing (arena storage). */
+    float* gainRamp = nullptr;
+    int gainRampSize = 0;
+
+    /** Mid and side gain ramps (master gain and encode factor included). */
+    float* midRamp = nullptr;
+    float* sideRamp = nullptr;
     
     //==============================================================================
     // Development Safety
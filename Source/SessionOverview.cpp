@@ -0,0 +1,252 @@
+/*
+    SessionOverview.cpp
+
+    Implementation of the session meter bridge.
+
+    Author: Divij Singh
+*/
+
+#include "SessionOverview.h"
+#include "PluginProcessor.h"
+#include <optional>
+
+namespace
+{
+    /** Cell size: name on the left, horizontal bar on the right. */
+    constexpr int cellWidth = 200;
+    constexpr int cellHeight = 18;
+    constexpr int nameWidth = 90;
+
+    /** Same scale as the editor's PeakMeter. */
+    constexpr float minDb = -60.0f;
+    constexpr float maxDb = 12.0f;
+
+    /** Bar fall per 30 Hz tick (about 20 dB/s). */
+    constexpr float meterFallDb = 0.7f;
+}
+
+//==============================================================================
+/**
+ * The bitmap and per-cell state behind the overview. Lives inside the
+ * viewport; painting copies the visible part of the bitmap.
+ */
+class SessionOverview::Bridge : public juce::Component
+{
+public:
+    struct Cell
+    {
+        GainMeterAudioProcessor* processor = nullptr;
+        juce::String name;
+        juce::Rectangle<int> bounds;
+        float displayedDb = minDb;
+
+        // Readings copied out under the registry lock each tick
+        float peakDb = minDb;
+        float holdDb = minDb;
+        bool hasClipped = false;
+
+        // What the bitmap currently shows, in pixels (-1 forces a redraw)
+        int barWidth = -1;
+        int holdX = -1;
+        bool clipped = false;
+    };
+
+    std::vector<Cell> cells;
+    juce::Image image;
+    const GainMeterAudioProcessor* self = nullptr;
+
+    /** Lays the cells out in columns across the given width and redraws everything. */
+    void layOut (int width)
+    {
+        const auto numColumns = juce::jmax (1, width / cellWidth);
+        const auto numRows = ((int) cells.size() + numColumns - 1) / numColumns;
+        const auto columnWidth = width / numColumns;
+
+        for (size_t index = 0; index < cells.size(); ++index)
+        {
+            auto& cell = cells[index];
+            cell.bounds = { (int) index % numColumns * columnWidth, (int) index / numColumns * cellHeight,
+                            columnWidth, cellHeight };
+            cell.barWidth = cell.holdX = -1;
+        }
+
+        setSize (width, juce::jmax (cellHeight, numRows * cellHeight));
+        image = juce::Image (juce::Image::RGB, juce::jmax (1, getWidth()), getHeight(), true);
+
+        juce::Graphics g (image);
+        g.fillAll (juce::Colours::black);
+        g.setFont (11.0f);
+
+        for (const auto& cell : cells)
+        {
+            const auto nameArea = cell.bounds.withWidth (nameWidth).reduced (3, 0);
+            g.setColour (cell.processor == self ? juce::Colours::orange : juce::Colours::lightgrey);
+            g.drawText (cell.name, nameArea, juce::Justification::centredLeft, true);
+        }
+    }
+
+    /** Area of a cell holding the bar. */
+    static juce::Rectangle<int> getBarArea (const Cell& cell)
+    {
+        return cell.bounds.withTrimmedLeft (nameWidth).reduced (2, 3);
+    }
+
+    /** Redraws one cell's bar into the bitmap through the tick's context. */
+    static void drawBar (juce::Graphics& g, const Cell& cell)
+    {
+        auto area = getBarArea (cell);
+
+        g.setColour (juce::Colour (0xff202020));
+        g.fillRect (area);
+
+        if (cell.barWidth > 0)
+        {
+            g.setColour (cell.displayedDb < -12.0f ? juce::Colours::green
+                         : cell.displayedDb < -3.0f ? juce::Colours::yellow
+                                                    : juce::Colours::red);
+            g.fillRect (area.withWidth (cell.barWidth));
+        }
+
+        if (cell.holdX > 0)
+        {
+            g.setColour (juce::Colours::white);
+            g.fillRect (area.getX() + cell.holdX - 1, area.getY(), 2, area.getHeight());
+        }
+
+        if (cell.clipped)
+        {
+            g.setColour (juce::Colours::red);
+            g.fillRect (area.removeFromRight (6));
+        }
+    }
+
+    void paint (juce::Graphics& g) override
+    {
+        g.drawImageAt (image, 0, 0);
+    }
+};
+
+//==============================================================================
+// Lifecycle
+
+SessionOverview::SessionOverview (GainMeterAudioProcessor& p)
+    : processor (p), bridge (std::make_unique<Bridge>())
+{
+    bridge->self = &processor;
+
+    viewport.setViewedComponent (bridge.get(), false);
+    viewport.setScrollBarsShown (true, false);
+    addAndMakeVisible (viewport);
+
+    startTimerHz (30);
+}
+
+SessionOverview::~SessionOverview()
+{
+    stopTimer();
+}
+
+void SessionOverview::resized()
+{
+    viewport.setBounds (getLocalBounds().reduced (4));
+}
+
+//==============================================================================
+// Refresh
+
+void SessionOverview::readInstances()
+{
+    auto& cells = bridge->cells;
+    cells.clear();
+
+    for (auto* instance : registry->getInstances())
+    {
+        Bridge::Cell cell;
+        cell.processor = instance;
+        cell.name = instance->getDisplayName();
+        cells.push_back (cell);
+    }
+
+    builtVersion = registry->getVersion();
+}
+
+void SessionOverview::timerCallback()
+{
+    // Nothing to draw while the tab is hidden
+    if (! isShowing())
+        return;
+
+    const auto width = viewport.getMaximumVisibleWidth();
+    auto needsLayout = width != builtWidth;
+
+    {
+        // Instances remove themselves under this lock, so every listed pointer
+        // stays valid while it is held; only the readings are copied out here
+        const juce::ScopedLock lock (registry->getLock());
+
+        if (registry->getVersion() != builtVersion)
+        {
+            readInstances();
+            needsLayout = true;
+        }
+
+        for (auto& cell : bridge->cells)
+        {
+            cell.peakDb = cell.processor->getPeakLevel();
+            cell.holdDb = cell.processor->getPeakHoldLevel();
+            cell.hasClipped = cell.processor->getClipCount() > 0;
+        }
+    }
+
+    if (needsLayout)
+    {
+        builtWidth = width;
+        bridge->layOut (builtWidth);
+        bridge->repaint();
+    }
+
+    // One graphics context for every bar redrawn this tick, created only if one moved
+    std::optional<juce::Graphics> g;
+
+    // Dirty bars are repainted a row at a time rather than as one union
+    // spanning the whole bridge
+    juce::Rectangle<int> dirtyRow;
+
+    for (auto& cell : bridge->cells)
+    {
+        cell.displayedDb = juce::jmax (cell.peakDb, cell.displayedDb - meterFallDb, minDb);
+
+        const auto barArea = Bridge::getBarArea (cell);
+        auto toPixels = [&barArea] (float db)
+        {
+            return juce::roundToInt (juce::jlimit (0.0f, 1.0f, juce::jmap (db, minDb, maxDb, 0.0f, 1.0f))
+                                     * (float) barArea.getWidth());
+        };
+
+        const auto barWidth = toPixels (cell.displayedDb);
+        const auto holdX = toPixels (cell.holdDb);
+
+        if (barWidth == cell.barWidth && holdX == cell.holdX && cell.hasClipped == cell.clipped)
+            continue;
+
+        cell.barWidth = barWidth;
+        cell.holdX = holdX;
+        cell.clipped = cell.hasClipped;
+
+        if (! g.has_value())
+            g.emplace (bridge->image);
+
+        Bridge::drawBar (*g, cell);
+
+        if (! dirtyRow.isEmpty() && dirtyRow.getY() != barArea.getY())
+        {
+            bridge->repaint (dirtyRow);
+            dirtyRow = {};
+        }
+
+        dirtyRow = dirtyRow.isEmpty() ? barArea : dirtyRow.getUnion (barArea);
+    }
+
+    if (! dirtyRow.isEmpty())
+        bridge->repaint (dirtyRow);
+}
@@ -0,0 +1,56 @@
+/*
+    SessionOverview.h
+
+    Compact meters for every GainMeter instance in the process.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "InstanceRegistry.h"
+
+class GainMeterAudioProcessor;
+
+//==============================================================================
+/**
+ * Meter bridge listing every instance with its name, peak bar, peak-hold
+ * marker and clip flag, scrolling when the session has more instances
+ * than fit.
+ *
+ * One 30 Hz timer serves all meters. Each tick copies the readings out
+ * under the registry lock, then, with the lock released, redraws only the
+ * cells whose bar, marker or clip flag moved by at least a pixel into one
+ * bitmap through a single graphics context and repaints just those rows,
+ * so the message-thread cost stays around that of a single PeakMeter.
+ */
+class SessionOverview : public juce::Component, private juce::Timer
+{
+public:
+    /** @param processor The editor's own processor (highlighted in the list) */
+    explicit SessionOverview (GainMeterAudioProcessor& processor);
+    ~SessionOverview() override;
+
+    void resized() override;
+
+private:
+    class Bridge;
+
+    void timerCallback() override;
+
+    /** Re-reads the instance list and names (registry lock held). */
+    void readInstances();
+
+    GainMeterAudioProcessor& processor;
+    juce::SharedResourcePointer<InstanceRegistry> registry;
+
+    juce::Viewport viewport;
+    std::unique_ptr<Bridge> bridge;
+
+    /** Registry version and bridge width the bitmap was built for. */
+    juce::uint32 builtVersion = 0;
+    int builtWidth = -1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SessionOverview)
+};
@@ -0,0 +1,88 @@
+/*
+    SidechainDucker.cpp
+
+    Implementation of the sidechain envelope follower.
+
+    Author: Divij Singh
+*/
+
+#include "SidechainDucker.h"
+#include "MeterKernels.h"
+
+namespace
+{
+    /** One-pole coefficient for a time constant, stepping once per detection interval. */
+    float intervalCoefficient (float timeMs, double sampleRate)
+    {
+        const auto intervals = (double) timeMs * 0.001 * sampleRate / SidechainDucker::detectionInterval;
+        return (float) std::exp (-1.0 / juce::jmax (1.0e-3, intervals));
+    }
+}
+
+//==============================================================================
+void SidechainDucker::prepare (double newSampleRate)
+{
+    sampleRate = newSampleRate;
+
+    // Force the coefficients to be recomputed for the new rate
+    attackMs = releaseMs = -1.0f;
+    reset();
+}
+
+void SidechainDucker::setParameters (float newThresholdDb, float newRangeDb, float newAttackMs, float newReleaseMs) noexcept
+{
+    thresholdDb = newThresholdDb;
+    rangeDb = newRangeDb;
+
+    if (newAttackMs != attackMs)
+    {
+        attackMs = newAttackMs;
+        attackCoefficient = intervalCoefficient (attackMs, sampleRate);
+    }
+
+    if (newReleaseMs != releaseMs)
+    {
+        releaseMs = newReleaseMs;
+        releaseCoefficient = intervalCoefficient (releaseMs, sampleRate);
+    }
+}
+
+void SidechainDucker::reset() noexcept
+{
+    envelope = 0.0f;
+    pendingPeak = 0.0f;
+    pendingSamples = 0;
+    blockPeak = 0.0f;
+}
+
+//==============================================================================
+float SidechainDucker::process (const float* const* keyChannels, int numChannels, int numSamples) noexcept
+{
+    const auto& kernels = MeterKernels::getActive();
+    blockPeak = 0.0f;
+
+    for (int offset = 0; offset < numSamples;)
+    {
+        const auto length = juce::jmin (detectionInterval - pendingSamples, numSamples - offset);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            pendingPeak = juce::jmax (pendingPeak, kernels.findPeak (keyChannels[channel] + offset, length));
+
+        blockPeak = juce::jmax (blockPeak, pendingPeak);
+        pendingSamples += length;
+        offset += length;
+
+        if (pendingSamples == detectionInterval)
+        {
+            // Peak follower: rises with the attack time, falls with the release time
+            const auto coefficient = pendingPeak > envelope ? attackCoefficient : releaseCoefficient;
+            envelope = pendingPeak + coefficient * (envelope - pendingPeak);
+
+            pendingPeak = 0.0f;
+            pendingSamples = 0;
+        }
+    }
+
+    const auto overThresholdDb = juce::Decibels::gainToDecibels (envelope, -100.0f) - thresholdDb;
+    return juce::Decibels::decibelsToGain (-juce::jlimit (0.0f, rangeDb, overThresholdDb));
+}
@@ -0,0 +1,73 @@
+/*
+    SidechainDucker.h
+
+    Envelope follower on an external key signal, turned into a ducking
+    gain for the main signal.
+
+    Detection works on fixed 32-sample intervals: the key's peak over each
+    interval comes from the vectorised findPeak kernel, and the recursive
+    attack/release follower runs once per interval rather than per sample.
+    Intervals carry over between calls, so the response does not depend on
+    the host block size.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+
+//==============================================================================
+/**
+ * Peak envelope follower with threshold and range.
+ *
+ * The gain drops decibel for decibel as the key envelope rises above the
+ * threshold, down to at most the range below unity.
+ *
+ * Thread roles: prepare() on any thread before playback, everything else
+ * on the audio thread.
+ */
+class SidechainDucker
+{
+public:
+    /** Samples per detection interval (one follower step each). */
+    static constexpr int detectionInterval = 32;
+
+    /** Sets the follower time base. */
+    void prepare (double sampleRate);
+
+    /** Updates the ducking curve and follower times; cheap enough to call every block. */
+    void setParameters (float thresholdDb, float rangeDb, float attackMs, float releaseMs) noexcept;
+
+    /** Returns the envelope to silence. */
+    void reset() noexcept;
+
+    /**
+     * Runs a block of key signal through the follower.
+     * @param keyChannels  Key channel pointers (channels are linked by their peak)
+     * @param numChannels  Number of key channels
+     * @param numSamples   Samples per channel
+     * @return The linear ducking gain at the end of the block (1.0 when not ducking)
+     */
+    float process (const float* const* keyChannels, int numChannels, int numSamples) noexcept;
+
+    /** Key sample peak of the last processed block (linear). */
+    float getBlockPeak() const noexcept { return blockPeak; }
+
+private:
+    double sampleRate = 44100.0;
+
+    float thresholdDb = -30.0f;
+    float rangeDb = 12.0f;
+    float attackCoefficient = 0.0f;
+    float releaseCoefficient = 0.0f;
+
+    // Parameters behind the coefficients, so unchanged times skip the exp()
+    float attackMs = -1.0f, releaseMs = -1.0f;
+
+    float envelope = 0.0f;
+    float pendingPeak = 0.0f;
+    int pendingSamples = 0;
+    float blockPeak = 0.0f;
+};
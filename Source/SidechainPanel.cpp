@@ -0,0 +1,146 @@
+/*
+    SidechainPanel.cpp
+
+    Implementation of the sidechain controls.
+
+    Author: Divij Singh
+*/
+
+#include "SidechainPanel.h"
+#include "PluginProcessor.h"
+
+namespace
+{
+    /** Key bar range in dBFS. */
+    constexpr float keyFloorDb = -60.0f;
+
+    /** Deepest ducking the bar shows (the range parameter's maximum). */
+    constexpr float duckRangeDb = 40.0f;
+
+    /** Bar fall per 30 Hz tick (about 20 dB/s). */
+    constexpr float meterFallDb = 0.7f;
+}
+
+//==============================================================================
+// Lifecycle
+
+SidechainPanel::SidechainPanel (GainMeterAudioProcessor& p)
+    : processor (p)
+{
+    auto setUpSlider = [this] (juce::Slider& slider, juce::Label& label, const juce::String& name,
+                               juce::AudioParameterFloat& parameter, const juce::String& suffix)
+    {
+        const auto& range = parameter.range;
+        slider.setSliderStyle (juce::Slider::RotaryHorizontalVerticalDrag);
+        slider.setTextBoxStyle (juce::Slider::TextBoxBelow, false, 70, 18);
+        slider.setNormalisableRange ({ (double) range.start, (double) range.end, (double) range.interval, (double) range.skew });
+        slider.setValue (parameter.get(), juce::dontSendNotification);
+        slider.setDoubleClickReturnValue (true, parameter.convertFrom0to1 (parameter.getDefaultValue()));
+        slider.setTextValueSuffix (suffix);
+        slider.onValueChange = [&slider, &parameter] { parameter = (float) slider.getValue(); };
+        addAndMakeVisible (slider);
+
+        label.setText (name, juce::dontSendNotification);
+        label.setJustificationType (juce::Justification::centred);
+        addAndMakeVisible (label);
+    };
+
+    setUpSlider (thresholdSlider, thresholdLabel, "Threshold", *processor.duckThresholdParameter, " dB");
+    setUpSlider (rangeSlider, rangeLabel, "Range", *processor.duckRangeParameter, " dB");
+    setUpSlider (attackSlider, attackLabel, "Attack", *processor.duckAttackParameter, " ms");
+    setUpSlider (releaseSlider, releaseLabel, "Release", *processor.duckReleaseParameter, " ms");
+
+    enableButton.setToggleState (processor.duckingParameter->get(), juce::dontSendNotification);
+    enableButton.onClick = [this] { *processor.duckingParameter = enableButton.getToggleState(); };
+    addAndMakeVisible (enableButton);
+
+    startTimerHz (30);
+}
+
+SidechainPanel::~SidechainPanel()
+{
+    stopTimer();
+}
+
+//==============================================================================
+// Layout and Painting
+
+void SidechainPanel::resized()
+{
+    auto area = getLocalBounds().reduced (8);
+
+    auto meters = area.removeFromRight (70).withTrimmedTop (24).withTrimmedBottom (18);
+    keyMeterArea = meters.removeFromLeft (30);
+    duckMeterArea = meters.removeFromRight (30);
+    area.removeFromRight (8);
+
+    enableButton.setBounds (area.removeFromTop (24).removeFromLeft (100));
+    area.removeFromTop (8);
+
+    auto knobs = area.removeFromTop (juce::jmin (area.getHeight() - 20, 160));
+    const auto knobWidth = knobs.getWidth() / 4;
+
+    auto layOutKnob = [] (juce::Rectangle<int> column, juce::Label& label, juce::Slider& slider)
+    {
+        label.setBounds (column.removeFromTop (18));
+        slider.setBounds (column.reduced (4));
+    };
+
+    layOutKnob (knobs.removeFromLeft (knobWidth), thresholdLabel, thresholdSlider);
+    layOutKnob (knobs.removeFromLeft (knobWidth), rangeLabel, rangeSlider);
+    layOutKnob (knobs.removeFromLeft (knobWidth), attackLabel, attackSlider);
+    layOutKnob (knobs, releaseLabel, releaseSlider);
+}
+
+void SidechainPanel::timerCallback()
+{
+    // Keep the switch in step with automation and state changes
+    enableButton.setToggleState (processor.duckingParameter->get(), juce::dontSendNotification);
+
+    displayedKeyDb = juce::jmax (processor.getKeyPeakLevel(), displayedKeyDb - meterFallDb, keyFloorDb);
+    displayedDuckDb = juce::jmax (processor.getDuckingReduction(), displayedDuckDb - meterFallDb, 0.0f);
+
+    repaint();
+}
+
+void SidechainPanel::paint (juce::Graphics& g)
+{
+    g.fillAll (juce::Colours::black);
+
+    g.setColour (juce::Colour (0xff202020));
+    g.fillRect (keyMeterArea);
+    g.fillRect (duckMeterArea);
+
+    // Key level grows up from the floor; the threshold is a line across it
+    const auto keyHeight = juce::jmap (displayedKeyDb, keyFloorDb, 0.0f, 0.0f, (float) keyMeterArea.getHeight());
+    g.setColour (juce::Colours::lightblue);
+    g.fillRect (keyMeterArea.withTop (keyMeterArea.getBottom() - juce::roundToInt (keyHeight)));
+
+    const auto thresholdY = juce::jmap (processor.duckThresholdParameter->get(), keyFloorDb, 0.0f,
+                                        (float) keyMeterArea.getBottom(), (float) keyMeterArea.getY());
+    g.setColour (juce::Colours::white);
+    g.drawHorizontalLine (juce::roundToInt (thresholdY), (float) keyMeterArea.getX(), (float) keyMeterArea.getRight());
+
+    // Ducking depth grows down from the top
+    const auto depth = juce::jlimit (0.0f, 1.0f, displayedDuckDb / duckRangeDb);
+    g.setColour (juce::Colours::orange);
+    g.fillRect (duckMeterArea.withHeight (juce::roundToInt (depth * (float) duckMeterArea.getHeight())));
+
+    g.setFont (11.0f);
+    g.setColour (juce::Colours::grey);
+    g.drawText ("Key", keyMeterArea.withY (keyMeterArea.getY() - 20).withHeight (18), juce::Justification::centred, false);
+    g.drawText ("Duck", duckMeterArea.withY (duckMeterArea.getY() - 20).withHeight (18), juce::Justification::centred, false);
+    g.setColour (juce::Colours::white);
+    g.drawText (displayedKeyDb <= keyFloorDb ? juce::String ("-inf") : juce::String (displayedKeyDb, 1),
+                keyMeterArea.withY (keyMeterArea.getBottom() + 2).withHeight (16), juce::Justification::centred, false);
+    g.drawText (juce::String (-displayedDuckDb, 1),
+                duckMeterArea.withY (duckMeterArea.getBottom() + 2).withHeight (16), juce::Justification::centred, false);
+
+    if (! processor.hasSidechainInput())
+    {
+        g.setColour (juce::Colours::grey);
+        g.drawText ("No sidechain connected - route a key signal to the plugin's sidechain input in the host",
+                    getLocalBounds().reduced (8).removeFromBottom (16).withTrimmedRight (78),
+                    juce::Justification::centredLeft, true);
+    }
+}
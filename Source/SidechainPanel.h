@@ -0,0 +1,48 @@
+/*
+    SidechainPanel.h
+
+    Key meter and ducking controls for the sidechain input.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+class GainMeterAudioProcessor;
+
+//==============================================================================
+/**
+ * Ducking switch, threshold, range, attack and release, with a key level
+ * bar (threshold marked) and a ducking depth bar.
+ *
+ * All settings are processor parameters. The key is metered whenever the
+ * host has the sidechain bus connected, whether or not ducking is on.
+ */
+class SidechainPanel : public juce::Component, private juce::Timer
+{
+public:
+    /** @param processor Owning processor (ducking parameters and key readouts) */
+    explicit SidechainPanel (GainMeterAudioProcessor& processor);
+    ~SidechainPanel() override;
+
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    void timerCallback() override;
+
+    GainMeterAudioProcessor& processor;
+
+    juce::ToggleButton enableButton { "Ducking" };
+    juce::Slider thresholdSlider, rangeSlider, attackSlider, releaseSlider;
+    juce::Label thresholdLabel, rangeLabel, attackLabel, releaseLabel;
+
+    /** Key level and ducking depth bars with their displayed values */
+    juce::Rectangle<int> keyMeterArea, duckMeterArea;
+    float displayedKeyDb = -60.0f;
+    float displayedDuckDb = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SidechainPanel)
+};
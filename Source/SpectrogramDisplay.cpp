@@ -0,0 +1,140 @@
+/*
+    SpectrogramDisplay.cpp
+
+    Implementation of the scrolling spectrogram view.
+
+    Author: Divij Singh
+*/
+
+#include "SpectrogramDisplay.h"
+
+//==============================================================================
+// Lifecycle
+
+SpectrogramDisplay::SpectrogramDisplay (SpectrumAnalyser& a)
+    : analyser (a)
+{
+    // Colour map: black -> blue -> magenta -> orange -> yellow -> white
+    const juce::Colour stops[] = { juce::Colours::black,
+                                   juce::Colour (0xff1a237e),
+                                   juce::Colour (0xff9c27b0),
+                                   juce::Colour (0xffff5722),
+                                   juce::Colour (0xffffeb3b),
+                                   juce::Colours::white };
+    constexpr int numStops = (int) std::size (stops);
+
+    for (int i = 0; i < 256; ++i)
+    {
+        const auto position = (float) i / 255.0f * (float) (numStops - 1);
+        const auto index = juce::jmin ((int) position, numStops - 2);
+        const auto colour = stops[index].interpolatedWith (stops[index + 1], position - (float) index);
+
+        colourMap[(size_t) i] = colour.getPixelARGB();
+    }
+
+    analyser.addConsumer();
+    analyser.setColumnOutputEnabled (true);
+
+    // 60 Hz keeps scrolling smooth at the analyser's ~47 frames per second
+    startTimerHz (60);
+}
+
+SpectrogramDisplay::~SpectrogramDisplay()
+{
+    stopTimer();
+    analyser.setColumnOutputEnabled (false);
+    analyser.removeConsumer();
+}
+
+//==============================================================================
+// Layout
+
+void SpectrogramDisplay::resized()
+{
+    auto area = getLocalBounds().reduced (4);
+
+    // Software image so BitmapData always exposes PixelARGB rows
+    history = area.isEmpty() ? juce::Image()
+                             : juce::Image (juce::Image::ARGB, area.getWidth(), area.getHeight(), true,
+                                            juce::SoftwareImageType());
+
+    if (history.isValid())
+        history.clear (history.getBounds(), juce::Colours::black);
+
+    updateRowLookup();
+}
+
+void SpectrogramDisplay::updateRowLookup()
+{
+    lookupSampleRate = analyser.getSampleRate();
+
+    const auto height = history.isValid() ? history.getHeight() : 0;
+    rowToBin.resize ((size_t) height);
+
+    const auto binWidth = lookupSampleRate / SpectrumResources::fftSize;
+
+    for (int row = 0; row < height; ++row)
+    {
+        // Row 0 is the top of the image, i.e. the highest frequency
+        const auto proportion = 1.0 - (row + 0.5) / height;
+        const auto frequency = minFrequency * std::pow (maxFrequency / minFrequency, proportion);
+
+        rowToBin[(size_t) row] = juce::jlimit (0, SpectrumAnalyser::numBins - 1, (int) std::round (frequency / binWidth));
+    }
+}
+
+//==============================================================================
+// Updating
+
+void SpectrogramDisplay::timerCallback()
+{
+    if (lookupSampleRate != analyser.getSampleRate())
+        updateRowLookup();
+
+    bool changed = false;
+
+    while (analyser.popColumn (column))
+    {
+        appendColumn (column);
+        changed = true;
+    }
+
+    if (changed)
+        repaint();
+}
+
+void SpectrogramDisplay::appendColumn (const SpectrumAnalyser::Column& newColumn)
+{
+    if (! history.isValid())
+        return;
+
+    const auto width = history.getWidth();
+    const auto height = history.getHeight();
+
+    // Scroll the existing history one pixel to the left
+    history.moveImageSection (0, 0, 1, 0, width - 1, height);
+
+    // Write the new column at the right edge through the colour map
+    juce::Image::BitmapData pixels (history, width - 1, 0, 1, height, juce::Image::BitmapData::writeOnly);
+
+    for (int row = 0; row < height; ++row)
+    {
+        const auto level = newColumn[(size_t) rowToBin[(size_t) row]];
+        *reinterpret_cast<juce::PixelARGB*> (pixels.getLinePointer (row)) = colourMap[level];
+    }
+}
+
+//==============================================================================
+// Rendering
+
+void SpectrogramDisplay::paint (juce::Graphics& g)
+{
+    g.fillAll (juce::Colours::black);
+    g.setColour (juce::Colours::darkgrey);
+    g.drawRect (getLocalBounds(), 2);
+
+    // Blit the history as-is; nothing is re-rendered per frame
+    auto area = getLocalBounds().reduced (4);
+    if (history.isValid())
+        g.drawImageAt (history, area.getX(), area.getY());
+}
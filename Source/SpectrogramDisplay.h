@@ -0,0 +1,71 @@
+/*
+    SpectrogramDisplay.h
+
+    Scrolling spectrogram (waterfall) view of the post-gain signal.
+
+    Each analysed FFT frame is written as a single pixel column into a
+    persistent image; older columns are scrolled with moveImageSection()
+    so the history is never redrawn.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "SpectrumAnalyser.h"
+
+//==============================================================================
+/**
+ * Spectrogram with time running right-to-left and log frequency upwards.
+ *
+ * Features:
+ * - Incremental updates: one column written per FFT frame
+ * - Precomputed 256-entry colour map and row-to-bin lookup
+ * - 60 Hz refresh with no per-frame allocation
+ */
+class SpectrogramDisplay : public juce::Component, private juce::Timer
+{
+public:
+    /**
+     * Registers as an analyser consumer and enables its column stream.
+     * @param analyser Analyser owned by the audio processor
+     */
+    explicit SpectrogramDisplay (SpectrumAnalyser& analyser);
+    ~SpectrogramDisplay() override;
+
+    void paint (juce::Graphics& g) override;
+
+    /** Recreates the history image and row lookup for the new size. */
+    void resized() override;
+
+private:
+    /** Scrolls in any new columns and repaints if something changed. */
+    void timerCallback() override;
+
+    /** Shifts the image one pixel left and writes the column at the right edge. */
+    void appendColumn (const SpectrumAnalyser::Column& column);
+
+    /** Maps every image row to an FFT bin for the current sample rate. */
+    void updateRowLookup();
+
+    SpectrumAnalyser& analyser;
+
+    /** Persistent history - only one column changes per frame. */
+    juce::Image history;
+
+    /** FFT bin shown by each image row (top row = highest frequency). */
+    std::vector<int> rowToBin;
+    double lookupSampleRate = 0.0;
+
+    /** Colour for each quantised level (0 = floor, 255 = 0 dBFS). */
+    std::array<juce::PixelARGB, 256> colourMap;
+
+    /** Scratch column reused for every pop. */
+    SpectrumAnalyser::Column column {};
+
+    static constexpr float minFrequency = 20.0f;
+    static constexpr float maxFrequency = 20000.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrogramDisplay)
+};
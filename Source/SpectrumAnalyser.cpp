@@ -0,0 +1,274 @@
+/*
+    SpectrumAnalyser.cpp
+
+    Implementation of the background spectrum analyser.
+
+    Author: Divij Singh
+*/
+
+#include "SpectrumAnalyser.h"
+
+namespace
+{
+    /** Power-domain smoothing factor per frame (higher = slower response). */
+    constexpr float smoothingFactor = 0.7f;
+
+    /** How long a bin peak is held before it starts to fall. */
+    constexpr double peakHoldSeconds = 1.0;
+
+    /** Fall rate of a released bin peak. */
+    constexpr double peakFallDbPerSecond = 12.0;
+}
+
+//==============================================================================
+// Shared Resources
+
+SpectrumResources::SpectrumResources()
+    : fft (fftOrder)
+{
+    juce::dsp::WindowingFunction<float>::fillWindowingTables (window.data(), (size_t) fftSize,
+                                                             juce::dsp::WindowingFunction<float>::hann,
+                                                             false);
+
+    // Undo the window's coherent gain and the single-sided spectrum halving
+    float windowSum = 0.0f;
+    for (auto w : window)
+        windowSum += w;
+
+    magnitudeScale = 2.0f / windowSum;
+}
+
+//==============================================================================
+// Lifecycle
+
+SpectrumAnalyser::SpectrumAnalyser()
+{
+    fifoBuffer.clear();
+    fifoChannelData = { fifoBuffer.getWritePointer (0), fifoBuffer.getWritePointer (1) };
+
+    workingFrame.levelsDb.fill (floorDb);
+    workingFrame.peaksDb.fill (floorDb);
+    publishedFrame = workingFrame;
+    peakHoldDb.fill (floorDb);
+}
+
+SpectrumAnalyser::~SpectrumAnalyser()
+{
+    setActive (false);
+}
+
+void SpectrumAnalyser::prepare (double sampleRate)
+{
+    currentSampleRate.store (sampleRate);
+}
+
+void SpectrumAnalyser::addConsumer()
+{
+    if (++numConsumers == 1)
+        setActive (true);
+}
+
+void SpectrumAnalyser::removeConsumer()
+{
+    jassert (numConsumers > 0);
+
+    if (--numConsumers == 0)
+        setActive (false);
+}
+
+void SpectrumAnalyser::setActive (bool shouldBeActive)
+{
+    if (shouldBeActive == active.load())
+        return;
+
+    if (shouldBeActive)
+    {
+        // Discard whatever was left from a previous editor session
+        fifo.finishedRead (fifo.getNumReady());
+        samplesSinceLastFrame = 0;
+
+        if (pool->addClient (*this))
+            active.store (true);
+    }
+    else
+    {
+        // Audio thread stops pushing first, then the pool lets go of us
+        active.store (false);
+        pool->removeClient (*this);
+    }
+}
+
+//==============================================================================
+// Audio Thread
+
+void SpectrumAnalyser::pushSamples (const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept
+{
+    if (! active.load() || numChannels <= 0)
+        return;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (numSamples, start1, size1, start2, size2);
+
+    // Mono input is duplicated so the consumer always reads two channels
+    for (int channel = 0; channel < 2; ++channel)
+    {
+        const auto* source = buffer.getReadPointer (juce::jmin (channel, numChannels - 1));
+
+        auto* destination = fifoChannelData[(size_t) channel];
+
+        if (size1 > 0)
+            juce::FloatVectorOperations::copy (destination + start1, source, size1);
+
+        if (size2 > 0)
+            juce::FloatVectorOperations::copy (destination + start2, source + size1, size2);
+    }
+
+    // Samples that do not fit are dropped - the display simply skips ahead
+    fifo.finishedWrite (size1 + size2);
+    requestAnalysis();
+}
+
+//==============================================================================
+// Analysis (pool worker)
+
+bool SpectrumAnalyser::runAnalysisSlice()
+{
+    // One frame per slice, so other instances' analysers get their turn
+    while (readFromFifo() > 0)
+    {
+        if (samplesSinceLastFrame >= hopSize)
+        {
+            samplesSinceLastFrame = 0;
+            analyseFrame();
+            return fifo.getNumReady() >= hopSize;
+        }
+    }
+
+    return false;
+}
+
+int SpectrumAnalyser::readFromFifo()
+{
+    const auto toRead = juce::jmin (fifo.getNumReady(), hopSize - samplesSinceLastFrame);
+    if (toRead <= 0)
+        return 0;
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (toRead, start1, size1, start2, size2);
+
+    // Shift history left and append the new samples as a mono mix
+    constexpr auto historySize = (int) SpectrumResources::fftSize;
+    std::memmove (history.data(), history.data() + toRead, sizeof (float) * (size_t) (historySize - toRead));
+
+    auto* destination = history.data() + historySize - toRead;
+    const auto* left = fifoChannelData[0];
+    const auto* right = fifoChannelData[1];
+
+    for (int i = 0; i < size1; ++i)
+        destination[i] = 0.5f * (left[start1 + i] + right[start1 + i]);
+
+    for (int i = 0; i < size2; ++i)
+        destination[size1 + i] = 0.5f * (left[start2 + i] + right[start2 + i]);
+
+    fifo.finishedRead (size1 + size2);
+    samplesSinceLastFrame += toRead;
+    return toRead;
+}
+
+void SpectrumAnalyser::analyseFrame()
+{
+    const auto& shared = *resources;
+    const auto sampleRate = currentSampleRate.load();
+
+    // Window into the first half of the FFT buffer, zero the rest
+    juce::FloatVectorOperations::multiply (fftData.data(), history.data(), shared.window.data(), SpectrumResources::fftSize);
+    std::fill (fftData.begin() + SpectrumResources::fftSize, fftData.end(), 0.0f);
+
+    shared.fft.performFrequencyOnlyForwardTransform (fftData.data(), true);
+
+    // Convert frame-based timings to frame counts at the current rate
+    const auto framesPerSecond = sampleRate / hopSize;
+    const auto holdFrames = static_cast<int> (peakHoldSeconds * framesPerSecond);
+    const auto fallPerFrame = static_cast<float> (peakFallDbPerSecond / framesPerSecond);
+
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        const auto magnitude = fftData[(size_t) bin] * shared.magnitudeScale;
+        const auto power = magnitude * magnitude;
+
+        // Exponential smoothing in the power domain
+        auto& smoothed = smoothedPower[(size_t) bin];
+        smoothed = smoothingFactor * smoothed + (1.0f - smoothingFactor) * power;
+
+        const auto levelDb = juce::jmax (floorDb, 10.0f * std::log10 (smoothed + 1.0e-20f));
+        workingFrame.levelsDb[(size_t) bin] = levelDb;
+
+        // Peak hold: latch new maxima, hold, then fall at a fixed rate
+        auto& held = peakHoldDb[(size_t) bin];
+        auto& framesLeft = peakHoldFramesLeft[(size_t) bin];
+
+        if (levelDb >= held)
+        {
+            held = levelDb;
+            framesLeft = holdFrames;
+        }
+        else if (framesLeft > 0)
+        {
+            --framesLeft;
+        }
+        else
+        {
+            held = juce::jmax (levelDb, held - fallPerFrame);
+        }
+
+        workingFrame.peaksDb[(size_t) bin] = held;
+    }
+
+    workingFrame.sampleRate = sampleRate;
+    ++workingFrame.frameNumber;
+
+    // Quantised column for the spectrogram; dropped if the view falls behind
+    if (columnOutputEnabled.load())
+    {
+        int start1, size1, start2, size2;
+        columnFifo.prepareToWrite (1, start1, size1, start2, size2);
+
+        if (size1 + size2 > 0)
+        {
+            auto& column = columns[(size_t) (size1 > 0 ? start1 : start2)];
+
+            for (int bin = 0; bin < numBins; ++bin)
+            {
+                const auto proportion = (workingFrame.levelsDb[(size_t) bin] - floorDb) / -floorDb;
+                column[(size_t) bin] = (juce::uint8) juce::jlimit (0, 255, juce::roundToInt (proportion * 255.0f));
+            }
+
+            columnFifo.finishedWrite (1);
+        }
+    }
+
+    const juce::SpinLock::ScopedLockType lock (frameLock);
+    publishedFrame = workingFrame;
+}
+
+//==============================================================================
+// Message Thread
+
+void SpectrumAnalyser::getLatestFrame (Frame& destination) const
+{
+    const juce::SpinLock::ScopedLockType lock (frameLock);
+    destination = publishedFrame;
+}
+
+bool SpectrumAnalyser::popColumn (Column& destination)
+{
+    int start1, size1, start2, size2;
+    columnFifo.prepareToRead (1, start1, size1, start2, size2);
+
+    if (size1 + size2 == 0)
+        return false;
+
+    destination = columns[(size_t) (size1 > 0 ? start1 : start2)];
+    columnFifo.finishedRead (1);
+    return true;
+}
@@ -0,0 +1,167 @@
+/*
+    SpectrumAnalyser.h
+
+    Background FFT spectrum analysis of the post-gain signal.
+
+    The audio thread only copies samples into a preallocated FIFO. A worker
+    of the shared AnalysisThreadPool windows and transforms them, applies
+    per-bin smoothing and peak hold, and publishes the latest frame for the
+    editor. Analysis only runs while an editor view is consuming it.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_dsp/juce_dsp.h>
+#include <array>
+#include "AnalysisThreadPool.h"
+
+//==============================================================================
+/**
+ * FFT plan and window table shared by every analyser in the process.
+ *
+ * Held through juce::SharedResourcePointer so a session with many
+ * instances builds the tables once. Both members are read-only after
+ * construction, so any number of threads may use them concurrently.
+ */
+struct SpectrumResources
+{
+    static constexpr int fftOrder = 12;
+    static constexpr int fftSize = 1 << fftOrder;     // 4096 points
+    static constexpr int numBins = fftSize / 2 + 1;   // DC to Nyquist
+
+    SpectrumResources();
+
+    /** Forward FFT plan (performFrequencyOnlyForwardTransform is const). */
+    const juce::dsp::FFT fft;
+
+    /** Hann window, one value per FFT input sample. */
+    std::array<float, fftSize> window;
+
+    /** Scales raw bin magnitudes so a full-scale sine reads 0 dBFS. */
+    float magnitudeScale = 1.0f;
+};
+
+//==============================================================================
+/**
+ * Spectrum analyser fed by a lock-free sample FIFO.
+ *
+ * Thread roles:
+ * - Audio thread: pushSamples() - a bounded memcpy and a flag for the pool
+ * - Pool worker: windowed FFT, smoothing, peak hold (one frame per slice)
+ * - Message thread: addConsumer()/removeConsumer(), getLatestFrame(), popColumn()
+ */
+class SpectrumAnalyser : private AnalysisThreadPool::Client
+{
+public:
+    static constexpr int numBins = SpectrumResources::numBins;
+    static constexpr int hopSize = SpectrumResources::fftSize / 4; // 75% overlap
+    static constexpr float floorDb = -120.0f;
+
+    /** One published analysis frame. */
+    struct Frame
+    {
+        std::array<float, numBins> levelsDb;    // Smoothed level per bin
+        std::array<float, numBins> peaksDb;     // Held peak per bin
+        double sampleRate = 44100.0;
+        juce::uint32 frameNumber = 0;           // Increments with every new frame
+    };
+
+    SpectrumAnalyser();
+    ~SpectrumAnalyser() override;
+
+    /** Stores the sample rate used for bin frequencies and decay timing. */
+    void prepare (double sampleRate);
+
+    /**
+     * Copies post-gain samples into the FIFO (audio thread).
+     * Does nothing while no editor is consuming the analysis.
+     */
+    void pushSamples (const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept;
+
+    /**
+     * Registers a view that consumes analysis results (message thread).
+     * The analyser is served by the shared pool while at least one consumer is registered.
+     */
+    void addConsumer();
+
+    /** Unregisters a view added with addConsumer() (message thread). */
+    void removeConsumer();
+
+    /** True while an editor is consuming frames. */
+    bool isActive() const noexcept { return active.load(); }
+
+    /** Copies the most recent frame (message thread). */
+    void getLatestFrame (Frame& destination) const;
+
+    //==============================================================================
+    // Spectrogram Columns
+
+    /** One analysed frame quantised to 8 bits per bin (0 = floorDb, 255 = 0 dBFS). */
+    using Column = std::array<juce::uint8, numBins>;
+
+    /**
+     * Enables the per-frame column stream (message thread).
+     * Only views that need every frame, such as the spectrogram, turn this on.
+     */
+    void setColumnOutputEnabled (bool shouldBeEnabled) noexcept { columnOutputEnabled.store (shouldBeEnabled); }
+
+    /**
+     * Takes the oldest unread column (message thread).
+     * @return false if no column is waiting
+     */
+    bool popColumn (Column& destination);
+
+    /** Sample rate of the analysed signal. */
+    double getSampleRate() const noexcept { return currentSampleRate.load(); }
+
+private:
+    /** Analyses at most one frame from the FIFO. @return true if another hop is ready */
+    bool runAnalysisSlice() override;
+
+    /** Reads up to one hop from the FIFO into the mono history. @return samples read */
+    int readFromFifo();
+
+    /** Windows the history, runs the FFT and updates smoothing/peak hold. */
+    void analyseFrame();
+
+    /** Registers with or leaves the analysis pool. */
+    void setActive (bool shouldBeActive);
+
+    juce::SharedResourcePointer<SpectrumResources> resources;
+    juce::SharedResourcePointer<AnalysisThreadPool> pool;
+
+    // Audio -> analysis sample FIFO (stereo, fixed capacity)
+    static constexpr int fifoCapacity = 8 * SpectrumResources::fftSize;
+    juce::AbstractFifo fifo { fifoCapacity };
+    juce::AudioBuffer<float> fifoBuffer { 2, fifoCapacity };
+    std::array<float*, 2> fifoChannelData {};   // Cached so neither thread touches the buffer object
+
+    // Analysis-thread state
+    std::array<float, SpectrumResources::fftSize> history {};     // Most recent mono samples
+    std::array<float, 2 * SpectrumResources::fftSize> fftData {}; // FFT working buffer
+    std::array<float, numBins> smoothedPower {};
+    std::array<float, numBins> peakHoldDb {};
+    std::array<int, numBins> peakHoldFramesLeft {};
+    int samplesSinceLastFrame = 0;
+    Frame workingFrame;
+
+    // Published frame, guarded against the editor copy
+    Frame publishedFrame;
+    mutable juce::SpinLock frameLock;
+
+    // Analysis thread -> message thread column stream for the spectrogram
+    static constexpr int columnFifoSize = 32;
+    juce::AbstractFifo columnFifo { columnFifoSize };
+    std::array<Column, columnFifoSize> columns {};
+    std::atomic<bool> columnOutputEnabled { false };
+
+    int numConsumers = 0;
+    std::atomic<bool> active { false };
+    std::atomic<double> currentSampleRate { 44100.0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumAnalyser)
+};
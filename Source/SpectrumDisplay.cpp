@@ -0,0 +1,127 @@
+/*
+    SpectrumDisplay.cpp
+
+    Implementation of the spectrum analyser view.
+
+    Author: Divij Singh
+*/
+
+#include "SpectrumDisplay.h"
+
+//==============================================================================
+// Lifecycle
+
+SpectrumDisplay::SpectrumDisplay (SpectrumAnalyser& a)
+    : analyser (a)
+{
+    frame.levelsDb.fill (SpectrumAnalyser::floorDb);
+    frame.peaksDb.fill (SpectrumAnalyser::floorDb);
+
+    // Analysis only costs CPU while somebody is looking at it
+    analyser.addConsumer();
+
+    // Analyser produces roughly 45 frames per second at 48 kHz
+    startTimerHz (30);
+}
+
+SpectrumDisplay::~SpectrumDisplay()
+{
+    stopTimer();
+    analyser.removeConsumer();
+}
+
+void SpectrumDisplay::timerCallback()
+{
+    analyser.getLatestFrame (frame);
+
+    if (frame.frameNumber != lastFrameNumber)
+    {
+        lastFrameNumber = frame.frameNumber;
+        repaint();
+    }
+}
+
+//==============================================================================
+// Rendering
+
+float SpectrumDisplay::frequencyToX (float frequency, juce::Rectangle<float> area) const
+{
+    const auto proportion = std::log (frequency / minFrequency) / std::log (maxFrequency / minFrequency);
+    return area.getX() + area.getWidth() * proportion;
+}
+
+juce::Path SpectrumDisplay::createPath (const std::array<float, SpectrumAnalyser::numBins>& levelsDb,
+                                        juce::Rectangle<float> area, bool closed) const
+{
+    juce::Path path;
+
+    const auto binWidth = static_cast<float> (frame.sampleRate / SpectrumResources::fftSize);
+    const auto topFrequency = juce::jmin (maxFrequency, static_cast<float> (frame.sampleRate * 0.5));
+    const auto width = juce::roundToInt (area.getWidth());
+
+    auto levelToY = [area] (float levelDb)
+    {
+        return juce::jmap (juce::jlimit (minDb, maxDb, levelDb), minDb, maxDb, area.getBottom(), area.getY());
+    };
+
+    if (closed)
+        path.startNewSubPath (area.getX(), area.getBottom());
+
+    // One point per pixel column: the loudest bin that falls into it
+    for (int x = 0; x < width; ++x)
+    {
+        const auto f0 = minFrequency * std::pow (maxFrequency / minFrequency, (float) x / (float) width);
+        const auto f1 = minFrequency * std::pow (maxFrequency / minFrequency, (float) (x + 1) / (float) width);
+
+        if (f0 > topFrequency)
+            break;
+
+        const auto firstBin = juce::jlimit (1, SpectrumAnalyser::numBins - 1, (int) (f0 / binWidth));
+        const auto lastBin  = juce::jlimit (firstBin, SpectrumAnalyser::numBins - 1, (int) (f1 / binWidth));
+
+        auto levelDb = levelsDb[(size_t) firstBin];
+        for (int bin = firstBin + 1; bin <= lastBin; ++bin)
+            levelDb = juce::jmax (levelDb, levelsDb[(size_t) bin]);
+
+        const auto px = area.getX() + (float) x;
+
+        if (x == 0 && ! closed)
+            path.startNewSubPath (px, levelToY (levelDb));
+        else
+            path.lineTo (px, levelToY (levelDb));
+    }
+
+    if (closed)
+    {
+        path.lineTo (path.getCurrentPosition().x, area.getBottom());
+        path.closeSubPath();
+    }
+
+    return path;
+}
+
+void SpectrumDisplay::paint (juce::Graphics& g)
+{
+    g.fillAll (juce::Colours::black);
+    g.setColour (juce::Colours::darkgrey);
+    g.drawRect (getLocalBounds(), 2);
+
+    auto area = getLocalBounds().reduced (4).toFloat();
+
+    // Grid: decades on the frequency axis, 12 dB steps on the level axis
+    g.setColour (juce::Colour (0xff303030));
+    for (auto frequency : { 100.0f, 1000.0f, 10000.0f })
+        g.drawVerticalLine (juce::roundToInt (frequencyToX (frequency, area)), area.getY(), area.getBottom());
+
+    for (auto levelDb = maxDb - 12.0f; levelDb > minDb; levelDb -= 12.0f)
+        g.drawHorizontalLine (juce::roundToInt (juce::jmap (levelDb, minDb, maxDb, area.getBottom(), area.getY())),
+                              area.getX(), area.getRight());
+
+    // Smoothed spectrum as a filled shape
+    g.setColour (juce::Colours::green.withAlpha (0.6f));
+    g.fillPath (createPath (frame.levelsDb, area, true));
+
+    // Peak hold as a thin outline above it
+    g.setColour (juce::Colours::yellow);
+    g.strokePath (createPath (frame.peaksDb, area, false), juce::PathStrokeType (1.0f));
+}
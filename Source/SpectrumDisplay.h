@@ -0,0 +1,58 @@
+/*
+    SpectrumDisplay.h
+
+    Editor component drawing the latest spectrum analyser frame.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "SpectrumAnalyser.h"
+
+//==============================================================================
+/**
+ * Log-frequency spectrum view of the post-gain signal.
+ *
+ * Features:
+ * - Smoothed spectrum fill with a per-bin peak-hold line
+ * - 20 Hz - 20 kHz logarithmic frequency axis, -90 to 0 dBFS range
+ * - Keeps the analyser running only while the component exists
+ */
+class SpectrumDisplay : public juce::Component, private juce::Timer
+{
+public:
+    /**
+     * Starts the analyser; it is stopped again when the display is destroyed.
+     * @param analyser Analyser owned by the audio processor
+     */
+    explicit SpectrumDisplay (SpectrumAnalyser& analyser);
+    ~SpectrumDisplay() override;
+
+    void paint (juce::Graphics& g) override;
+
+private:
+    /** Copies a new frame when one is available and repaints. */
+    void timerCallback() override;
+
+    /** Builds a path through per-pixel maxima of the given bin levels. */
+    juce::Path createPath (const std::array<float, SpectrumAnalyser::numBins>& levelsDb,
+                           juce::Rectangle<float> area, bool closed) const;
+
+    /** Maps a frequency to an x position on the logarithmic axis. */
+    float frequencyToX (float frequency, juce::Rectangle<float> area) const;
+
+    SpectrumAnalyser& analyser;
+
+    /** Local copy so painting never holds the analyser's lock. */
+    SpectrumAnalyser::Frame frame;
+    juce::uint32 lastFrameNumber = 0;
+
+    static constexpr float minFrequency = 20.0f;
+    static constexpr float maxFrequency = 20000.0f;
+    static constexpr float minDb = -90.0f;
+    static constexpr float maxDb = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumDisplay)
+};
@@ -0,0 +1,277 @@
+/*
+    StatisticsDisplay.cpp
+
+    Implementation of the session statistics view.
+
+    Author: Divij Singh
+*/
+
+#include "StatisticsDisplay.h"
+#include "PluginProcessor.h"
+
+namespace
+{
+    /** Width of the text column to the right of the histogram. */
+    constexpr int readoutWidth = 180;
+
+    /** dBFS range shown on the histogram's horizontal axis. */
+    constexpr float minDisplayDb = -96.0f;
+    constexpr float maxDisplayDb = 6.0f;
+
+    juce::String formatLufs (float lufs)
+    {
+        return lufs <= LoudnessMeter::silenceLufs ? juce::String ("-inf") : juce::String (lufs, 1);
+    }
+}
+
+//==============================================================================
+// Lifecycle
+
+StatisticsDisplay::StatisticsDisplay (GainMeterAudioProcessor& p)
+    : processor (p)
+{
+    resetButton.onClick = [this] { processor.resetSessionStatistics(); repaint(); };
+    exportButton.onClick = [this] { exportToFile(); };
+    logButton.onClick = [this] { toggleLogging(); };
+
+    logFormatBox.addItem ("CSV", 1);
+    logFormatBox.addItem ("JSON Lines", 2);
+    logFormatBox.setSelectedId (1, juce::dontSendNotification);
+
+    addAndMakeVisible (resetButton);
+    addAndMakeVisible (exportButton);
+    addAndMakeVisible (logButton);
+    addAndMakeVisible (logFormatBox);
+
+    startTimerHz (10);
+}
+
+StatisticsDisplay::~StatisticsDisplay()
+{
+    stopTimer();
+}
+
+//==============================================================================
+// Layout
+
+void StatisticsDisplay::resized()
+{
+    auto area = getLocalBounds().reduced (4);
+
+    readoutArea = area.removeFromRight (readoutWidth);
+    histogramArea = area.withTrimmedRight (4);
+
+    auto buttons = readoutArea.removeFromBottom (24);
+    resetButton.setBounds (buttons.removeFromLeft (buttons.getWidth() / 2).reduced (2, 0));
+    exportButton.setBounds (buttons.reduced (2, 0));
+
+    readoutArea.removeFromBottom (4);
+    auto logRow = readoutArea.removeFromBottom (24);
+    logFormatBox.setBounds (logRow.removeFromLeft (logRow.getWidth() / 2).reduced (2, 0));
+    logButton.setBounds (logRow.reduced (2, 0));
+}
+
+void StatisticsDisplay::timerCallback()
+{
+    const auto logging = processor.getMeterLogWriter().isActive();
+    logButton.setButtonText (logging ? "Stop Log" : "Start Log");
+    logFormatBox.setEnabled (! logging);
+
+    repaint();
+}
+
+//==============================================================================
+// Export
+
+void StatisticsDisplay::exportToFile()
+{
+    fileChooser = std::make_unique<juce::FileChooser> ("Export statistics",
+                                                       juce::File::getSpecialLocation (juce::File::userDocumentsDirectory)
+                                                           .getChildFile ("GainMeter Statistics.csv"),
+                                                       "*.csv");
+
+    const auto flags = juce::FileBrowserComponent::saveMode
+                     | juce::FileBrowserComponent::canSelectFiles
+                     | juce::FileBrowserComponent::warnAboutOverwriting;
+
+    fileChooser->launchAsync (flags, [this] (const juce::FileChooser& chooser)
+    {
+        const auto file = chooser.getResult();
+        if (file == juce::File())
+            return;
+
+        if (! processor.exportStatistics (file))
+            juce::AlertWindow::showMessageBoxAsync (juce::MessageBoxIconType::WarningIcon, "Export failed",
+                                                    "Could not write " + file.getFullPathName());
+    });
+}
+
+void StatisticsDisplay::toggleLogging()
+{
+    if (processor.getMeterLogWriter().isActive())
+    {
+        processor.stopMeterLog();
+        return;
+    }
+
+    fileChooser = std::make_unique<juce::FileChooser> ("Choose log folder",
+                                                       juce::File::getSpecialLocation (juce::File::userDocumentsDirectory));
+
+    const auto flags = juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectDirectories;
+
+    fileChooser->launchAsync (flags, [this] (const juce::FileChooser& chooser)
+    {
+        const auto directory = chooser.getResult();
+        if (directory == juce::File())
+            return;
+
+        const auto format = logFormatBox.getSelectedId() == 2 ? MeterLogWriter::Format::jsonLines
+                                                               : MeterLogWriter::Format::csv;
+
+        if (! processor.startMeterLog (directory, format))
+            juce::AlertWindow::showMessageBoxAsync (juce::MessageBoxIconType::WarningIcon, "Logging failed",
+                                                    "Could not create a log file in " + directory.getFullPathName());
+    });
+}
+
+//==============================================================================
+// Rendering
+
+void StatisticsDisplay::paint (juce::Graphics& g)
+{
+    g.fillAll (juce::Colours::black);
+    g.setColour (juce::Colours::darkgrey);
+    g.drawRect (getLocalBounds(), 2);
+
+    const auto& statistics = processor.getLevelStatistics();
+    const auto numChannels = statistics.getNumChannels();
+
+    //==============================================================================
+    // Histogram (channels summed, log-scaled counts)
+
+    const auto plot = histogramArea.toFloat();
+    std::array<double, LevelStatistics::numBins> counts {};
+    double maxCount = 0.0;
+
+    for (int bin = 0; bin < LevelStatistics::numBins; ++bin)
+    {
+        for (int channel = 0; channel < numChannels; ++channel)
+            counts[(size_t) bin] += statistics.getTotals (channel).histogram[(size_t) bin];
+
+        maxCount = juce::jmax (maxCount, counts[(size_t) bin]);
+    }
+
+    auto dbToX = [plot] (float db)
+    {
+        return juce::jmap (juce::jlimit (minDisplayDb, maxDisplayDb, db), minDisplayDb, maxDisplayDb,
+                           plot.getX(), plot.getRight());
+    };
+
+    // 12 dB grid
+    g.setFont (10.0f);
+    for (auto db = -96.0f; db <= 0.0f; db += 12.0f)
+    {
+        const auto x = dbToX (db);
+        g.setColour (juce::Colour (0xff303030));
+        g.drawVerticalLine (juce::roundToInt (x), plot.getY(), plot.getBottom());
+        g.setColour (juce::Colours::grey);
+        g.drawText (juce::String ((int) db), juce::Rectangle<float> (x + 2.0f, plot.getY(), 30.0f, 12.0f),
+                    juce::Justification::centredLeft, false);
+    }
+
+    if (maxCount > 0.0)
+    {
+        const auto logMax = std::log10 (1.0 + maxCount);
+
+        for (int bin = 0; bin < LevelStatistics::numBins; ++bin)
+        {
+            const auto count = counts[(size_t) bin];
+            if (count <= 0.0)
+                continue;
+
+            const auto lower = LevelStatistics::getBinLowerEdgeDb (bin);
+            const auto upper = LevelStatistics::getBinLowerEdgeDb (bin + 1);
+            if (upper <= minDisplayDb || lower >= maxDisplayDb)
+                continue;
+
+            const auto height = (float) (std::log10 (1.0 + count) / logMax) * plot.getHeight();
+
+            // Bins at or above full scale are clipped samples
+            g.setColour (lower >= 0.0f ? juce::Colours::red : juce::Colours::lightgreen.withAlpha (0.8f));
+            g.fillRect (juce::Rectangle<float>::leftTopRightBottom (dbToX (lower), plot.getBottom() - height,
+                                                                    dbToX (upper) - 1.0f, plot.getBottom()));
+        }
+    }
+    else
+    {
+        g.setColour (juce::Colours::grey);
+        g.setFont (14.0f);
+        g.drawText ("No signal yet", histogramArea, juce::Justification::centred, false);
+    }
+
+    //==============================================================================
+    // Readouts
+
+    const auto& loudness = processor.getLoudnessMeter();
+    const auto integrated = loudness.getIntegratedLoudness();
+    const auto truePeak = processor.getTruePeakHoldLevel();
+
+    auto text = readoutArea.reduced (6, 4);
+    g.setFont (13.0f);
+
+    auto addLine = [&g, &text] (const juce::String& name, const juce::String& value)
+    {
+        auto line = text.removeFromTop (18);
+        g.setColour (juce::Colours::grey);
+        g.drawText (name, line, juce::Justification::centredLeft, false);
+        g.setColour (juce::Colours::white);
+        g.drawText (value, line, juce::Justification::centredRight, false);
+    };
+
+    addLine ("Momentary", formatLufs (loudness.getMomentaryLoudness()) + " LUFS");
+    addLine ("Short-term", formatLufs (loudness.getShortTermLoudness()) + " LUFS");
+    addLine ("Integrated", formatLufs (integrated) + " LUFS");
+    addLine ("True peak", juce::String (truePeak, 1) + " dBTP");
+    addLine ("PLR", integrated > LoudnessMeter::silenceLufs ? juce::String (truePeak - integrated, 1) + " LU"
+                                                             : juce::String ("-"));
+    addLine ("DSP kernels", MeterKernels::getActive().name);
+    addLine ("DSP memory", juce::File::descriptionOfSizeInBytes ((juce::int64) processor.getDspMemoryBytes()));
+
+    // Explain a refused GAINMETER_KERNELS override
+    const auto kernelDescription = MeterKernels::getDescription();
+    if (kernelDescription != MeterKernels::getActive().name)
+    {
+        g.setColour (juce::Colours::grey);
+        g.setFont (11.0f);
+        g.drawFittedText (kernelDescription, text.removeFromTop (28), juce::Justification::topLeft, 2);
+        g.setFont (13.0f);
+    }
+
+    text.removeFromTop (6);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto& totals = statistics.getTotals (channel);
+        if (totals.numSamples == 0)
+            continue;
+
+        const auto prefix = numChannels > 1 ? (channel == 0 ? "L " : "R ") : "";
+        const auto rms = std::sqrt (totals.sumSquares / (double) totals.numSamples);
+        const auto dcOffset = totals.sum / (double) totals.numSamples;
+
+        addLine (juce::String (prefix) + "Crest",
+                 rms > 0.0 ? juce::String (juce::Decibels::gainToDecibels (totals.peak / rms), 1) + " dB"
+                           : juce::String ("-"));
+        addLine (juce::String (prefix) + "DC", juce::String (dcOffset * 100.0, 3) + " %");
+    }
+
+    const auto logFile = processor.getMeterLogWriter().getCurrentFile();
+    if (logFile != juce::File())
+    {
+        text.removeFromTop (6);
+        g.setColour (juce::Colours::orange);
+        g.setFont (11.0f);
+        g.drawFittedText ("Logging to " + logFile.getFileName(), text.removeFromTop (28),
+                          juce::Justification::topLeft, 2);
+    }
+}
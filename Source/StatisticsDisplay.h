@@ -0,0 +1,58 @@
+/*
+    StatisticsDisplay.h
+
+    Session level statistics: dBFS histogram, loudness readouts,
+    peak-to-loudness ratio, crest factor and DC offset.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+
+class GainMeterAudioProcessor;
+
+//==============================================================================
+/**
+ * Histogram of sample levels since the last reset, with a readout column.
+ *
+ * Features:
+ * - Quarter-octave (1.5 dB) bars from -144 to +12 dBFS, log-scaled counts
+ * - Momentary, short-term and integrated loudness, true peak and PLR
+ * - Per-channel crest factor and DC offset
+ * - Reset and CSV export buttons
+ * - Start/stop of the background compliance log (CSV or JSON Lines)
+ */
+class StatisticsDisplay : public juce::Component, private juce::Timer
+{
+public:
+    /** @param processor Owning processor (statistics, reset and export) */
+    explicit StatisticsDisplay (GainMeterAudioProcessor& processor);
+    ~StatisticsDisplay() override;
+
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    /** Repaints at a relaxed rate - the statistics change slowly. */
+    void timerCallback() override;
+
+    /** Opens a save dialog and writes the statistics as CSV. */
+    void exportToFile();
+
+    /** Stops a running log, or asks for a directory and starts one. */
+    void toggleLogging();
+
+    GainMeterAudioProcessor& processor;
+
+    juce::TextButton resetButton { "Reset" };
+    juce::TextButton exportButton { "Export CSV" };
+    juce::TextButton logButton { "Start Log" };
+    juce::ComboBox logFormatBox;
+    std::unique_ptr<juce::FileChooser> fileChooser;
+
+    juce::Rectangle<int> histogramArea, readoutArea;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StatisticsDisplay)
+};
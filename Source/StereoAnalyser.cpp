@@ -0,0 +1,136 @@
+/*
+    StereoAnalyser.cpp
+
+    Implementation of the correlation meter and goniometer feed.
+
+    Author: Divij Singh
+*/
+
+#include "StereoAnalyser.h"
+
+//==============================================================================
+// Preparation
+
+int StereoAnalyser::getWindowLength (double sampleRate) noexcept
+{
+    return juce::jmax (1, juce::roundToInt (sampleRate * windowSeconds));
+}
+
+size_t StereoAnalyser::getArenaBytes (double sampleRate) noexcept
+{
+    return DspArena::getBytesFor<Products> ((size_t) getWindowLength (sampleRate));
+}
+
+void StereoAnalyser::prepare (double sampleRate, DspArena& arena)
+{
+    windowLength = getWindowLength (sampleRate);
+    window = arena.allocate<Products> ((size_t) windowLength);
+
+    if (window == nullptr)
+        windowLength = 0;
+
+    windowPosition = 0;
+    sumLeftRight = sumLeftSquared = sumRightSquared = 0.0;
+
+    decimation = juce::jmax (1, juce::roundToInt (sampleRate / pointsPerSecond));
+    decimationCounter = 0;
+}
+
+void StereoAnalyser::releaseStorage() noexcept
+{
+    window = nullptr;
+    windowLength = 0;
+}
+
+void StereoAnalyser::resynchronise() noexcept
+{
+    sumLeftRight = sumLeftSquared = sumRightSquared = 0.0;
+
+    for (int i = 0; i < windowLength; ++i)
+    {
+        const auto& products = window[i];
+        sumLeftRight += products.leftRight;
+        sumLeftSquared += products.leftSquared;
+        sumRightSquared += products.rightSquared;
+    }
+}
+
+//==============================================================================
+// Audio Thread
+
+void StereoAnalyser::process (const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept
+{
+    if (numChannels < 2 || window == nullptr)
+    {
+        stereo.store (false);
+        correlation.store (1.0f);
+        return;
+    }
+
+    stereo.store (true);
+
+    const auto* left = buffer.getReadPointer (0);
+    const auto* right = buffer.getReadPointer (1);
+
+    int start1 = 0, size1 = 0, start2 = 0, size2 = 0;
+    pointFifo.prepareToWrite (numSamples / decimation + 1, start1, size1, start2, size2);
+    int numPointsWritten = 0;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const auto l = left[i];
+        const auto r = right[i];
+
+        // Replace the oldest products in the window: O(1) per sample
+        auto& slot = window[windowPosition];
+        const Products newest { l * r, l * l, r * r };
+
+        sumLeftRight    += (double) newest.leftRight    - slot.leftRight;
+        sumLeftSquared  += (double) newest.leftSquared  - slot.leftSquared;
+        sumRightSquared += (double) newest.rightSquared - slot.rightSquared;
+        slot = newest;
+
+        if (++windowPosition == windowLength)
+        {
+            windowPosition = 0;
+            resynchronise(); // Amortised O(1): once per window length
+        }
+
+        // Decimated goniometer feed; points beyond the FIFO space are dropped
+        if (++decimationCounter >= decimation)
+        {
+            decimationCounter = 0;
+
+            if (numPointsWritten < size1)
+                points[(size_t) (start1 + numPointsWritten)] = { l, r };
+            else if (numPointsWritten < size1 + size2)
+                points[(size_t) (start2 + numPointsWritten - size1)] = { l, r };
+            else
+                continue;
+
+            ++numPointsWritten;
+        }
+    }
+
+    pointFifo.finishedWrite (numPointsWritten);
+
+    // Silence has no defined phase relationship - report it as neutral
+    const auto denominator = std::sqrt (sumLeftSquared * sumRightSquared);
+    correlation.store (denominator > 1.0e-12 ? (float) juce::jlimit (-1.0, 1.0, sumLeftRight / denominator)
+                                             : 0.0f);
+}
+
+//==============================================================================
+// Message Thread
+
+int StereoAnalyser::popPoints (Point* destination, int maxPoints)
+{
+    int start1, size1, start2, size2;
+    pointFifo.prepareToRead (juce::jmin (maxPoints, pointFifo.getNumReady()), start1, size1, start2, size2);
+
+    std::copy_n (points.begin() + start1, size1, destination);
+    std::copy_n (points.begin() + start2, size2, destination + size1);
+
+    pointFifo.finishedRead (size1 + size2);
+    return size1 + size2;
+}
@@ -0,0 +1,103 @@
+/*
+    StereoAnalyser.h
+
+    Phase correlation and goniometer data for stereo buses.
+
+    Correlation is computed on the audio thread from running sums of L*R,
+    L^2 and R^2 over a short sliding window at constant cost per sample.
+    Goniometer points are decimated into a small lock-free FIFO for the
+    editor.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include "DspArena.h"
+
+//==============================================================================
+/**
+ * Sliding-window stereo correlation meter with goniometer point output.
+ *
+ * Thread roles:
+ * - Audio thread: process()
+ * - Message thread: getCorrelation(), popPoints()
+ */
+class StereoAnalyser
+{
+public:
+    /** One goniometer sample (left/right amplitude). */
+    struct Point
+    {
+        float left = 0.0f;
+        float right = 0.0f;
+    };
+
+    /** Length of the correlation window. */
+    static constexpr double windowSeconds = 0.2;
+
+    /** Goniometer points per second regardless of sample rate. */
+    static constexpr double pointsPerSecond = 6000.0;
+
+    /** Arena bytes prepare() takes at a sample rate. */
+    static size_t getArenaBytes (double sampleRate) noexcept;
+
+    /** Takes the correlation window for the sample rate from the instance's arena (not real-time safe). */
+    void prepare (double sampleRate, DspArena& arena);
+
+    /** Forgets the window before the arena is released; process() then reports mono. */
+    void releaseStorage() noexcept;
+
+    /**
+     * Updates the running sums and decimates goniometer points (audio thread).
+     * Mono buffers publish a correlation of +1 and produce no points.
+     */
+    void process (const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept;
+
+    /** Correlation over the last window: -1 (out of phase) ... +1 (mono). */
+    float getCorrelation() const noexcept { return correlation.load(); }
+
+    /** True once a stereo signal has been processed. */
+    bool isStereo() const noexcept { return stereo.load(); }
+
+    /**
+     * Copies up to maxPoints pending goniometer points (message thread).
+     * @return Number of points copied
+     */
+    int popPoints (Point* destination, int maxPoints);
+
+private:
+    // Sliding window of per-sample products; sums are kept in double to limit drift
+    struct Products
+    {
+        float leftRight = 0.0f;
+        float leftSquared = 0.0f;
+        float rightSquared = 0.0f;
+    };
+
+    /** Recomputes the running sums exactly from the window (once per window length). */
+    void resynchronise() noexcept;
+
+    static int getWindowLength (double sampleRate) noexcept;
+
+    Products* window = nullptr; // Arena storage
+    int windowLength = 0;
+    int windowPosition = 0;
+    double sumLeftRight = 0.0;
+    double sumLeftSquared = 0.0;
+    double sumRightSquared = 0.0;
+
+    int decimation = 8;
+    int decimationCounter = 0;
+
+    std::atomic<float> correlation { 1.0f };
+    std::atomic<bool> stereo { false };
+
+    // Audio -> message thread goniometer point FIFO
+    static constexpr int pointFifoSize = 4096;
+    juce::AbstractFifo pointFifo { pointFifoSize };
+    std::array<Point, pointFifoSize> points {};
+};
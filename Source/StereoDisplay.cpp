@@ -0,0 +1,169 @@
+/*
+    StereoDisplay.cpp
+
+    Implementation of the goniometer and correlation meter.
+
+    Author: Divij Singh
+*/
+
+#include "StereoDisplay.h"
+
+namespace
+{
+    /** Opacity of the black layer drawn over the scope each frame (persistence). */
+    constexpr float fadeAlpha = 0.12f;
+
+    /** Height of the correlation bar below the scope. */
+    constexpr int correlationHeight = 24;
+}
+
+//==============================================================================
+// Lifecycle
+
+StereoDisplay::StereoDisplay (StereoAnalyser& a)
+    : analyser (a)
+{
+    // Discard points that piled up while no display was open
+    while (analyser.popPoints (pointBuffer.data(), (int) pointBuffer.size()) > 0) {}
+
+    startTimerHz (60);
+}
+
+StereoDisplay::~StereoDisplay()
+{
+    stopTimer();
+}
+
+//==============================================================================
+// Layout
+
+juce::Rectangle<int> StereoDisplay::getScopeArea() const
+{
+    auto area = getLocalBounds().reduced (4);
+    area.removeFromBottom (correlationHeight + 4);
+
+    const auto side = juce::jmin (area.getWidth(), area.getHeight());
+    return area.withSizeKeepingCentre (side, side);
+}
+
+juce::Rectangle<int> StereoDisplay::getCorrelationArea() const
+{
+    return getLocalBounds().reduced (4).removeFromBottom (correlationHeight);
+}
+
+void StereoDisplay::resized()
+{
+    const auto area = getScopeArea();
+
+    scope = area.isEmpty() ? juce::Image()
+                           : juce::Image (juce::Image::ARGB, area.getWidth(), area.getHeight(), true,
+                                          juce::SoftwareImageType());
+
+    if (scope.isValid())
+        scope.clear (scope.getBounds(), juce::Colours::black);
+}
+
+//==============================================================================
+// Updating
+
+void StereoDisplay::timerCallback()
+{
+    displayedCorrelation += 0.3f * (analyser.getCorrelation() - displayedCorrelation);
+
+    if (! scope.isValid())
+    {
+        repaint();
+        return;
+    }
+
+    // Fade the previous frames instead of redrawing their points
+    {
+        juce::Graphics fade (scope);
+        fade.setColour (juce::Colours::black.withAlpha (fadeAlpha));
+        fade.fillAll();
+    }
+
+    const auto size = scope.getWidth();
+    const auto half = size * 0.5f;
+    const auto scale = half * 0.5f; // Full-scale mono (L + R = 2) reaches the edge
+    const auto pointColour = juce::Colours::lightgreen.getPixelARGB();
+
+    juce::Image::BitmapData pixels (scope, juce::Image::BitmapData::readWrite);
+
+    for (;;)
+    {
+        const auto numPoints = analyser.popPoints (pointBuffer.data(), (int) pointBuffer.size());
+        if (numPoints == 0)
+            break;
+
+        for (int i = 0; i < numPoints; ++i)
+        {
+            const auto& point = pointBuffer[(size_t) i];
+
+            // Rotate by 45 degrees: side horizontally, mid vertically
+            const auto side = point.left - point.right;
+            const auto mid  = point.left + point.right;
+
+            const auto x = juce::roundToInt (half + side * scale);
+            const auto y = juce::roundToInt (half - mid * scale);
+
+            if (juce::isPositiveAndBelow (x, size) && juce::isPositiveAndBelow (y, size))
+                *reinterpret_cast<juce::PixelARGB*> (pixels.getPixelPointer (x, y)) = pointColour;
+        }
+    }
+
+    repaint();
+}
+
+//==============================================================================
+// Rendering
+
+void StereoDisplay::paint (juce::Graphics& g)
+{
+    g.fillAll (juce::Colours::black);
+    g.setColour (juce::Colours::darkgrey);
+    g.drawRect (getLocalBounds(), 2);
+
+    if (! analyser.isStereo())
+    {
+        g.setColour (juce::Colours::grey);
+        g.setFont (14.0f);
+        g.drawText ("Mono bus", getLocalBounds(), juce::Justification::centred, false);
+        return;
+    }
+
+    //==============================================================================
+    // Goniometer
+
+    const auto scopeArea = getScopeArea();
+    if (scope.isValid())
+        g.drawImageAt (scope, scopeArea.getX(), scopeArea.getY());
+
+    // L/R guide diagonals and M/S axes
+    const auto guides = scopeArea.toFloat();
+    g.setColour (juce::Colour (0xff303030));
+    g.drawLine (guides.getX(), guides.getY(), guides.getRight(), guides.getBottom());
+    g.drawLine (guides.getRight(), guides.getY(), guides.getX(), guides.getBottom());
+    g.drawVerticalLine (scopeArea.getCentreX(), guides.getY(), guides.getBottom());
+
+    //==============================================================================
+    // Correlation Bar
+
+    const auto barArea = getCorrelationArea().toFloat();
+    g.setColour (juce::Colour (0xff202020));
+    g.fillRect (barArea);
+
+    const auto centreX = barArea.getCentreX();
+    const auto valueX = juce::jmap (displayedCorrelation, -1.0f, 1.0f, barArea.getX(), barArea.getRight());
+
+    // Positive correlation is safe (green), negative means mono-compatibility trouble (red)
+    g.setColour (displayedCorrelation >= 0.0f ? juce::Colours::green : juce::Colours::red);
+    g.fillRect (juce::Rectangle<float>::leftTopRightBottom (juce::jmin (centreX, valueX), barArea.getY(),
+                                                            juce::jmax (centreX, valueX), barArea.getBottom()));
+
+    g.setColour (juce::Colours::white);
+    g.setFont (12.0f);
+    g.drawText (juce::String (displayedCorrelation, 2), barArea, juce::Justification::centred, false);
+    g.drawText ("-1", barArea.reduced (4, 0), juce::Justification::centredLeft, false);
+    g.drawText ("+1", barArea.reduced (4, 0), juce::Justification::centredRight, false);
+}
@@ -0,0 +1,54 @@
+/*
+    StereoDisplay.h
+
+    Goniometer and phase-correlation meter for stereo buses.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "StereoAnalyser.h"
+
+//==============================================================================
+/**
+ * Lissajous goniometer with a horizontal correlation bar underneath.
+ *
+ * Features:
+ * - Image-based persistence: the scope image is faded each frame and
+ *   only the newly decimated points are plotted
+ * - Mid on the vertical axis, side on the horizontal axis
+ * - Correlation bar from -1 (red) through 0 to +1 (green)
+ */
+class StereoDisplay : public juce::Component, private juce::Timer
+{
+public:
+    /** @param analyser Stereo analyser owned by the audio processor */
+    explicit StereoDisplay (StereoAnalyser& analyser);
+    ~StereoDisplay() override;
+
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    /** Fades the scope image, plots new points, repaints. */
+    void timerCallback() override;
+
+    /** Square area for the goniometer and strip for the correlation bar. */
+    juce::Rectangle<int> getScopeArea() const;
+    juce::Rectangle<int> getCorrelationArea() const;
+
+    StereoAnalyser& analyser;
+
+    /** Persistent scope image (software, so pixels can be written directly). */
+    juce::Image scope;
+
+    /** Scratch buffer for points popped each frame. */
+    std::array<StereoAnalyser::Point, 1024> pointBuffer {};
+
+    /** Smoothed correlation for a steadier needle. */
+    float displayedCorrelation = 0.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StereoDisplay)
+};
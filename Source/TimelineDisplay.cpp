@@ -0,0 +1,252 @@
+/*
+    TimelineDisplay.cpp
+
+    Implementation of the timeline lane.
+
+    Author: Divij Singh
+*/
+
+#include "TimelineDisplay.h"
+#include "PluginProcessor.h"
+
+namespace
+{
+    /** Shortest view so a fresh session is not stretched across the screen. */
+    constexpr double minVisibleSeconds = 10.0;
+
+    /** Clicks snap to the loudest peak within this many pixels. */
+    constexpr int snapPixels = 6;
+
+    constexpr float minDisplayDb = -60.0f;
+    constexpr float maxDisplayDb = 6.0f;
+}
+
+//==============================================================================
+// Lifecycle
+
+TimelineDisplay::TimelineDisplay (GainMeterAudioProcessor& p)
+    : processor (p), history (p.getTimelineHistory())
+{
+    saveWithSessionButton.setToggleState (processor.getSaveHistoryInState(), juce::dontSendNotification);
+    saveWithSessionButton.onClick = [this] { processor.setSaveHistoryInState (saveWithSessionButton.getToggleState()); };
+    addAndMakeVisible (saveWithSessionButton);
+
+    startTimerHz (15);
+}
+
+TimelineDisplay::~TimelineDisplay()
+{
+    stopTimer();
+}
+
+void TimelineDisplay::resized()
+{
+    saveWithSessionButton.setBounds (getPlotArea().reduced (4, 2).removeFromBottom (20).removeFromLeft (140));
+}
+
+void TimelineDisplay::timerCallback()
+{
+    repaint();
+}
+
+//==============================================================================
+// View
+
+juce::Range<double> TimelineDisplay::getVisibleRange() const
+{
+    if (! zoomedRange.isEmpty())
+        return zoomedRange;
+
+    return { 0.0, juce::jmax (minVisibleSeconds, history.getEndSeconds()) };
+}
+
+juce::String TimelineDisplay::formatTime (double seconds)
+{
+    const auto totalTenths = juce::roundToInt (juce::jmax (0.0, seconds) * 10.0);
+    const auto minutes = totalTenths / 600;
+    const auto secondsInMinute = (totalTenths % 600) / 10.0;
+
+    if (minutes >= 60)
+        return juce::String (minutes / 60) + ":" + juce::String (minutes % 60).paddedLeft ('0', 2)
+             + ":" + juce::String ((int) secondsInMinute).paddedLeft ('0', 2);
+
+    return juce::String (minutes) + ":" + juce::String (secondsInMinute, 1).paddedLeft ('0', 4);
+}
+
+//==============================================================================
+// Interaction
+
+void TimelineDisplay::mouseWheelMove (const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel)
+{
+    const auto area = getPlotArea();
+    const auto range = getVisibleRange();
+    if (area.getWidth() <= 0)
+        return;
+
+    // Zoom around the time under the pointer
+    const auto anchor = range.getStart() + (event.x - area.getX()) * range.getLength() / area.getWidth();
+    const auto factor = std::pow (2.0, -wheel.deltaY * 2.0);
+    const auto length = juce::jmax (1.0, range.getLength() * factor);
+
+    auto start = anchor - (anchor - range.getStart()) * factor;
+    start = juce::jmax (0.0, start);
+
+    zoomedRange = { start, start + length };
+    repaint();
+}
+
+void TimelineDisplay::mouseDoubleClick (const juce::MouseEvent&)
+{
+    zoomedRange = {};
+    repaint();
+}
+
+void TimelineDisplay::mouseDown (const juce::MouseEvent& event)
+{
+    const auto area = getPlotArea();
+    const auto range = getVisibleRange();
+    if (area.getWidth() <= 0)
+        return;
+
+    const auto secondsPerPixel = range.getLength() / area.getWidth();
+    const auto pointerSeconds = range.getStart() + (event.x - area.getX()) * secondsPerPixel;
+
+    // Read the surrounding slots at full resolution and take the loudest
+    const auto searchStart = juce::jmax (0.0, pointerSeconds - snapPixels * secondsPerPixel);
+    const auto searchEnd = pointerSeconds + snapPixels * secondsPerPixel;
+    const auto numSlots = juce::jlimit (1, 100000, (int) std::ceil ((searchEnd - searchStart) / TimelineHistory::secondsPerSlot));
+
+    std::vector<TimelineHistory::Slot> slots ((size_t) numSlots);
+    history.read (searchStart, TimelineHistory::secondsPerSlot, slots.data(), numSlots);
+
+    auto best = std::max_element (slots.begin(), slots.end(),
+                                  [] (const auto& a, const auto& b) { return a.peak < b.peak; });
+
+    if (best == slots.end() || best->peak == 0)
+    {
+        selectedSeconds.reset();
+        selectionText = {};
+        repaint();
+        return;
+    }
+
+    const auto slotStart = std::floor (searchStart / TimelineHistory::secondsPerSlot) * TimelineHistory::secondsPerSlot;
+    const auto seconds = slotStart + (double) std::distance (slots.begin(), best) * TimelineHistory::secondsPerSlot;
+
+    selectedSeconds = seconds;
+    selectionText = formatTime (seconds) + "  " + juce::String (TimelineHistory::peakFromSlot (best->peak), 1) + " dBFS";
+
+    if (auto musical = history.getMusicalPosition (seconds))
+        selectionText = "Bar " + juce::String (musical->bar) + " Beat " + juce::String (musical->beat, 2)
+                      + "  (" + juce::String (musical->numerator) + "/" + juce::String (musical->denominator)
+                      + ", " + juce::String (musical->bpm, 1) + " BPM)  " + selectionText;
+
+    repaint();
+}
+
+//==============================================================================
+// Rendering
+
+void TimelineDisplay::paint (juce::Graphics& g)
+{
+    g.fillAll (juce::Colours::black);
+    g.setColour (juce::Colours::darkgrey);
+    g.drawRect (getLocalBounds(), 2);
+
+    const auto area = getPlotArea();
+    const auto width = area.getWidth();
+    if (width <= 0)
+        return;
+
+    const auto range = getVisibleRange();
+    const auto secondsPerPixel = range.getLength() / width;
+
+    pixelSlots.resize ((size_t) width);
+    history.read (range.getStart(), secondsPerPixel, pixelSlots.data(), width);
+
+    auto dbToY = [area] (float db)
+    {
+        return juce::jmap (juce::jlimit (minDisplayDb, maxDisplayDb, db), minDisplayDb, maxDisplayDb,
+                           (float) area.getBottom(), (float) area.getY());
+    };
+
+    // 0 dBFS reference
+    g.setColour (juce::Colour (0xff303030));
+    g.drawHorizontalLine (juce::roundToInt (dbToY (0.0f)), (float) area.getX(), (float) area.getRight());
+
+    juce::Path loudnessPath;
+    bool pathStarted = false;
+
+    for (int pixel = 0; pixel < width; ++pixel)
+    {
+        const auto& slot = pixelSlots[(size_t) pixel];
+        const auto x = area.getX() + pixel;
+
+        if (slot.peak == 0)
+        {
+            pathStarted = false;
+            continue;
+        }
+
+        // Peak bars, red where they reach full scale
+        const auto peakDb = TimelineHistory::peakFromSlot (slot.peak);
+        g.setColour (peakDb >= 0.0f ? juce::Colours::red : juce::Colours::green.withAlpha (0.7f));
+        g.drawVerticalLine (x, dbToY (peakDb), (float) area.getBottom());
+
+        // Loudness line (LUFS shares the dB axis)
+        const auto y = dbToY (TimelineHistory::loudnessFromSlot (slot.loudness));
+        if (pathStarted)
+            loudnessPath.lineTo ((float) x, y);
+        else
+            loudnessPath.startNewSubPath ((float) x, y);
+
+        pathStarted = true;
+    }
+
+    g.setColour (juce::Colours::yellow);
+    g.strokePath (loudnessPath, juce::PathStrokeType (1.5f));
+
+    auto secondsToX = [area, range, secondsPerPixel] (double seconds)
+    {
+        return (float) (area.getX() + (seconds - range.getStart()) / secondsPerPixel);
+    };
+
+    // Playhead cursor
+    const auto playheadX = secondsToX (history.getLastPositionSeconds());
+    if (playheadX >= area.getX() && playheadX <= area.getRight())
+    {
+        g.setColour (juce::Colours::white.withAlpha (0.6f));
+        g.drawVerticalLine (juce::roundToInt (playheadX), (float) area.getY(), (float) area.getBottom());
+    }
+
+    // Selected spike
+    if (selectedSeconds.has_value())
+    {
+        g.setColour (juce::Colours::orange);
+        g.drawVerticalLine (juce::roundToInt (secondsToX (*selectedSeconds)), (float) area.getY(), (float) area.getBottom());
+    }
+
+    // Labels
+    auto labels = area.reduced (4, 2);
+    g.setFont (12.0f);
+    g.setColour (juce::Colours::white);
+    g.drawText (formatTime (range.getStart()) + " - " + formatTime (range.getEnd()),
+                labels.removeFromTop (16), juce::Justification::centredRight, false);
+
+    if (history.isRestoring())
+    {
+        g.setColour (juce::Colours::grey);
+        g.setFont (14.0f);
+        g.drawText ("Restoring saved history...", area, juce::Justification::centred, false);
+    }
+    else if (history.getEndSeconds() <= 0.0)
+    {
+        g.setColour (juce::Colours::grey);
+        g.setFont (14.0f);
+        g.drawText ("Start host playback to record the timeline", area, juce::Justification::centred, false);
+    }
+    else if (selectionText.isNotEmpty())
+    {
+        g.drawText (selectionText, labels.removeFromTop (16), juce::Justification::centredLeft, false);
+    }
+}
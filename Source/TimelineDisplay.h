@@ -0,0 +1,70 @@
+/*
+    TimelineDisplay.h
+
+    Peak and loudness graph over the host arrangement.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "TimelineHistory.h"
+
+class GainMeterAudioProcessor;
+
+//==============================================================================
+/**
+ * Timeline lane: peak bars and a loudness line against song position.
+ *
+ * Features:
+ * - Shows the whole played range by default; the mouse wheel zooms around
+ *   the pointer and double-click returns to the full view
+ * - Clicking snaps to the loudest peak near the pointer and reports its
+ *   bar/beat position, time and level
+ * - Playhead cursor at the most recent stamped position
+ * - Option to save the history with the host session
+ */
+class TimelineDisplay : public juce::Component, private juce::Timer
+{
+public:
+    /** @param processor Owning processor (history and persistence option) */
+    explicit TimelineDisplay (GainMeterAudioProcessor& processor);
+    ~TimelineDisplay() override;
+
+    void paint (juce::Graphics& g) override;
+    void resized() override;
+
+    void mouseDown (const juce::MouseEvent& event) override;
+    void mouseDoubleClick (const juce::MouseEvent& event) override;
+    void mouseWheelMove (const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel) override;
+
+private:
+    void timerCallback() override;
+
+    /** Drawing area inside the border. */
+    juce::Rectangle<int> getPlotArea() const { return getLocalBounds().reduced (4); }
+
+    /** Visible range; follows the played range unless zoomed. */
+    juce::Range<double> getVisibleRange() const;
+
+    /** Formats seconds as m:ss.s or h:mm:ss. */
+    static juce::String formatTime (double seconds);
+
+    GainMeterAudioProcessor& processor;
+    TimelineHistory& history;
+
+    juce::ToggleButton saveWithSessionButton { "Save with session" };
+
+    /** One merged slot per pixel, reused between paints. */
+    std::vector<TimelineHistory::Slot> pixelSlots;
+
+    /** Zoomed view, or empty to fit the whole history. */
+    juce::Range<double> zoomedRange;
+
+    /** Selected spike (timeline seconds) and its description. */
+    std::optional<double> selectedSeconds;
+    juce::String selectionText;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TimelineDisplay)
+};
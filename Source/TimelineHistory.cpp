@@ -0,0 +1,508 @@
+/*
+    TimelineHistory.cpp
+
+    Implementation of the timeline-aligned meter history.
+
+    Author: Divij Singh
+*/
+
+#include "TimelineHistory.h"
+
+namespace
+{
+    constexpr float peakFloorDb = -96.0f;
+    constexpr float loudnessFloorLufs = -70.0f;
+    constexpr float stepDb = 0.5f;
+
+    /** Maps a level to 1...255 (0 is reserved for empty slots). */
+    juce::uint8 quantise (float value, float floor) noexcept
+    {
+        return (juce::uint8) juce::jlimit (1, 255, 1 + juce::roundToInt ((value - floor) / stepDb));
+    }
+
+    /** Beats drifting further than this from the tempo map's prediction start a new entry. */
+    constexpr double ppqTolerance = 0.05;
+
+    /** Identifies and versions the serialised history. */
+    constexpr int stateMagic = 0x474d544c; // "GMTL"
+    constexpr int stateVersion = 1;
+}
+
+//==============================================================================
+/** One-shot background decoder for restored history. */
+class TimelineHistory::RestoreThread : public juce::Thread
+{
+public:
+    RestoreThread (TimelineHistory& h, const juce::String& data)
+        : juce::Thread ("GainMeter History Restore"), owner (h), base64Data (data)
+    {
+    }
+
+    void run() override
+    {
+        auto result = TimelineHistory::decode (base64Data);
+        base64Data = {};
+
+        const juce::SpinLock::ScopedLockType lock (owner.restoredLock);
+        owner.restored = std::move (result);
+    }
+
+private:
+    TimelineHistory& owner;
+    juce::String base64Data;
+};
+
+//==============================================================================
+// Quantisation
+
+juce::uint8 TimelineHistory::quantisePeak (float db) noexcept          { return quantise (db, peakFloorDb); }
+float TimelineHistory::peakFromSlot (juce::uint8 value) noexcept        { return peakFloorDb + (value - 1) * stepDb; }
+juce::uint8 TimelineHistory::quantiseLoudness (float lufs) noexcept    { return quantise (lufs, loudnessFloorLufs); }
+float TimelineHistory::loudnessFromSlot (juce::uint8 value) noexcept    { return loudnessFloorLufs + (value - 1) * stepDb; }
+
+//==============================================================================
+// Lifecycle
+
+TimelineHistory::TimelineHistory()
+{
+    clear();
+}
+
+TimelineHistory::~TimelineHistory()
+{
+    if (restoreThread != nullptr)
+        restoreThread->stopThread (-1);
+}
+
+void TimelineHistory::prepare (double newSampleRate)
+{
+    sampleRate.store (newSampleRate);
+}
+
+void TimelineHistory::clear()
+{
+    const juce::ScopedLock lock (historyLock);
+
+    chunks.clear();
+    chunks.shrink_to_fit();
+    tempoMap.clear();
+    lastUsedSlot = -1;
+    lastWrittenSlot = -1;
+    lastPositionSeconds = 0.0;
+}
+
+size_t TimelineHistory::getMemoryUsage() const noexcept
+{
+    const juce::ScopedLock lock (historyLock);
+    size_t bytes = chunks.capacity() * sizeof (std::unique_ptr<Chunk>);
+
+    for (const auto& chunk : chunks)
+        if (chunk != nullptr)
+            bytes += sizeof (Chunk);
+
+    // Rough per-node cost of std::map (three pointers and a colour)
+    bytes += tempoMap.size() * (sizeof (std::pair<const int, TempoPoint>) + 4 * sizeof (void*));
+    return bytes;
+}
+
+//==============================================================================
+// Audio Thread
+
+void TimelineHistory::pushBlock (const juce::AudioPlayHead::PositionInfo& position,
+                                 float peakLinear, float loudnessLufs) noexcept
+{
+    // While stopped the playhead does not move, so there is nothing to place
+    if (! position.getIsPlaying())
+        return;
+
+    Stamp stamp;
+
+    if (auto timeInSamples = position.getTimeInSamples())
+        stamp.seconds = (double) *timeInSamples / sampleRate.load();
+    else if (auto timeInSeconds = position.getTimeInSeconds())
+        stamp.seconds = *timeInSeconds;
+    else
+        return;
+
+    stamp.peakLinear = peakLinear;
+    stamp.loudnessLufs = loudnessLufs;
+
+    auto ppq = position.getPpqPosition();
+    auto bpm = position.getBpm();
+
+    if (ppq.hasValue() && bpm.hasValue() && *bpm > 0.0)
+    {
+        stamp.hasMusicalTime = true;
+        stamp.ppq = *ppq;
+        stamp.bpm = *bpm;
+
+        if (auto signature = position.getTimeSignature())
+        {
+            stamp.numerator = juce::jmax (1, signature->numerator);
+            stamp.denominator = juce::jmax (1, signature->denominator);
+        }
+
+        const auto quartersPerBar = stamp.numerator * 4.0 / stamp.denominator;
+
+        if (auto barStart = position.getPpqPositionOfLastBarStart())
+            stamp.barStartPpq = *barStart;
+        else
+            stamp.barStartPpq = std::floor (stamp.ppq / quartersPerBar) * quartersPerBar;
+
+        if (auto barCount = position.getBarCount())
+            stamp.barCount = *barCount;
+        else
+            stamp.barCount = (juce::int64) std::round (stamp.barStartPpq / quartersPerBar);
+    }
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+    if (size1 + size2 == 0)
+        return;
+
+    stamps[(size_t) (size1 > 0 ? start1 : start2)] = stamp;
+    fifo.finishedWrite (1);
+}
+
+//==============================================================================
+// Message Thread
+
+void TimelineHistory::processPending()
+{
+    mergeFinishedRestore();
+
+    const juce::ScopedLock lock (historyLock);
+
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (fifo.getNumReady(), start1, size1, start2, size2);
+
+    for (int i = 0; i < size1; ++i)
+        addStamp (stamps[(size_t) (start1 + i)]);
+
+    for (int i = 0; i < size2; ++i)
+        addStamp (stamps[(size_t) (start2 + i)]);
+
+    fifo.finishedRead (size1 + size2);
+}
+
+void TimelineHistory::addStamp (const Stamp& stamp)
+{
+    lastPositionSeconds = stamp.seconds;
+
+    const auto index = (int) std::floor (stamp.seconds / secondsPerSlot);
+    if (! juce::isPositiveAndBelow (index, maxSlots))
+        return;
+
+    const auto chunkIndex = (size_t) (index / slotsPerChunk);
+
+    if (chunkIndex >= chunks.size())
+        chunks.resize (chunkIndex + 1);
+
+    if (chunks[chunkIndex] == nullptr)
+        chunks[chunkIndex] = std::make_unique<Chunk>();
+
+    auto* slot = &(*chunks[chunkIndex])[(size_t) (index % slotsPerChunk)];
+    const auto peak = quantisePeak (juce::Decibels::gainToDecibels (stamp.peakLinear, -200.0f));
+    const auto loudness = quantiseLoudness (stamp.loudnessLufs);
+
+    // Entering a slot replaces what an earlier pass left there; staying in it merges
+    if (index != lastWrittenSlot)
+    {
+        slot->peak = peak;
+        slot->loudness = loudness;
+    }
+    else
+    {
+        slot->peak = juce::jmax (slot->peak, peak);
+        slot->loudness = juce::jmax (slot->loudness, loudness);
+    }
+
+    lastWrittenSlot = index;
+    lastUsedSlot.store (juce::jmax (lastUsedSlot.load(), index));
+
+    updateTempoMap (stamp);
+}
+
+void TimelineHistory::updateTempoMap (const Stamp& stamp)
+{
+    if (! stamp.hasMusicalTime)
+        return;
+
+    const auto index = (int) std::floor (stamp.seconds / secondsPerSlot);
+
+    // Only record where the existing map would mispredict the host's position
+    auto next = tempoMap.upper_bound (index);
+    if (next != tempoMap.begin())
+    {
+        const auto& current = std::prev (next)->second;
+        const auto predictedPpq = current.ppq + (stamp.seconds - current.seconds) * current.bpm / 60.0;
+
+        if (current.bpm == stamp.bpm
+            && current.numerator == stamp.numerator
+            && current.denominator == stamp.denominator
+            && std::abs (predictedPpq - stamp.ppq) < ppqTolerance)
+            return;
+    }
+
+    tempoMap[index] = { stamp.seconds, stamp.ppq, stamp.bpm, stamp.barStartPpq,
+                        stamp.barCount, stamp.numerator, stamp.denominator };
+}
+
+void TimelineHistory::read (double startSeconds, double secondsPerPixel, Slot* destination, int numPixels) const
+{
+    const juce::ScopedLock lock (historyLock);
+    const auto endSlot = lastUsedSlot.load() + 1;
+
+    for (int pixel = 0; pixel < numPixels; ++pixel)
+    {
+        const auto first = (int) std::floor ((startSeconds + pixel * secondsPerPixel) / secondsPerSlot);
+        const auto last  = juce::jmax (first + 1,
+                                       (int) std::floor ((startSeconds + (pixel + 1) * secondsPerPixel) / secondsPerSlot));
+
+        Slot merged;
+
+        for (auto index = juce::jmax (0, first); index < juce::jmin (last, endSlot); ++index)
+        {
+            const auto chunkIndex = (size_t) (index / slotsPerChunk);
+            if (chunkIndex >= chunks.size() || chunks[chunkIndex] == nullptr)
+            {
+                // Skip the rest of an unallocated chunk in one step
+                index = ((int) chunkIndex + 1) * slotsPerChunk - 1;
+                continue;
+            }
+
+            const auto& slot = (*chunks[chunkIndex])[(size_t) (index % slotsPerChunk)];
+            merged.peak = juce::jmax (merged.peak, slot.peak);
+            merged.loudness = juce::jmax (merged.loudness, slot.loudness);
+        }
+
+        destination[pixel] = merged;
+    }
+}
+
+std::optional<TimelineHistory::MusicalPosition> TimelineHistory::getMusicalPosition (double seconds) const
+{
+    const juce::ScopedLock lock (historyLock);
+
+    if (tempoMap.empty())
+        return {};
+
+    // Governing entry; positions before the first one extrapolate from it
+    const auto index = (int) std::floor (seconds / secondsPerSlot);
+    auto next = tempoMap.upper_bound (index);
+    const auto& point = (next == tempoMap.begin() ? next : std::prev (next))->second;
+
+    const auto ppq = point.ppq + (seconds - point.seconds) * point.bpm / 60.0;
+    const auto quartersPerBar = point.numerator * 4.0 / point.denominator;
+    const auto quartersPerBeat = 4.0 / point.denominator;
+
+    const auto barsFromStart = std::floor ((ppq - point.barStartPpq) / quartersPerBar);
+    const auto ppqInBar = ppq - point.barStartPpq - barsFromStart * quartersPerBar;
+
+    MusicalPosition result;
+    result.bar = point.barCount + (juce::int64) barsFromStart + 1;
+    result.beat = ppqInBar / quartersPerBeat + 1.0;
+    result.numerator = point.numerator;
+    result.denominator = point.denominator;
+    result.bpm = point.bpm;
+    return result;
+}
+
+//==============================================================================
+// Persistence
+
+juce::MemoryBlock TimelineHistory::saveCompressed()
+{
+    // A restore still in flight must land before saving, or it would be lost
+    if (restoreThread != nullptr)
+        restoreThread->waitForThreadToExit (-1);
+
+    mergeFinishedRestore();
+
+    juce::MemoryOutputStream compressed;
+
+    {
+        juce::GZIPCompressorOutputStream zip (compressed, 9);
+        const juce::ScopedLock lock (historyLock);
+
+        zip.writeInt (stateMagic);
+        zip.writeInt (stateVersion);
+
+        zip.writeInt ((int) tempoMap.size());
+        for (const auto& [index, point] : tempoMap)
+        {
+            zip.writeInt (index);
+            zip.writeDouble (point.seconds);
+            zip.writeDouble (point.ppq);
+            zip.writeDouble (point.bpm);
+            zip.writeDouble (point.barStartPpq);
+            zip.writeInt64 (point.barCount);
+            zip.writeInt (point.numerator);
+            zip.writeInt (point.denominator);
+        }
+
+        // Only allocated chunks; slots are two raw bytes each
+        int numChunks = 0;
+        for (const auto& chunk : chunks)
+            numChunks += chunk != nullptr ? 1 : 0;
+
+        zip.writeInt (numChunks);
+        for (size_t chunkIndex = 0; chunkIndex < chunks.size(); ++chunkIndex)
+        {
+            if (chunks[chunkIndex] == nullptr)
+                continue;
+
+            zip.writeInt ((int) chunkIndex);
+            for (const auto& slot : *chunks[chunkIndex])
+            {
+                zip.writeByte ((char) slot.peak);
+                zip.writeByte ((char) slot.loudness);
+            }
+        }
+
+        zip.flush();
+    }
+
+    return compressed.getMemoryBlock();
+}
+
+void TimelineHistory::restoreCompressedAsync (const juce::String& base64Data)
+{
+    if (restoreThread != nullptr)
+        restoreThread->stopThread (-1);
+
+    {
+        const juce::SpinLock::ScopedLockType lock (restoredLock);
+        restored.reset();
+    }
+
+    restoreThread = std::make_unique<RestoreThread> (*this, base64Data);
+    restoreThread->startThread();
+}
+
+bool TimelineHistory::isRestoring() const
+{
+    if (restoreThread != nullptr && restoreThread->isThreadRunning())
+        return true;
+
+    const juce::SpinLock::ScopedLockType lock (restoredLock);
+    return restored != nullptr;
+}
+
+std::unique_ptr<TimelineHistory::Restored> TimelineHistory::decode (const juce::String& base64Data)
+{
+    juce::MemoryBlock compressed;
+    if (! compressed.fromBase64Encoding (base64Data))
+        return nullptr;
+
+    juce::MemoryInputStream source (compressed, false);
+    juce::GZIPDecompressorInputStream zip (source);
+
+    if (zip.readInt() != stateMagic || zip.readInt() != stateVersion)
+        return nullptr;
+
+    auto result = std::make_unique<Restored>();
+
+    const auto numTempoPoints = zip.readInt();
+    if (! juce::isPositiveAndNotGreaterThan (numTempoPoints, maxSlots))
+        return nullptr;
+
+    for (int i = 0; i < numTempoPoints; ++i)
+    {
+        const auto index = zip.readInt();
+
+        TempoPoint point;
+        point.seconds = zip.readDouble();
+        point.ppq = zip.readDouble();
+        point.bpm = zip.readDouble();
+        point.barStartPpq = zip.readDouble();
+        point.barCount = zip.readInt64();
+        point.numerator = zip.readInt();
+        point.denominator = zip.readInt();
+
+        if (! juce::isPositiveAndBelow (index, maxSlots) || point.bpm <= 0.0
+             || point.numerator <= 0 || point.denominator <= 0)
+            return nullptr;
+
+        result->tempoMap[index] = point;
+    }
+
+    const auto numChunks = zip.readInt();
+    constexpr auto maxChunks = (maxSlots + slotsPerChunk - 1) / slotsPerChunk;
+
+    if (! juce::isPositiveAndNotGreaterThan (numChunks, maxChunks))
+        return nullptr;
+
+    for (int i = 0; i < numChunks; ++i)
+    {
+        const auto chunkIndex = zip.readInt();
+        if (! juce::isPositiveAndBelow (chunkIndex, maxChunks))
+            return nullptr;
+
+        auto chunk = std::make_unique<Chunk>();
+        if (zip.read (chunk->data(), (int) sizeof (Chunk)) != (int) sizeof (Chunk))
+            return nullptr;
+
+        result->chunks.emplace_back (chunkIndex, std::move (chunk));
+    }
+
+    return result;
+}
+
+void TimelineHistory::mergeFinishedRestore()
+{
+    std::unique_ptr<Restored> finished;
+
+    {
+        const juce::SpinLock::ScopedTryLockType lock (restoredLock);
+        if (! lock.isLocked())
+            return;
+
+        finished = std::move (restored);
+    }
+
+    if (finished != nullptr)
+    {
+        const juce::ScopedLock lock (historyLock);
+        mergeRestored (*finished);
+    }
+}
+
+void TimelineHistory::mergeRestored (Restored& restoredHistory)
+{
+    for (auto& [chunkIndex, chunk] : restoredHistory.chunks)
+    {
+        const auto index = (size_t) chunkIndex;
+
+        if (index >= chunks.size())
+            chunks.resize (index + 1);
+
+        // Highest used slot in this chunk extends the visible range
+        for (int slot = slotsPerChunk - 1; slot >= 0; --slot)
+        {
+            if ((*chunk)[(size_t) slot].peak != 0)
+            {
+                lastUsedSlot.store (juce::jmax (lastUsedSlot.load(), chunkIndex * slotsPerChunk + slot));
+                break;
+            }
+        }
+
+        if (chunks[index] == nullptr)
+        {
+            chunks[index] = std::move (chunk);
+            continue;
+        }
+
+        // Playback started before the restore finished: live recording wins
+        // slot by slot, and the saved copy fills every slot not played yet
+        auto& live = *chunks[index];
+
+        for (size_t slot = 0; slot < live.size(); ++slot)
+            if (live[slot].peak == 0)
+                live[slot] = (*chunk)[slot];
+    }
+
+    for (const auto& entry : restoredHistory.tempoMap)
+        tempoMap.insert (entry);
+}
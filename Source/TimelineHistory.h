@@ -0,0 +1,197 @@
+/*
+    TimelineHistory.h
+
+    Peak and loudness history indexed by the host's timeline position.
+
+    The audio thread stamps every block with the playhead position and
+    queues it. The message thread quantises the stamps into 100 ms slots
+    of two bytes each, stored in chunks that are only allocated where the
+    transport has actually played, plus a sparse tempo map so any slot can
+    be converted back to bars and beats. Three hours of history take about
+    200 kB, and much less once GZIP-compressed into the plugin state.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+//==============================================================================
+/**
+ * Timeline-aligned meter history for the editor's timeline lane.
+ *
+ * Thread roles:
+ * - Audio thread: pushBlock()
+ * - Any thread: saveCompressed(), restoreCompressedAsync() (state callbacks)
+ * - Message thread: everything else
+ */
+class TimelineHistory
+{
+public:
+    static constexpr double secondsPerSlot = 0.1;
+    static constexpr int slotsPerChunk = 1024;                      // ~100 s per allocation
+    static constexpr int maxSlots = 24 * 60 * 60 * 10;              // 24 h of timeline
+
+    /** Quantised slot contents; 0 means "never played". */
+    struct Slot
+    {
+        juce::uint8 peak = 0;       // 0.5 dB steps from -96 dBFS
+        juce::uint8 loudness = 0;   // 0.5 LU steps from -70 LUFS
+    };
+
+    /** Bar and beat of a timeline position (both 1-based). */
+    struct MusicalPosition
+    {
+        juce::int64 bar = 1;
+        double beat = 1.0;
+        int numerator = 4;
+        int denominator = 4;
+        double bpm = 120.0;
+    };
+
+    TimelineHistory();
+    ~TimelineHistory();
+
+    /** Stores the sample rate used to convert sample positions to time. */
+    void prepare (double sampleRate);
+
+    /**
+     * Queues one block's meter values with its timeline position (audio thread).
+     * Stamps are dropped while the transport is stopped or if the FIFO is full.
+     */
+    void pushBlock (const juce::AudioPlayHead::PositionInfo& position, float peakLinear, float loudnessLufs) noexcept;
+
+    /** Quantises queued stamps into slots and updates the tempo map (message thread). */
+    void processPending();
+
+    /**
+     * Fills one slot per pixel for a span of the timeline, keeping the
+     * loudest values where several slots share a pixel.
+     * @param startSeconds     Timeline position of the first pixel
+     * @param secondsPerPixel  Zoom level
+     */
+    void read (double startSeconds, double secondsPerPixel, Slot* destination, int numPixels) const;
+
+    /** End of the latest slot that holds data, in timeline seconds. */
+    double getEndSeconds() const noexcept { return (lastUsedSlot + 1) * secondsPerSlot; }
+
+    /** Timeline position of the most recent stamp (for the playhead cursor). */
+    double getLastPositionSeconds() const noexcept { return lastPositionSeconds; }
+
+    /** Bars and beats at a timeline position, if the host supplied musical time. */
+    std::optional<MusicalPosition> getMusicalPosition (double seconds) const;
+
+    /** Heap memory currently used by slots and tempo map, in bytes. */
+    size_t getMemoryUsage() const noexcept;
+
+    /** Drops all history (message thread). */
+    void clear();
+
+    //==============================================================================
+    // Persistence
+
+    /**
+     * Serialises slots and tempo map and GZIP-compresses them.
+     * Waits for an unfinished restore so saving never loses restored history.
+     */
+    juce::MemoryBlock saveCompressed();
+
+    /**
+     * Decodes base64 history written by saveCompressed() on a background
+     * thread and returns immediately. The result is merged on the next
+     * processPending(); slots recorded since then take precedence.
+     */
+    void restoreCompressedAsync (const juce::String& base64Data);
+
+    /** True while restored history is still being decoded or awaits merging. */
+    bool isRestoring() const;
+
+    //==============================================================================
+    /** Slot quantisation helpers. */
+    static juce::uint8 quantisePeak (float db) noexcept;
+    static float peakFromSlot (juce::uint8 value) noexcept;
+    static juce::uint8 quantiseLoudness (float lufs) noexcept;
+    static float loudnessFromSlot (juce::uint8 value) noexcept;
+
+private:
+    //==============================================================================
+    /** What the audio thread records per block. */
+    struct Stamp
+    {
+        double seconds = 0.0;
+        float peakLinear = 0.0f;
+        float loudnessLufs = -70.0f;
+        bool hasMusicalTime = false;
+        double ppq = 0.0;
+        double bpm = 120.0;
+        double barStartPpq = 0.0;
+        juce::int64 barCount = 0;
+        int numerator = 4;
+        int denominator = 4;
+    };
+
+    /** Tempo and meter in force from a timeline position onwards. */
+    struct TempoPoint
+    {
+        double seconds = 0.0;
+        double ppq = 0.0;
+        double bpm = 120.0;
+        double barStartPpq = 0.0;
+        juce::int64 barCount = 0;       // Zero-based index of the bar starting at barStartPpq
+        int numerator = 4;
+        int denominator = 4;
+    };
+
+    void addStamp (const Stamp& stamp);
+    void updateTempoMap (const Stamp& stamp);
+
+    using Chunk = std::array<Slot, slotsPerChunk>;
+    std::vector<std::unique_ptr<Chunk>> chunks;
+
+    /** Keyed by slot index so repeated passes over a section replace, not grow. */
+    std::map<int, TempoPoint> tempoMap;
+
+    /** Decoded saved history waiting to be merged. */
+    struct Restored
+    {
+        std::vector<std::pair<int, std::unique_ptr<Chunk>>> chunks;
+        std::map<int, TempoPoint> tempoMap;
+    };
+
+    /** Parses compressed history; returns nullptr on malformed data (any thread). */
+    static std::unique_ptr<Restored> decode (const juce::String& base64Data);
+
+    /** Installs restored chunks and tempo points where no live data exists (historyLock held). */
+    void mergeRestored (Restored& restoredHistory);
+
+    /** Takes a finished restore, if any, and merges it. */
+    void mergeFinishedRestore();
+
+    class RestoreThread;
+    std::unique_ptr<RestoreThread> restoreThread;
+    std::unique_ptr<Restored> restored;
+    mutable juce::SpinLock restoredLock;            // Guards restored (restore thread hand-off)
+
+    /** Serialises slot writes against saving from a host thread. */
+    mutable juce::CriticalSection historyLock;
+
+    std::atomic<int> lastUsedSlot { -1 };
+    int lastWrittenSlot = -1;           // Slot of the previous stamp (merge vs overwrite)
+    double lastPositionSeconds = 0.0;
+
+    std::atomic<double> sampleRate { 44100.0 };
+
+    // Audio -> message thread stamps (a few seconds of small blocks)
+    static constexpr int fifoSize = 4096;
+    juce::AbstractFifo fifo { fifoSize };
+    std::array<Stamp, fifoSize> stamps {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TimelineHistory)
+};
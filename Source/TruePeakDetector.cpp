@@ -0,0 +1,83 @@
+/*
+    TruePeakDetector.cpp
+
+    Implementation of the 4x polyphase true-peak detector.
+
+    Author: Divij Singh
+*/
+
+#include "TruePeakDetector.h"
+#include <juce_dsp/juce_dsp.h>
+
+//==============================================================================
+// Filter Design
+
+TruePeakDetector::Coefficients::Coefficients()
+{
+    // Kaiser-windowed sinc low-pass at the original Nyquist frequency on the
+    // 4x grid. Same length and band edge as the BS.1770 Annex 2 example, but
+    // not its coefficients: being even-length, the phases sit 0.125, 0.375,
+    // 0.625 and 0.875 samples off the input grid and never on a sample, so
+    // processBlock() folds the sample peak in separately
+    std::array<float, numTaps> window;
+    juce::dsp::WindowingFunction<float>::fillWindowingTables (window.data(), (size_t) numTaps,
+                                                             juce::dsp::WindowingFunction<float>::kaiser,
+                                                             false, 6.0f);
+
+    const auto centre = (numTaps - 1) * 0.5;
+
+    for (int phase = 0; phase < oversampling; ++phase)
+    {
+        double phaseSum = 0.0;
+
+        for (int k = 0; k < tapsPerPhase; ++k)
+        {
+            const auto n = k * oversampling + phase;
+            const auto x = (n - centre) / oversampling;
+            const auto sinc = std::abs (x) < 1.0e-9 ? 1.0 : std::sin (juce::MathConstants<double>::pi * x)
+                                                            / (juce::MathConstants<double>::pi * x);
+
+            const auto tap = sinc * window[(size_t) n];
+            phases[(size_t) phase][(size_t) k] = (float) tap;
+            phaseSum += tap;
+        }
+
+        // Unity DC gain per phase so a constant signal reads its own level
+        float absoluteSum = 0.0f;
+        for (auto& tap : phases[(size_t) phase])
+        {
+            tap = (float) (tap / phaseSum);
+            absoluteSum += std::abs (tap);
+        }
+
+        maxGain = juce::jmax (maxGain, absoluteSum);
+    }
+}
+
+//==============================================================================
+// Processing
+
+void TruePeakDetector::reset() noexcept
+{
+    for (auto& history : histories)
+    {
+        history.samples.fill (0.0f);
+        history.position = 0;
+    }
+}
+
+float TruePeakDetector::processBlock (int channel, const float* samples, int numSamples) noexcept
+{
+    float peak = 0.0f;
+    float samplePeak = 0.0f;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        peak = juce::jmax (peak, processSample (channel, samples[i]));
+        samplePeak = juce::jmax (samplePeak, std::abs (samples[i]));
+    }
+
+    // No interpolated phase lands on a sample, so a lone impulse would
+    // otherwise read about 0.2 dB under its own sample peak
+    return juce::jmax (peak, samplePeak);
+}
@@ -0,0 +1,111 @@
+/*
+    TruePeakDetector.h
+
+    Inter-sample (true) peak estimation after ITU-R BS.1770 Annex 2.
+
+    Each channel is upsampled 4x with a 48-tap polyphase interpolation
+    filter and the larger of the interpolated and the sample peak is
+    reported. The filter table is shared by every instance.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+
+//==============================================================================
+/**
+ * 4x oversampling true-peak detector for up to two channels.
+ *
+ * All methods are real-time safe; state is fixed-size.
+ */
+class TruePeakDetector
+{
+public:
+    static constexpr int maxChannels = 2;
+    static constexpr int oversampling = 4;
+    static constexpr int tapsPerPhase = 12;
+    static constexpr int numTaps = oversampling * tapsPerPhase;
+
+    /** Polyphase filter coefficients, shared through SharedResourcePointer. */
+    struct Coefficients
+    {
+        Coefficients();
+
+        /** phases[p][k] multiplies the sample k steps in the past for output phase p. */
+        std::array<std::array<float, tapsPerPhase>, oversampling> phases;
+
+        /**
+         * Largest sum of absolute taps over the phases: no interpolated point
+         * can exceed this times the largest input sample in its window.
+         */
+        float maxGain = 1.0f;
+    };
+
+    /** Clears the filter histories. */
+    void reset() noexcept;
+
+    /**
+     * Upsamples one channel and returns its true peak: the largest
+     * interpolated magnitude, or the sample peak if that is higher.
+     * @param channel    Channel index (0 or 1)
+     * @param samples    Post-gain samples
+     * @param numSamples Number of samples
+     */
+    float processBlock (int channel, const float* samples, int numSamples) noexcept;
+
+    /**
+     * Upsamples a single sample and returns the largest magnitude among
+     * the interpolated points ending at it (for per-sample consumers).
+     * These lie between input samples and lag the input by the filter
+     * delay; callers combine them with the delayed sample peak themselves.
+     */
+    inline float processSample (int channel, float sample) noexcept
+    {
+        pushSample (channel, sample);
+
+        const auto& state = histories[(size_t) channel];
+        const auto* window = state.samples.data() + state.position;
+        float peak = 0.0f;
+
+        for (const auto& phase : coefficients->phases)
+        {
+            float value = 0.0f;
+            for (int k = 0; k < tapsPerPhase; ++k)
+                value += phase[(size_t) k] * window[k];
+
+            peak = juce::jmax (peak, std::abs (value));
+        }
+
+        return peak;
+    }
+
+    /**
+     * Adds a sample to the filter history without interpolating, for callers
+     * that can prove (via Coefficients::maxGain) the result is not needed.
+     */
+    inline void pushSample (int channel, float sample) noexcept
+    {
+        auto& state = histories[(size_t) channel];
+
+        // Doubled ring: the newest tapsPerPhase samples are always contiguous
+        state.position = (state.position == 0 ? tapsPerPhase : state.position) - 1;
+        state.samples[(size_t) state.position] = sample;
+        state.samples[(size_t) (state.position + tapsPerPhase)] = sample;
+    }
+
+    /** Bound on interpolated magnitude relative to the input peak (shared coefficients). */
+    float getMaxGain() const noexcept { return coefficients->maxGain; }
+
+private:
+    struct ChannelHistory
+    {
+        std::array<float, 2 * tapsPerPhase> samples {};
+        int position = 0;
+    };
+
+    std::array<ChannelHistory, maxChannels> histories;
+    juce::SharedResourcePointer<Coefficients> coefficients;
+};
@@ -0,0 +1,187 @@
+/*
+    TruePeakLimiter.cpp
+
+    Implementation of the lookahead true-peak limiter.
+
+    Author: Divij Singh
+*/
+
+#include "TruePeakLimiter.h"
+
+//==============================================================================
+// Configuration
+
+size_t TruePeakLimiter::getArenaBytes (int maxLookaheadSamples, int numChannels) noexcept
+{
+    const auto lookaheadLimit = (size_t) juce::jmax (0, maxLookaheadSamples);
+    const auto channels = (size_t) juce::jlimit (0, (int) maxChannels, numChannels);
+
+    return DspArena::getBytesFor<float> (channels * (lookaheadLimit + detectorDelay + 1))
+         + DspArena::getBytesFor<float> (lookaheadLimit + 2)
+         + DspArena::getBytesFor<juce::int64> (lookaheadLimit + 2)
+         + DspArena::getBytesFor<float> (lookaheadLimit + 1);
+}
+
+void TruePeakLimiter::prepare (double newSampleRate, int maxLookaheadSamples, int numChannels, DspArena& arena)
+{
+    sampleRate = newSampleRate;
+    maxLookahead = juce::jmax (0, maxLookaheadSamples);
+    numPreparedChannels = juce::jlimit (0, (int) maxChannels, numChannels);
+
+    delayLines = arena.allocate<float> ((size_t) (numPreparedChannels * (maxLookahead + detectorDelay + 1)));
+    dequeGains = arena.allocate<float> ((size_t) (maxLookahead + 2));
+    dequeIndices = arena.allocate<juce::int64> ((size_t) (maxLookahead + 2));
+    boxHistory = arena.allocate<float> ((size_t) (maxLookahead + 1));
+
+    if (delayLines == nullptr || dequeGains == nullptr || dequeIndices == nullptr || boxHistory == nullptr)
+        releaseStorage();
+
+    setLookahead (juce::jmin (lookahead, maxLookahead));
+}
+
+void TruePeakLimiter::releaseStorage() noexcept
+{
+    delayLines = dequeGains = boxHistory = nullptr;
+    dequeIndices = nullptr;
+    numPreparedChannels = 0;
+}
+
+void TruePeakLimiter::setLookahead (int lookaheadSamples) noexcept
+{
+    lookahead = juce::jlimit (0, maxLookahead, lookaheadSamples);
+    boxLength = lookahead + 1;
+    holdLength = lookahead + 2;
+    delaySize = getLatencySamples() + 1;
+    reset();
+}
+
+void TruePeakLimiter::setParameters (float ceilingDb, float releaseMs) noexcept
+{
+    ceiling = juce::Decibels::decibelsToGain (ceilingDb);
+
+    // One-pole rise towards the smoothed requirement
+    const auto releaseSamples = juce::jmax (1.0, (double) releaseMs * 0.001 * sampleRate);
+    releaseCoefficient = (float) (1.0 - std::exp (-1.0 / releaseSamples));
+}
+
+void TruePeakLimiter::reset() noexcept
+{
+    detector.reset();
+
+    if (delayLines != nullptr)
+        juce::FloatVectorOperations::clear (delayLines, numPreparedChannels * delaySize);
+
+    if (boxHistory != nullptr)
+        juce::FloatVectorOperations::fill (boxHistory, 1.0f, boxLength);
+
+    boxSum = (double) boxLength;
+    boxPosition = 0;
+    delayPosition = 0;
+    dequeFront = dequeSize = 0;
+    sampleIndex = 0;
+    samplesUntilQuiet = 0;
+    samplePeaks.fill (0.0f);
+    samplePeakPosition = 0;
+    gain = 1.0f;
+}
+
+//==============================================================================
+// Processing
+
+float TruePeakLimiter::process (juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept
+{
+    numChannels = juce::jmin (numChannels, numPreparedChannels);
+
+    if (numChannels == 0 || delayLines == nullptr)
+        return 1.0f;
+
+    float* channels[maxChannels] {};
+    for (int channel = 0; channel < numChannels; ++channel)
+        channels[channel] = buffer.getWritePointer (channel);
+
+    // A sample this loud could put an interpolated point over the ceiling
+    // (small margin for the filter's float rounding)
+    const auto loudThreshold = ceiling / (detector.getMaxGain() * 1.001f);
+    const auto inverseBoxLength = 1.0 / (double) boxLength;
+    float lowestGain = 1.0f;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        //==============================================================================
+        // Detect: required gain for the interpolated peak ending at this sample
+        float inputPeak = 0.0f;
+        for (int channel = 0; channel < numChannels; ++channel)
+            inputPeak = juce::jmax (inputPeak, std::abs (channels[channel][i]));
+
+        if (inputPeak >= loudThreshold)
+            samplesUntilQuiet = TruePeakDetector::tapsPerPhase;
+
+        // The sample itself counts too, once it lines up with the interpolated points
+        auto peak = samplePeaks[(size_t) samplePeakPosition];
+        samplePeaks[(size_t) samplePeakPosition] = inputPeak;
+        samplePeakPosition = samplePeakPosition + 1 == detectorDelay ? 0 : samplePeakPosition + 1;
+
+        if (samplesUntilQuiet > 0)
+        {
+            --samplesUntilQuiet;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                peak = juce::jmax (peak, detector.processSample (channel, channels[channel][i]));
+        }
+        else
+        {
+            for (int channel = 0; channel < numChannels; ++channel)
+                detector.pushSample (channel, channels[channel][i]);
+        }
+
+        const auto required = peak > ceiling ? ceiling / peak : 1.0f;
+
+        //==============================================================================
+        // Sliding minimum over the last holdLength requirements. The expired
+        // front goes first so the ring never holds more than holdLength entries.
+        if (dequeSize > 0 && dequeIndices[dequeFront] <= sampleIndex - holdLength)
+        {
+            dequeFront = (dequeFront + 1) % holdLength;
+            --dequeSize;
+        }
+
+        while (dequeSize > 0 && dequeGains[(dequeFront + dequeSize - 1) % holdLength] >= required)
+            --dequeSize;
+
+        const auto back = (dequeFront + dequeSize) % holdLength;
+        dequeGains[back] = required;
+        dequeIndices[back] = sampleIndex;
+        ++dequeSize;
+
+        const auto held = dequeGains[dequeFront];
+        ++sampleIndex;
+
+        //==============================================================================
+        // Box filter: the average of boxLength held values ramps down to each
+        // minimum exactly when its samples leave the delay line
+        boxSum += (double) held - (double) boxHistory[boxPosition];
+        boxHistory[boxPosition] = held;
+        boxPosition = boxPosition + 1 == boxLength ? 0 : boxPosition + 1;
+
+        const auto attackTarget = juce::jmin (1.0f, (float) (boxSum * inverseBoxLength));
+
+        // Follow the box-filtered attack down immediately, release with a one-pole
+        gain = attackTarget < gain ? attackTarget : gain + (attackTarget - gain) * releaseCoefficient;
+        lowestGain = juce::jmin (lowestGain, gain);
+
+        //==============================================================================
+        // Delay and apply
+        const auto readPosition = delayPosition + 1 == delaySize ? 0 : delayPosition + 1;
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            auto* line = delayLines + channel * delaySize;
+            line[delayPosition] = channels[channel][i];
+            channels[channel][i] = line[readPosition] * gain;
+        }
+
+        delayPosition = readPosition;
+    }
+
+    return lowestGain;
+}
@@ -0,0 +1,115 @@
+/*
+    TruePeakLimiter.h
+
+    Brickwall lookahead limiter on the 4x oversampled (true) peak.
+
+    The gain each sample needs to stay under the ceiling is pushed into a
+    sliding-window minimum (a monotonic deque, O(1) amortised per sample),
+    smoothed by a box filter as long as the lookahead and released with a
+    one-pole. The audio is delayed so the gain has fully come down by the
+    time the peak that required it is output.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "TruePeakDetector.h"
+#include "DspArena.h"
+
+//==============================================================================
+/**
+ * Lookahead true-peak limiter for up to two linked channels.
+ *
+ * Thread roles:
+ * - prepare(), releaseStorage(): not real-time safe (arena setup)
+ * - Everything else: audio thread
+ */
+class TruePeakLimiter
+{
+public:
+    static constexpr int maxChannels = TruePeakDetector::maxChannels;
+
+    /** Samples the interpolation filter lags its input by; added to the lookahead latency. */
+    static constexpr int detectorDelay = TruePeakDetector::tapsPerPhase / 2;
+
+    /** Arena bytes prepare() takes for a lookahead limit and channel count. */
+    static size_t getArenaBytes (int maxLookaheadSamples, int numChannels) noexcept;
+
+    /**
+     * Takes delay and window storage from the instance's arena.
+     * @param sampleRate           Sample rate for release timing
+     * @param maxLookaheadSamples  Longest lookahead setLookahead() will accept
+     * @param numChannels          Channels process() will be given (at most maxChannels)
+     * @param arena                Arena sized with getArenaBytes()
+     */
+    void prepare (double sampleRate, int maxLookaheadSamples, int numChannels, DspArena& arena);
+
+    /** Forgets the arena storage before the arena is released; process() then passes audio through. */
+    void releaseStorage() noexcept;
+
+    /** Changes the lookahead and clears all state (audio thread; a short gap follows). */
+    void setLookahead (int lookaheadSamples) noexcept;
+
+    /** Delay the limiter adds to the signal, for setLatencySamples(). */
+    int getLatencySamples() const noexcept { return lookahead + detectorDelay; }
+
+    /** Sets the ceiling (dBTP) and release time (ms); cheap enough to call every block. */
+    void setParameters (float ceilingDb, float releaseMs) noexcept;
+
+    /** Clears the delay line, detector and gain state. */
+    void reset() noexcept;
+
+    /**
+     * Limits a block in place.
+     * @param buffer      Audio to limit (channels are linked)
+     * @param numChannels Channels to process (at most maxChannels)
+     * @param numSamples  Number of samples
+     * @return The lowest gain applied in the block (1.0 when nothing was limited)
+     */
+    float process (juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept;
+
+private:
+    TruePeakDetector detector;
+
+    double sampleRate = 44100.0;
+    int maxLookahead = 0;
+    int numPreparedChannels = 0;
+    int lookahead = 0;
+
+    // The box filter spans lookahead + 1 samples; the minimum spans one more, so
+    // both samples either side of an interpolated peak get its full reduction
+    int boxLength = 1;
+    int holdLength = 2;
+
+    float ceiling = 1.0f;
+    float releaseCoefficient = 0.0f;
+    float gain = 1.0f;
+
+    // Skips interpolation while no sample in the detector window can reach the ceiling
+    int samplesUntilQuiet = 0;
+
+    // Input sample peaks delayed to line up with the interpolated points, which
+    // fall between (not on) the original samples
+    std::array<float, detectorDelay> samplePeaks {};
+    int samplePeakPosition = 0;
+
+    // Arena storage. Per-channel delay lines of getLatencySamples() + 1
+    float* delayLines = nullptr;
+    int delaySize = 1;
+    int delayPosition = 0;
+
+    // Monotonic deque of (sample index, required gain) over holdLength samples,
+    // increasing gain from front to back
+    float* dequeGains = nullptr;
+    juce::int64* dequeIndices = nullptr;
+    int dequeFront = 0, dequeSize = 0;
+    juce::int64 sampleIndex = 0;
+
+    // Box filter over the windowed minimum
+    float* boxHistory = nullptr;
+    int boxPosition = 0;
+    double boxSum = 0.0;
+};
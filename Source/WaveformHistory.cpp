@@ -0,0 +1,197 @@
+/*
+    WaveformHistory.cpp
+
+    Implementation of the min/max/RMS history pyramid.
+
+    Author: Divij Singh
+*/
+
+#include "WaveformHistory.h"
+
+namespace
+{
+    /** Widens a running min/max summary by another one. */
+    void includeRange (WaveformHistory::Entry& target, const WaveformHistory::Entry& other) noexcept
+    {
+        target.minimum = juce::jmin (target.minimum, other.minimum);
+        target.maximum = juce::jmax (target.maximum, other.maximum);
+    }
+}
+
+//==============================================================================
+// Lifecycle
+
+WaveformHistory::WaveformHistory()
+{
+    clear();
+}
+
+void WaveformHistory::prepare (double newSampleRate)
+{
+    sampleRate.store (newSampleRate);
+}
+
+void WaveformHistory::clear()
+{
+    for (auto& level : levels)
+    {
+        level.numWritten = 0;
+        level.numPending = 0;
+        level.pendingParent = {};
+    }
+}
+
+//==============================================================================
+// Audio Thread
+
+void WaveformHistory::pushBlock (const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept
+{
+    if (numChannels <= 0)
+        return;
+
+    int position = 0;
+
+    while (position < numSamples)
+    {
+        // Work in chunks that never cross a bucket boundary
+        const auto chunk = juce::jmin (numSamples - position, samplesPerBucket - samplesInBucket);
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto* data = buffer.getReadPointer (channel, position);
+            const auto range = juce::FloatVectorOperations::findMinAndMax (data, chunk);
+
+            float sumOfSquares = 0.0f;
+            for (int i = 0; i < chunk; ++i)
+                sumOfSquares += data[i] * data[i];
+
+            if (samplesInBucket == 0 && channel == 0)
+            {
+                currentBucket = { range.getStart(), range.getEnd(), sumOfSquares };
+            }
+            else
+            {
+                currentBucket.minimum = juce::jmin (currentBucket.minimum, range.getStart());
+                currentBucket.maximum = juce::jmax (currentBucket.maximum, range.getEnd());
+                currentBucket.meanSquare += sumOfSquares;
+            }
+        }
+
+        samplesInBucket += chunk;
+        position += chunk;
+
+        if (samplesInBucket == samplesPerBucket)
+        {
+            currentBucket.meanSquare /= (float) (samplesPerBucket * numChannels);
+
+            int start1, size1, start2, size2;
+            fifo.prepareToWrite (1, start1, size1, start2, size2);
+
+            if (size1 + size2 > 0)
+            {
+                fifoEntries[(size_t) (size1 > 0 ? start1 : start2)] = currentBucket;
+                fifo.finishedWrite (1);
+            }
+
+            samplesInBucket = 0;
+        }
+    }
+}
+
+//==============================================================================
+// Message Thread
+
+void WaveformHistory::processPending()
+{
+    int start1, size1, start2, size2;
+    fifo.prepareToRead (fifo.getNumReady(), start1, size1, start2, size2);
+
+    for (int i = 0; i < size1; ++i)
+        addEntry (0, fifoEntries[(size_t) (start1 + i)]);
+
+    for (int i = 0; i < size2; ++i)
+        addEntry (0, fifoEntries[(size_t) (start2 + i)]);
+
+    fifo.finishedRead (size1 + size2);
+}
+
+void WaveformHistory::addEntry (int levelIndex, const Entry& entry)
+{
+    auto& level = levels[(size_t) levelIndex];
+
+    level.ring[(size_t) (level.numWritten % entriesPerLevel)] = entry;
+    ++level.numWritten;
+
+    if (levelIndex + 1 >= numLevels)
+        return;
+
+    // Every levelFactor entries produce one entry on the next level
+    if (level.numPending == 0)
+    {
+        level.pendingParent = entry;
+    }
+    else
+    {
+        includeRange (level.pendingParent, entry);
+        level.pendingParent.meanSquare += entry.meanSquare;
+    }
+
+    if (++level.numPending == levelFactor)
+    {
+        auto parent = level.pendingParent;
+        parent.meanSquare /= (float) levelFactor;
+        level.numPending = 0;
+
+        addEntry (levelIndex + 1, parent);
+    }
+}
+
+int WaveformHistory::read (double samplesPerPixel, Entry* destination, int numPixels) const
+{
+    if (numPixels <= 0 || samplesPerPixel <= 0.0)
+        return 0;
+
+    // Coarsest level whose entries still fit inside one pixel
+    int levelIndex = 0;
+    double samplesPerEntry = samplesPerBucket;
+
+    while (levelIndex + 1 < numLevels && samplesPerEntry * levelFactor <= samplesPerPixel)
+    {
+        ++levelIndex;
+        samplesPerEntry *= levelFactor;
+    }
+
+    const auto& level = levels[(size_t) levelIndex];
+    const auto entriesPerPixel = samplesPerPixel / samplesPerEntry;
+    const auto newest = level.numWritten;                                     // One past the newest entry
+    const auto oldest = newest - juce::jmin (level.numWritten, (juce::int64) entriesPerLevel);
+
+    int numFilled = 0;
+
+    // Walk from the right edge ("now") back in time
+    for (int pixel = numPixels - 1; pixel >= 0; --pixel)
+    {
+        const auto distance = numPixels - 1 - pixel;
+        const auto last  = newest - (juce::int64) std::floor (distance * entriesPerPixel);
+        auto first       = newest - (juce::int64) std::ceil ((distance + 1) * entriesPerPixel);
+
+        first = juce::jmin (first, last - 1);
+
+        if (first < oldest)
+            break;
+
+        auto merged = level.ring[(size_t) (first % entriesPerLevel)];
+        for (auto index = first + 1; index < last; ++index)
+        {
+            const auto& entry = level.ring[(size_t) (index % entriesPerLevel)];
+            includeRange (merged, entry);
+            merged.meanSquare += entry.meanSquare;
+        }
+
+        merged.meanSquare /= (float) (last - first);
+        destination[pixel] = merged;
+        ++numFilled;
+    }
+
+    return numFilled;
+}
@@ -0,0 +1,104 @@
+/*
+    WaveformHistory.h
+
+    Multi-resolution min/max/RMS history of the post-gain signal.
+
+    The audio thread reduces each block to fixed-size buckets and pushes
+    them through a lock-free FIFO. On the message thread the buckets feed a
+    pyramid of fixed-size rings, each level four times coarser than the one
+    below, so any zoom level can be drawn by reading O(pixels) entries and
+    memory use is independent of session length.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+
+//==============================================================================
+/**
+ * Bounded waveform and level history for the editor's history lane.
+ *
+ * Thread roles:
+ * - Audio thread: pushBlock()
+ * - Message thread: processPending(), read()
+ */
+class WaveformHistory
+{
+public:
+    /** Summary of a span of samples across all channels. */
+    struct Entry
+    {
+        float minimum = 0.0f;
+        float maximum = 0.0f;
+        float meanSquare = 0.0f;
+    };
+
+    static constexpr int samplesPerBucket = 256;    // Level 0 resolution
+    static constexpr int levelFactor = 4;           // Each level is 4x coarser
+    static constexpr int numLevels = 8;             // 256 samples ... ~4.2M samples per entry
+    static constexpr int entriesPerLevel = 4096;    // Ring size of every level
+
+    WaveformHistory();
+
+    /** Stores the sample rate used to convert entries to time. */
+    void prepare (double sampleRate);
+
+    /**
+     * Reduces post-gain samples into buckets and queues completed ones (audio thread).
+     * Allocation-free; completed buckets are dropped if the FIFO is full.
+     */
+    void pushBlock (const juce::AudioBuffer<float>& buffer, int numChannels, int numSamples) noexcept;
+
+    /** Moves queued buckets into the pyramid (message thread). */
+    void processPending();
+
+    /**
+     * Fills one entry per pixel for the most recent span (message thread).
+     *
+     * Picks the coarsest level whose entries are no larger than a pixel,
+     * so each pixel merges at most a handful of entries.
+     *
+     * @param samplesPerPixel Zoom level
+     * @param destination     One entry per pixel, oldest first; the last pixel is "now"
+     * @param numPixels       Number of pixels to fill
+     * @return Number of pixels (counted from the right) that have history
+     */
+    int read (double samplesPerPixel, Entry* destination, int numPixels) const;
+
+    /** Sample rate of the recorded signal. */
+    double getSampleRate() const noexcept { return sampleRate.load(); }
+
+    /** Drops all recorded history (message thread). */
+    void clear();
+
+private:
+    /** Appends an entry to a level and cascades into coarser levels. */
+    void addEntry (int level, const Entry& entry);
+
+    /** One resolution of the pyramid. */
+    struct Level
+    {
+        std::array<Entry, entriesPerLevel> ring;
+        juce::int64 numWritten = 0;     // Total entries ever written (ring index = numWritten % size)
+        Entry pendingParent;            // Accumulates entries for the next level (meanSquare summed)
+        int numPending = 0;
+    };
+
+    std::array<Level, numLevels> levels;
+    std::atomic<double> sampleRate { 44100.0 };
+
+    // Audio-thread bucket accumulator (meanSquare holds the running sum of squares)
+    Entry currentBucket;
+    int samplesInBucket = 0;
+
+    // Audio -> message thread bucket FIFO (~5 s at 48 kHz)
+    static constexpr int fifoSize = 1024;
+    juce::AbstractFifo fifo { fifoSize };
+    std::array<Entry, fifoSize> fifoEntries {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WaveformHistory)
+};
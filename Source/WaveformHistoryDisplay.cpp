@@ -0,0 +1,104 @@
+/*
+    WaveformHistoryDisplay.cpp
+
+    Implementation of the waveform history lane.
+
+    Author: Divij Singh
+*/
+
+#include "WaveformHistoryDisplay.h"
+
+//==============================================================================
+// Lifecycle
+
+WaveformHistoryDisplay::WaveformHistoryDisplay (WaveformHistory& h)
+    : history (h)
+{
+    // 30 FPS matches the peak meter's refresh rate
+    startTimerHz (30);
+}
+
+WaveformHistoryDisplay::~WaveformHistoryDisplay()
+{
+    stopTimer();
+}
+
+void WaveformHistoryDisplay::timerCallback()
+{
+    repaint();
+}
+
+//==============================================================================
+// Interaction
+
+void WaveformHistoryDisplay::mouseWheelMove (const juce::MouseEvent&, const juce::MouseWheelDetails& wheel)
+{
+    // Scrolling up zooms in, proportionally to the wheel movement
+    const auto factor = std::pow (2.0, -wheel.deltaY * 2.0);
+    visibleSeconds = juce::jlimit (minVisibleSeconds, maxVisibleSeconds, visibleSeconds * factor);
+    repaint();
+}
+
+juce::String WaveformHistoryDisplay::formatSpan (double seconds)
+{
+    if (seconds < 60.0)
+        return juce::String (seconds, 1) + " s";
+
+    if (seconds < 3600.0)
+        return juce::String (seconds / 60.0, 1) + " min";
+
+    return juce::String (seconds / 3600.0, 1) + " h";
+}
+
+//==============================================================================
+// Rendering
+
+void WaveformHistoryDisplay::paint (juce::Graphics& g)
+{
+    g.fillAll (juce::Colours::black);
+    g.setColour (juce::Colours::darkgrey);
+    g.drawRect (getLocalBounds(), 2);
+
+    auto area = getLocalBounds().reduced (4);
+    const auto width = area.getWidth();
+    if (width <= 0)
+        return;
+
+    pixelEntries.resize ((size_t) width);
+
+    const auto samplesPerPixel = visibleSeconds * history.getSampleRate() / width;
+    const auto numFilled = history.read (samplesPerPixel, pixelEntries.data(), width);
+
+    const auto centreY = (float) area.getCentreY();
+    const auto halfHeight = area.getHeight() * 0.5f;
+
+    auto toY = [centreY, halfHeight] (float sample)
+    {
+        return centreY - juce::jlimit (-1.0f, 1.0f, sample) * halfHeight;
+    };
+
+    // Zero line
+    g.setColour (juce::Colour (0xff303030));
+    g.drawHorizontalLine (juce::roundToInt (centreY), (float) area.getX(), (float) area.getRight());
+
+    for (int pixel = width - numFilled; pixel < width; ++pixel)
+    {
+        const auto& entry = pixelEntries[(size_t) pixel];
+        const auto x = area.getX() + pixel;
+
+        // Min/max envelope
+        g.setColour (juce::Colours::green.withAlpha (0.7f));
+        g.drawVerticalLine (x, toY (entry.maximum), toY (entry.minimum) + 1.0f);
+
+        // RMS band, symmetric around zero
+        const auto rms = std::sqrt (entry.meanSquare);
+        g.setColour (juce::Colours::lightgreen);
+        g.drawVerticalLine (x, toY (rms), toY (-rms) + 1.0f);
+    }
+
+    // Visible span label
+    g.setColour (juce::Colours::white);
+    g.setFont (12.0f);
+    g.drawText (formatSpan (visibleSeconds), area.removeFromTop (16).removeFromRight (80),
+                juce::Justification::centredRight, false);
+}
@@ -0,0 +1,53 @@
+/*
+    WaveformHistoryDisplay.h
+
+    Zoomable scrolling waveform and level-history lane.
+
+    Author: Divij Singh
+*/
+
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "WaveformHistory.h"
+
+//==============================================================================
+/**
+ * Scrolling min/max waveform with an RMS level band, newest audio on the right.
+ *
+ * Features:
+ * - Mouse wheel zooms from one second to six hours per view
+ * - Reads one pyramid entry per pixel, whatever the zoom level
+ * - Time span label in the corner
+ */
+class WaveformHistoryDisplay : public juce::Component, private juce::Timer
+{
+public:
+    /** @param history History owned by the audio processor */
+    explicit WaveformHistoryDisplay (WaveformHistory& history);
+    ~WaveformHistoryDisplay() override;
+
+    void paint (juce::Graphics& g) override;
+
+    /** Zooms in or out around the current view span. */
+    void mouseWheelMove (const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel) override;
+
+private:
+    void timerCallback() override;
+
+    /** Formats the visible span for the corner label. */
+    static juce::String formatSpan (double seconds);
+
+    WaveformHistory& history;
+
+    /** One entry per pixel, reused between paints. */
+    std::vector<WaveformHistory::Entry> pixelEntries;
+
+    /** Visible time span in seconds. */
+    double visibleSeconds = 10.0;
+
+    static constexpr double minVisibleSeconds = 1.0;
+    static constexpr double maxVisibleSeconds = 6.0 * 60.0 * 60.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WaveformHistoryDisplay)
+};
@@ -0,0 +1,708 @@
+/*
+    MeterKernelsTest.cpp
+
+    Differential tests for the gain and meter kernels (run with ctest).
+
+    Kernel level: every variant built in and supported by the CPU is
+    compared against a plain scalar reference, the straightforward
+    per-sample form of the original processBlock gain pass and loudness
+    filter. Both get the same randomised material: odd block sizes,
+    unaligned channel pointers, extreme and ramped gains, denormals, NaNs
+    and infinities, and blocks split into sub-blocks the way the processor
+    chunks oversize blocks.
+
+    Processor level: a GainMeterAudioProcessor with the active variant is
+    compared against the baseline scalar gain/meter loop over varying and
+    oversize block sizes and gain changes: output samples, block peak,
+    clip count and the double-precision session statistics. A second
+    processor with a stereo sidechain key checks that processBlock leaves
+    the key channels untouched and meters and ducks from them.
+
+    Set GAINMETER_KERNELS to run the processor comparison with a forced
+    variant (see CMakeLists.txt).
+
+    Author: Divij Singh
+*/
+
+#include "MeterKernels.h"
+#include "PluginProcessor.h"
+#include <juce_events/juce_events.h>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+// Defined with the kernel variants (nullptr when not built)
+const MeterKernels::Table* getBaselineMeterKernels() noexcept;
+const MeterKernels::Table* getAvx2MeterKernels() noexcept;
+const MeterKernels::Table* getAvx512MeterKernels() noexcept;
+
+namespace
+{
+    //==============================================================================
+    // Reference kernels
+
+    LevelStatistics::BlockResult referenceGainAndMeasure (float* data, const float* gains, float constantGain,
+                                                          int numSamples, double& sum, double& sumSquares)
+    {
+        LevelStatistics::BlockResult result {};
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto sample = data[i] * (gains != nullptr ? gains[i] : constantGain);
+            const auto magnitude = std::abs (sample);
+
+            data[i] = sample;
+            result.peak = juce::jmax (result.peak, magnitude);
+            result.numClipped += magnitude >= 1.0f ? 1 : 0;
+            sum += sample;
+            sumSquares += (double) sample * sample;
+        }
+
+        return result;
+    }
+
+    void referenceHistogram (const float* data, int numSamples, juce::uint32* histogram)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto magnitude = std::abs (data[i]);
+            int bin = 0;
+
+            // Quarter-octave bins by definition: 2^(octave) * (1 + k/4)
+            if (std::isnan (magnitude) || magnitude >= std::ldexp (1.0f, LevelStatistics::lowestOctave + LevelStatistics::numOctaves))
+            {
+                bin = LevelStatistics::numBins - 1;
+            }
+            else if (magnitude >= std::numeric_limits<float>::min())
+            {
+                int exponent;
+                const auto mantissa = std::frexp (magnitude, &exponent) * 2.0f;  // [1, 2)
+                const auto octave = exponent - 1 - LevelStatistics::lowestOctave;
+                bin = octave * LevelStatistics::binsPerOctave
+                        + (int) ((mantissa - 1.0f) * (float) LevelStatistics::binsPerOctave);
+            }
+
+            ++histogram[juce::jlimit (0, LevelStatistics::numBins - 1, bin)];
+        }
+    }
+
+    MeterKernels::MidSideResult referenceMidSide (float* left, float* right, const float* midGains,
+                                                  const float* sideGains, float midGain, float sideGain, int numSamples)
+    {
+        MeterKernels::MidSideResult result {};
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto mid = (left[i] + right[i]) * (midGains != nullptr ? midGains[i] : midGain);
+            const auto side = (left[i] - right[i]) * (sideGains != nullptr ? sideGains[i] : sideGain);
+
+            left[i] = mid + side;
+            right[i] = mid - side;
+            result.midPeak = juce::jmax (result.midPeak, std::abs (mid));
+            result.sidePeak = juce::jmax (result.sidePeak, std::abs (side));
+        }
+
+        return result;
+    }
+
+    void referenceChannelMatrix (float* left, float* right, const MeterKernels::ChannelMatrix& start,
+                                 const MeterKernels::ChannelMatrix& end, int numSamples)
+    {
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto t = (float) (i + 1) / (float) numSamples;
+            const auto m00 = start.m00 + (end.m00 - start.m00) * t;
+            const auto m01 = start.m01 + (end.m01 - start.m01) * t;
+            const auto m10 = start.m10 + (end.m10 - start.m10) * t;
+            const auto m11 = start.m11 + (end.m11 - start.m11) * t;
+
+            const auto l = left[i];
+            const auto r = right[i];
+            left[i] = m00 * l + m01 * r;
+            right[i] = m10 * l + m11 * r;
+        }
+    }
+
+    double referenceFilter (const float* data, int numSamples, MeterKernels::Biquad* stages)
+    {
+        double sumSquares = 0.0;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            double x = data[i];
+
+            for (int stage = 0; stage < 2; ++stage)
+            {
+                auto& f = stages[stage];
+                const auto y = f.b0 * x + f.z1;
+                f.z1 = f.b1 * x - f.a1 * y + f.z2;
+                f.z2 = f.b2 * x - f.a2 * y;
+                x = y;
+            }
+
+            sumSquares += x * x;
+        }
+
+        return sumSquares;
+    }
+
+    //==============================================================================
+    // Comparisons
+
+    bool sameSample (float a, float b) noexcept
+    {
+        return (std::isnan (a) && std::isnan (b)) || a == b;
+    }
+
+    /** Sums accumulate in a different order per variant, so allow rounding relative to the magnitude. */
+    bool closeEnough (double actual, double expected, double scale, double relativeTolerance) noexcept
+    {
+        // Float lane sums may overflow where the double reference does not
+        if (! std::isfinite (expected) || ! std::isfinite (actual))
+            return (std::isnan (actual) && std::isnan (expected)) || actual == expected || ! (scale < 1.0e30);
+
+        return std::abs (actual - expected) <= relativeTolerance * scale + 1.0e-30;
+    }
+
+    /** BS.1770 Annex 1 K-weighting at 48 kHz. */
+    std::array<MeterKernels::Biquad, 2> makeKWeighting()
+    {
+        std::array<MeterKernels::Biquad, 2> stages {};
+        stages[0].b0 = 1.53512485958697;  stages[0].b1 = -2.69169618940638; stages[0].b2 = 1.19839281085285;
+        stages[0].a1 = -1.69065929318241; stages[0].a2 = 0.73248077421585;
+        stages[1].b0 = 1.0;               stages[1].b1 = -2.0;              stages[1].b2 = 1.0;
+        stages[1].a1 = -1.99004745483398; stages[1].a2 = 0.99007225036621;
+        return stages;
+    }
+
+    //==============================================================================
+    /** Randomised test material for one case. */
+    struct TestCase
+    {
+        int numSamples = 0;
+        int alignment = 0;          // Float offset into the buffer, makes pointers unaligned
+        int split = 0;              // Sub-block boundary for the kernel under test
+        bool useRamp = false;
+        float constantGain = 1.0f;
+        std::vector<float> input, gains;
+    };
+
+    TestCase makeTestCase (juce::Random& random)
+    {
+        static constexpr float extremeGains[] { 0.0f, 1.0e-6f, 0.001f, 0.5f, 1.0f, 3.981f, 1.0e6f };
+        static constexpr float specialValues[] {
+            0.0f, -0.0f, 1.0e-40f, -1.0e-40f, std::numeric_limits<float>::denorm_min(),
+            1.0f, -1.0f, 0.99999994f, 1.0e30f, std::numeric_limits<float>::infinity(),
+            -std::numeric_limits<float>::infinity(), std::numeric_limits<float>::quiet_NaN()
+        };
+
+        TestCase test;
+        test.numSamples = random.nextInt (random.nextBool() ? 40 : 2100);
+        test.alignment = random.nextInt (8);
+        test.split = test.numSamples > 0 ? random.nextInt (test.numSamples + 1) : 0;
+        test.useRamp = random.nextBool();
+        test.constantGain = extremeGains[random.nextInt ((int) std::size (extremeGains))];
+
+        const auto specialChance = random.nextInt (4) == 0 ? 0.05f : 0.0f;
+        const auto gainEnd = extremeGains[random.nextInt ((int) std::size (extremeGains))];
+
+        for (int i = 0; i < test.numSamples; ++i)
+        {
+            test.input.push_back (random.nextFloat() < specialChance
+                                    ? specialValues[random.nextInt ((int) std::size (specialValues))]
+                                    : random.nextFloat() * 2.2f - 1.1f);
+
+            const auto position = (float) i / (float) juce::jmax (1, test.numSamples);
+            test.gains.push_back (test.constantGain + (gainEnd - test.constantGain) * position);
+        }
+
+        return test;
+    }
+
+    juce::String checkCase (const MeterKernels::Table& kernels, const TestCase& test)
+    {
+        const auto n = test.numSamples;
+        const auto* gains = test.useRamp ? test.gains.data() : nullptr;
+
+        // Unaligned working copies
+        std::vector<float> expectedStorage (test.input.size() + 8), actualStorage (test.input.size() + 8);
+        auto* expected = expectedStorage.data() + test.alignment;
+        auto* actual = actualStorage.data() + test.alignment;
+
+        auto loadInput = [&]
+        {
+            std::copy (test.input.begin(), test.input.end(), expected);
+            std::copy (test.input.begin(), test.input.end(), actual);
+        };
+
+        //==============================================================================
+        // Fused gain, peak, sums, clip count and histogram, split into two calls
+        loadInput();
+
+        double expectedSum = 0.0, expectedSquares = 0.0, actualSum = 0.0, actualSquares = 0.0;
+        std::array<juce::uint32, LevelStatistics::numBins> expectedBins {}, actualBins {};
+        const auto reference = referenceGainAndMeasure (expected, gains, test.constantGain, n, expectedSum, expectedSquares);
+
+        auto first = kernels.applyGainAndMeasure (actual, gains, test.constantGain, test.split, actualSum, actualSquares,
+                                                  actualBins.data());
+        auto second = kernels.applyGainAndMeasure (actual + test.split, gains != nullptr ? gains + test.split : nullptr,
+                                                   test.constantGain, n - test.split, actualSum, actualSquares,
+                                                   actualBins.data());
+
+        double absoluteSum = 0.0;
+        for (int i = 0; i < n; ++i)
+        {
+            if (! sameSample (actual[i], expected[i]))
+                return "gain output differs at sample " + juce::String (i);
+
+            absoluteSum += std::abs (expected[i]);
+        }
+
+        if (juce::jmax (first.peak, second.peak) != reference.peak)
+            return "peak differs";
+
+        if (first.numClipped + second.numClipped != reference.numClipped)
+            return "clip count differs";
+
+        if (! closeEnough (actualSum, expectedSum, absoluteSum, 1.0e-4)
+            || ! closeEnough (actualSquares, expectedSquares, expectedSquares, 1.0e-4))
+            return "sum or sum of squares out of tolerance";
+
+        // Histogram of the post-gain signal
+        referenceHistogram (expected, n, expectedBins.data());
+
+        if (expectedBins != actualBins)
+            return "histogram differs";
+
+        //==============================================================================
+        // Gain and peak only
+        loadInput();
+
+        double ignoredSum = 0.0, ignoredSquares = 0.0;
+        const auto expectedPeak = referenceGainAndMeasure (expected, gains, test.constantGain, n,
+                                                           ignoredSum, ignoredSquares).peak;
+        const auto actualPeak = juce::jmax (kernels.applyGainAndFindPeak (actual, gains, test.constantGain, test.split),
+                                            kernels.applyGainAndFindPeak (actual + test.split,
+                                                                          gains != nullptr ? gains + test.split : nullptr,
+                                                                          test.constantGain, n - test.split));
+
+        if (actualPeak != expectedPeak)
+            return "gain-and-peak peak differs";
+
+        // Read-only peak of the post-gain signal
+        if (juce::jmax (kernels.findPeak (expected, test.split), kernels.findPeak (expected + test.split, n - test.split))
+              != expectedPeak)
+            return "read-only peak differs";
+
+        for (int i = 0; i < n; ++i)
+            if (! sameSample (actual[i], expected[i]))
+                return "gain-and-peak output differs at sample " + juce::String (i);
+
+        //==============================================================================
+        // Mid/side: the input and its reverse are the two channels, the
+        // gain ramp and its reverse the mid and side gains
+        std::vector<float> rightInput (test.input.rbegin(), test.input.rend());
+        std::vector<float> sideGains (test.gains.rbegin(), test.gains.rend());
+        std::vector<float> expectedRightStorage (rightInput.size() + 8), actualRightStorage (rightInput.size() + 8);
+        auto* expectedRight = expectedRightStorage.data() + (7 - test.alignment);
+        auto* actualRight = actualRightStorage.data() + (7 - test.alignment);
+
+        loadInput();
+        std::copy (rightInput.begin(), rightInput.end(), expectedRight);
+        std::copy (rightInput.begin(), rightInput.end(), actualRight);
+
+        const auto* midRamp = test.useRamp ? test.gains.data() : nullptr;
+        const auto* sideRamp = test.useRamp ? sideGains.data() : nullptr;
+        const auto sideGain = test.constantGain * 0.25f;
+
+        const auto expectedMidSide = referenceMidSide (expected, expectedRight, midRamp, sideRamp,
+                                                       test.constantGain, sideGain, n);
+        const auto firstMidSide = kernels.applyMidSideGain (actual, actualRight, midRamp, sideRamp,
+                                                            test.constantGain, sideGain, test.split);
+        const auto secondMidSide = kernels.applyMidSideGain (actual + test.split, actualRight + test.split,
+                                                             midRamp != nullptr ? midRamp + test.split : nullptr,
+                                                             sideRamp != nullptr ? sideRamp + test.split : nullptr,
+                                                             test.constantGain, sideGain, n - test.split);
+
+        if (juce::jmax (firstMidSide.midPeak, secondMidSide.midPeak) != expectedMidSide.midPeak
+            || juce::jmax (firstMidSide.sidePeak, secondMidSide.sidePeak) != expectedMidSide.sidePeak)
+            return "mid/side peak differs";
+
+        // The decode add may be fused with the side multiply, so allow rounding
+        // relative to the mid and side magnitudes
+        for (int i = 0; i < n; ++i)
+        {
+            const auto l = test.input[(size_t) i];
+            const auto r = rightInput[(size_t) i];
+            const auto scale = std::abs ((double) (l + r) * (midRamp != nullptr ? midRamp[i] : test.constantGain))
+                             + std::abs ((double) (l - r) * (sideRamp != nullptr ? sideRamp[i] : sideGain));
+
+            if (! closeEnough (actual[i], expected[i], scale, 1.0e-6)
+                || ! closeEnough (actualRight[i], expectedRight[i], scale, 1.0e-6))
+                return "mid/side output differs at sample " + juce::String (i);
+        }
+
+        //==============================================================================
+        // Channel matrix: a swap-with-polarity start moving to a balance end, or
+        // a constant matrix. The kernel under test sees the block in one call,
+        // since coefficients are interpolated across the whole block.
+        const auto matrixStart = test.useRamp ? MeterKernels::ChannelMatrix { 0.0f, -test.constantGain, 0.5f, 0.0f }
+                                              : MeterKernels::ChannelMatrix { 0.7f, 0.1f, -0.2f, test.constantGain };
+        const auto matrixEnd = test.useRamp ? MeterKernels::ChannelMatrix { 1.0f, 0.0f, 0.0f, 0.25f }
+                                            : matrixStart;
+
+        loadInput();
+        std::copy (rightInput.begin(), rightInput.end(), expectedRight);
+        std::copy (rightInput.begin(), rightInput.end(), actualRight);
+
+        referenceChannelMatrix (expected, expectedRight, matrixStart, matrixEnd, n);
+        kernels.applyChannelMatrix (actual, actualRight, matrixStart, matrixEnd, n);
+
+        // Coefficient interpolation and the multiply-add may be fused, so allow rounding
+        for (int i = 0; i < n; ++i)
+        {
+            const auto magnitude = std::abs ((double) test.input[(size_t) i]) + std::abs ((double) rightInput[(size_t) i]);
+            const auto scale = magnitude * juce::jmax (1.0, (double) std::abs (test.constantGain));
+
+            if (! closeEnough (actual[i], expected[i], scale, 1.0e-6)
+                || ! closeEnough (actualRight[i], expectedRight[i], scale, 1.0e-6))
+                return "channel matrix output differs at sample " + juce::String (i);
+        }
+
+        //==============================================================================
+        // K-weighting filter in double precision, carried across the split.
+        // FMA contraction changes rounding, so errors scale with the input level.
+        float inputPeak = 0.0f;
+        for (auto sample : test.input)
+            inputPeak = juce::jmax (inputPeak, std::abs (sample));
+
+        auto expectedStages = makeKWeighting();
+        auto actualStages = expectedStages;
+
+        const auto expectedEnergy = referenceFilter (test.input.data(), n, expectedStages.data());
+        const auto actualEnergy = kernels.filterAndSumSquares (test.input.data(), test.split, actualStages.data())
+                                + kernels.filterAndSumSquares (test.input.data() + test.split, n - test.split,
+                                                               actualStages.data());
+
+        const auto energyScale = expectedEnergy + 1.0e-3 * (double) inputPeak * inputPeak * n;
+
+        if (! closeEnough (actualEnergy, expectedEnergy, energyScale, 1.0e-7))
+            return "filter energy out of tolerance";
+
+        for (size_t stage = 0; stage < expectedStages.size(); ++stage)
+        {
+            const auto stateScale = std::abs (expectedStages[stage].z1) + std::abs (expectedStages[stage].z2)
+                                  + 8.0 * inputPeak + 1.0e-9;
+
+            if (! closeEnough (actualStages[stage].z1, expectedStages[stage].z1, stateScale, 1.0e-7)
+                || ! closeEnough (actualStages[stage].z2, expectedStages[stage].z2, stateScale, 1.0e-7))
+                return "filter state out of tolerance";
+        }
+
+        return {};
+    }
+
+    //==============================================================================
+    // Test runners
+
+    /** Runs numCases randomised cases; returns an empty string or the first mismatch. */
+    juce::String verify (const MeterKernels::Table& kernels, int numCases)
+    {
+        // Fixed seed: the same material for every variant and every run
+        juce::Random random (0x474d4b52);
+
+        for (int index = 0; index < numCases; ++index)
+        {
+            const auto test = makeTestCase (random);
+            const auto failure = checkCase (kernels, test);
+
+            if (failure.isNotEmpty())
+                return failure + " (case " + juce::String (index) + ", " + juce::String (test.numSamples) + " samples)";
+        }
+
+        return {};
+    }
+
+    /** Checks every variant in the build that this CPU can run. */
+    bool runKernelTests()
+    {
+        using Stats = juce::SystemStats;
+
+        struct Candidate
+        {
+            const MeterKernels::Table* table;
+            bool supported;
+        };
+
+        const Candidate candidates[] {
+            { getAvx512MeterKernels(), Stats::hasAVX512F() && Stats::hasAVX512BW() && Stats::hasAVX512DQ()
+                                       && Stats::hasAVX512VL() && Stats::hasFMA3() },
+            { getAvx2MeterKernels(),   Stats::hasAVX2() && Stats::hasFMA3() },
+            { getBaselineMeterKernels(), true }
+        };
+
+        auto passed = true;
+
+        for (const auto& candidate : candidates)
+        {
+            if (candidate.table == nullptr)
+                continue;
+
+            if (! candidate.supported)
+            {
+                std::cout << candidate.table->name << ": skipped (not supported by this CPU)" << std::endl;
+                continue;
+            }
+
+            const auto failure = verify (*candidate.table, 2000);
+            std::cout << candidate.table->name << ": " << (failure.isEmpty() ? juce::String ("PASS") : "FAIL " + failure) << std::endl;
+            passed = passed && failure.isEmpty();
+        }
+
+        return passed;
+    }
+
+    //==============================================================================
+    // Processor against the baseline scalar gain/meter loop
+
+    bool runProcessBlockTest()
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int announcedBlockSize = 512;
+        constexpr int numChannels = 2;
+        constexpr int totalSamples = 20 * 48000;
+
+        // Host block sizes cycle through odd, tiny and larger-than-prepared sizes
+        constexpr int blockSizes[] { 512, 1, 17, 480, 8192, 9000, 64, 1023, 20000 };
+
+        // Gain changes (dB) at these sample positions, including ones that clip
+        const std::pair<int, float> gainChanges[] { { 0, -6.0f }, { 3 * 48000, 3.0f }, { 7 * 48000, -60.0f },
+                                                     { 9 * 48000, 12.0f }, { 14 * 48000, 0.0f } };
+
+        GainMeterAudioProcessor processor;
+        *processor.gainParameter = gainChanges[0].second;
+        processor.prepareToPlay (sampleRate, announcedBlockSize);
+
+        // Baseline: one gain smoother stepped per sample frame, applied and
+        // metered per sample in float, sums accumulated in double
+        juce::LinearSmoothedValue<float> smoother;
+        smoother.reset (sampleRate, 0.05);
+        smoother.setTargetValue (juce::Decibels::decibelsToGain (gainChanges[0].second));
+
+        std::array<std::vector<float>, numChannels> expectedOutput;
+        juce::Random random (0x62617365);
+        juce::AudioBuffer<float> buffer (numChannels, 20000);
+        int expectedClips = 0;
+        int position = 0, blockIndex = 0, nextChange = 1, samplesSinceDrain = 0;
+
+        while (position < totalSamples)
+        {
+            const auto numSamples = juce::jmin (blockSizes[blockIndex++ % (int) std::size (blockSizes)], totalSamples - position);
+
+            if (nextChange < (int) std::size (gainChanges) && position >= gainChanges[nextChange].first)
+                *processor.gainParameter = gainChanges[nextChange++].second;
+
+            buffer.setSize (numChannels, numSamples, false, false, true);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                for (int sample = 0; sample < numSamples; ++sample)
+                    buffer.setSample (channel, sample, random.nextFloat() * 1.8f - 0.9f);
+
+            // Expected block, computed before the processor overwrites the input
+            smoother.setTargetValue (juce::Decibels::decibelsToGain (processor.gainParameter->get()));
+            float expectedPeak = 0.0f;
+
+            for (int sample = 0; sample < numSamples; ++sample)
+            {
+                const auto gain = smoother.getNextValue();
+
+                for (int channel = 0; channel < numChannels; ++channel)
+                {
+                    const auto output = buffer.getSample (channel, sample) * gain;
+                    expectedOutput[(size_t) channel].push_back (output);
+                    expectedPeak = juce::jmax (expectedPeak, std::abs (output));
+                    expectedClips += std::abs (output) >= 1.0f ? 1 : 0;
+                }
+            }
+
+            juce::MidiBuffer midi;
+            processor.processBlock (buffer, midi);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                for (int sample = 0; sample < numSamples; ++sample)
+                {
+                    if (buffer.getSample (channel, sample) != expectedOutput[(size_t) channel][(size_t) (position + sample)])
+                    {
+                        std::cout << "processBlock: FAIL output differs at sample " << position + sample
+                                  << ", channel " << channel << " (block of " << numSamples << ")" << std::endl;
+                        return false;
+                    }
+                }
+            }
+
+            const auto expectedPeakDb = expectedPeak > 0.0f ? juce::Decibels::gainToDecibels (expectedPeak) : -60.0f;
+
+            if (processor.getPeakLevel() != expectedPeakDb || processor.getClipCount() != expectedClips)
+            {
+                std::cout << "processBlock: FAIL peak or clip count differs after sample " << position << std::endl;
+                return false;
+            }
+
+            position += numSamples;
+            samplesSinceDrain += numSamples;
+
+            // Let the processor's message-thread timer merge published statistics
+            // before its FIFO (1.6 s) fills up
+            if (samplesSinceDrain >= 24000)
+            {
+                juce::MessageManager::getInstance()->runDispatchLoopUntil (100);
+                samplesSinceDrain = 0;
+            }
+        }
+
+        juce::MessageManager::getInstance()->runDispatchLoopUntil (100);
+        processor.releaseResources();
+
+        // Session statistics cover every published sample, in order, per channel
+        const auto& statistics = processor.getLevelStatistics();
+
+        for (int channel = 0; channel < numChannels; ++channel)
+        {
+            const auto& totals = statistics.getTotals (channel);
+            const auto& expected = expectedOutput[(size_t) channel];
+            const auto count = (int) totals.numSamples;
+
+            if (count <= 0 || count > (int) expected.size() || count < totalSamples - 48000)
+            {
+                std::cout << "processBlock: FAIL statistics cover " << count << " samples" << std::endl;
+                return false;
+            }
+
+            double sum = 0.0, sumSquares = 0.0;
+            float peak = 0.0f;
+            std::array<juce::uint32, LevelStatistics::numBins> histogram {};
+
+            for (int i = 0; i < count; ++i)
+            {
+                sum += expected[(size_t) i];
+                sumSquares += (double) expected[(size_t) i] * expected[(size_t) i];
+                peak = juce::jmax (peak, std::abs (expected[(size_t) i]));
+            }
+
+            referenceHistogram (expected.data(), count, histogram.data());
+
+            double absoluteSum = 0.0;
+            for (int i = 0; i < count; ++i)
+                absoluteSum += std::abs (expected[(size_t) i]);
+
+            if (totals.peak != peak || totals.histogram != histogram
+                || ! closeEnough (totals.sum, sum, absoluteSum, 1.0e-6)
+                || ! closeEnough (totals.sumSquares, sumSquares, sumSquares, 1.0e-6))
+            {
+                std::cout << "processBlock: FAIL session statistics differ on channel " << channel << std::endl;
+                return false;
+            }
+        }
+
+        std::cout << "processBlock (" << MeterKernels::getDescription() << "): PASS" << std::endl;
+        return true;
+    }
+
+    //==============================================================================
+    // Sidechain key channels
+
+    bool runSidechainTest()
+    {
+        constexpr double sampleRate = 48000.0;
+        constexpr int blockSize = 512;
+        constexpr int numBlocks = 200;
+        constexpr int numMainChannels = 2;
+        constexpr int numKeyChannels = 2;
+        constexpr float keyLevel = 0.5f;               // About -6 dBFS
+
+        GainMeterAudioProcessor processor;
+
+        auto layout = processor.getBusesLayout();
+        layout.inputBuses.getReference (0) = juce::AudioChannelSet::stereo();
+        layout.inputBuses.getReference (1) = juce::AudioChannelSet::stereo();
+        layout.outputBuses.getReference (0) = juce::AudioChannelSet::stereo();
+
+        if (! processor.setBusesLayout (layout))
+        {
+            std::cout << "sidechain: FAIL stereo key layout refused" << std::endl;
+            return false;
+        }
+
+        // Ducking on with a low threshold so the key clearly engages it
+        *processor.duckingParameter = true;
+        *processor.duckThresholdParameter = -40.0f;
+        processor.prepareToPlay (sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer (numMainChannels + numKeyChannels, blockSize);
+        juce::AudioBuffer<float> key (numKeyChannels, blockSize);
+        juce::Random random (0x6b6579);
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            for (int channel = 0; channel < numMainChannels; ++channel)
+                for (int sample = 0; sample < blockSize; ++sample)
+                    buffer.setSample (channel, sample, random.nextFloat() * 0.5f - 0.25f);
+
+            for (int channel = 0; channel < numKeyChannels; ++channel)
+            {
+                for (int sample = 0; sample < blockSize; ++sample)
+                    key.setSample (channel, sample, (sample & 1) == 0 ? keyLevel : -keyLevel);
+
+                buffer.copyFrom (numMainChannels + channel, 0, key, channel, 0, blockSize);
+            }
+
+            juce::MidiBuffer midi;
+            processor.processBlock (buffer, midi);
+
+            for (int channel = 0; channel < numKeyChannels; ++channel)
+            {
+                for (int sample = 0; sample < blockSize; ++sample)
+                {
+                    if (buffer.getSample (numMainChannels + channel, sample) != key.getSample (channel, sample))
+                    {
+                        std::cout << "sidechain: FAIL key channel " << channel << " modified in block " << block << std::endl;
+                        return false;
+                    }
+                }
+            }
+        }
+
+        processor.releaseResources();
+
+        const auto expectedKeyDb = juce::Decibels::gainToDecibels (keyLevel);
+
+        if (std::abs (processor.getKeyPeakLevel() - expectedKeyDb) > 0.01f)
+        {
+            std::cout << "sidechain: FAIL key meter reads " << processor.getKeyPeakLevel() << " dB" << std::endl;
+            return false;
+        }
+
+        if (processor.getDuckingReduction() <= 0.0f)
+        {
+            std::cout << "sidechain: FAIL ducking did not engage" << std::endl;
+            return false;
+        }
+
+        std::cout << "sidechain: PASS" << std::endl;
+        return true;
+    }
+}
+
+//==============================================================================
+int main()
+{
+    // The processor's statistics timer needs a message loop
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    const auto kernelsPassed = runKernelTests();
+    const auto processBlockPassed = runProcessBlockTest();
+    const auto sidechainPassed = runSidechainTest();
+
+    return kernelsPassed && processBlockPassed && sidechainPassed ? 0 : 1;
+}
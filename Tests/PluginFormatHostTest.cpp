@@ -0,0 +1,225 @@
+/*
+    PluginFormatHostTest.cpp
+
+    Headless host check that the VST3 and LV2 builds behave the same.
+
+    Loads both builds in a minimal in-process host, runs the same
+    deterministic stereo signal through each at the same gain and fails
+    unless the outputs match sample for sample. The time each build spent
+    in processBlock is reported but not gated: a 40 ms measurement is too
+    noisy on shared CI and render machines. Used by ctest so Linux render
+    hosts can load LV2 natively instead of bridging the VST3.
+
+    Usage: GainMeterHostTest <GainMeter.vst3> <GainMeter.lv2>
+
+    Author: Divij Singh
+*/
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_events/juce_events.h>
+#include <iostream>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr int numBlocks = 4000;             // About 43 s of audio
+    constexpr int numChannels = 2;
+
+    /**
+     * Blocks not compared while the initial gain change settles (past the 50 ms
+     * smoothing). Each wrapper delivers a parameter set before the first block
+     * its own way; the processing after that must match exactly.
+     */
+    constexpr int settleBlocks = 10;
+
+    /** Normalised gain both instances are set to: -6 dB on the linear -60..+12 dB range. */
+    constexpr float gainValue = 0.75f;
+
+    /** Largest sample difference tolerated (both builds wrap the same processor). */
+    constexpr float maxSampleDifference = 1.0e-6f;
+
+    //==============================================================================
+    /** One hosted build and the time it has spent processing. */
+    struct HostedPlugin
+    {
+        juce::String formatName;
+        std::unique_ptr<juce::AudioPluginInstance> instance;
+        juce::AudioBuffer<float> buffer;
+        juce::int64 processTicks = 0;
+    };
+
+    bool load (juce::AudioPluginFormat& format, const juce::String& path, HostedPlugin& plugin)
+    {
+        plugin.formatName = format.getName();
+
+        juce::OwnedArray<juce::PluginDescription> types;
+        format.findAllTypesForFile (types, path);
+
+        if (types.isEmpty())
+        {
+            std::cerr << plugin.formatName << ": no plugin found in " << path << std::endl;
+            return false;
+        }
+
+        juce::String error;
+        plugin.instance = format.createInstanceFromDescription (*types[0], sampleRate, blockSize, error);
+
+        if (plugin.instance == nullptr)
+        {
+            std::cerr << plugin.formatName << ": " << error << std::endl;
+            return false;
+        }
+
+        auto& processor = *plugin.instance;
+
+        // Stereo in and out; the sidechain key stays disconnected
+        auto layout = processor.getBusesLayout();
+        layout.inputBuses.getReference (0) = juce::AudioChannelSet::stereo();
+        layout.outputBuses.getReference (0) = juce::AudioChannelSet::stereo();
+
+        for (int bus = 1; bus < layout.inputBuses.size(); ++bus)
+            layout.inputBuses.getReference (bus) = juce::AudioChannelSet::disabled();
+
+        if (! processor.setBusesLayout (layout))
+        {
+            std::cerr << plugin.formatName << ": stereo layout refused" << std::endl;
+            return false;
+        }
+
+        auto* gain = [&processor]() -> juce::AudioProcessorParameter*
+        {
+            for (auto* parameter : processor.getParameters())
+                if (parameter->getName (64) == "Gain")
+                    return parameter;
+
+            return nullptr;
+        }();
+
+        if (gain == nullptr)
+        {
+            std::cerr << plugin.formatName << ": no Gain parameter" << std::endl;
+            return false;
+        }
+
+        gain->setValue (gainValue);
+
+        processor.setNonRealtime (true);
+        processor.prepareToPlay (sampleRate, blockSize);
+
+        plugin.buffer.setSize (juce::jmax (processor.getTotalNumInputChannels(), processor.getTotalNumOutputChannels()),
+                               blockSize);
+        return true;
+    }
+
+    /** Deterministic test signal: a swept sine with noise, peaking near full scale. */
+    void fillInput (juce::AudioBuffer<float>& input, int blockIndex, juce::Random& random)
+    {
+        for (int sample = 0; sample < blockSize; ++sample)
+        {
+            const auto time = (double) (blockIndex * blockSize + sample) / sampleRate;
+            const auto sweep = std::sin (juce::MathConstants<double>::twoPi * (100.0 + 200.0 * time) * time);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                input.setSample (channel, sample, (float) (0.8 * sweep) + 0.2f * (random.nextFloat() * 2.0f - 1.0f));
+        }
+    }
+
+    void process (HostedPlugin& plugin, const juce::AudioBuffer<float>& input)
+    {
+        plugin.buffer.clear();
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            plugin.buffer.copyFrom (channel, 0, input, channel, 0, blockSize);
+
+        juce::MidiBuffer midi;
+        const auto start = juce::Time::getHighResolutionTicks();
+        plugin.instance->processBlock (plugin.buffer, midi);
+        plugin.processTicks += juce::Time::getHighResolutionTicks() - start;
+    }
+
+    //==============================================================================
+    int runTest (const juce::String& vst3Path, const juce::String& lv2Path)
+    {
+        juce::VST3PluginFormat vst3Format;
+        juce::LV2PluginFormat lv2Format;
+        HostedPlugin vst3, lv2;
+
+        if (! load (vst3Format, vst3Path, vst3) || ! load (lv2Format, lv2Path, lv2))
+            return 1;
+
+        if (vst3.instance->getLatencySamples() != lv2.instance->getLatencySamples())
+        {
+            std::cerr << "Latency differs: VST3 " << vst3.instance->getLatencySamples()
+                      << ", LV2 " << lv2.instance->getLatencySamples() << std::endl;
+            return 1;
+        }
+
+        juce::AudioBuffer<float> input (numChannels, blockSize);
+        juce::Random random (1);
+        float maxDifference = 0.0f;
+
+        for (int block = 0; block < numBlocks; ++block)
+        {
+            fillInput (input, block, random);
+
+            // Alternate which build goes first so neither gets the warmer cache
+            if ((block & 1) == 0)
+            {
+                process (vst3, input);
+                process (lv2, input);
+            }
+            else
+            {
+                process (lv2, input);
+                process (vst3, input);
+            }
+
+            if (block < settleBlocks)
+                continue;
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                for (int sample = 0; sample < blockSize; ++sample)
+                    maxDifference = juce::jmax (maxDifference, std::abs (vst3.buffer.getSample (channel, sample)
+                                                                         - lv2.buffer.getSample (channel, sample)));
+        }
+
+        vst3.instance->releaseResources();
+        lv2.instance->releaseResources();
+
+        const auto audioSeconds = numBlocks * blockSize / sampleRate;
+        const auto vst3Seconds = juce::Time::highResolutionTicksToSeconds (vst3.processTicks);
+        const auto lv2Seconds = juce::Time::highResolutionTicksToSeconds (lv2.processTicks);
+        const auto ratio = juce::jmax (vst3Seconds, lv2Seconds) / juce::jmax (1.0e-9, juce::jmin (vst3Seconds, lv2Seconds));
+
+        // Throughput is informational only; the parity check gates the test
+        std::cout << "Max sample difference: " << maxDifference << "\n"
+                  << "VST3: " << vst3Seconds * 1000.0 << " ms (" << audioSeconds / vst3Seconds << "x real time)\n"
+                  << "LV2:  " << lv2Seconds * 1000.0 << " ms (" << audioSeconds / lv2Seconds << "x real time)\n"
+                  << "Time ratio: " << ratio << "x" << std::endl;
+
+        if (maxDifference > maxSampleDifference)
+        {
+            std::cerr << "FAIL: outputs differ" << std::endl;
+            return 1;
+        }
+
+        std::cout << "PASS" << std::endl;
+        return 0;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        std::cerr << "Usage: GainMeterHostTest <GainMeter.vst3> <GainMeter.lv2>" << std::endl;
+        return 2;
+    }
+
+    // Plugin wrappers expect a message manager on the calling thread
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    return runTest (juce::File::getCurrentWorkingDirectory().getChildFile (argv[1]).getFullPathName(),
+                    juce::File::getCurrentWorkingDirectory().getChildFile (argv[2]).getFullPathName());
+}